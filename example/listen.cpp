@@ -11,75 +11,30 @@
 #include <boost/corosio/io_context.hpp>
 #include <boost/describe/class.hpp>
 
-#include <algorithm>
 #include <iostream>
-#include <span>
-#include <vector>
 
 #include "nativepg/co_multiplexed_connection.hpp"
+#include "nativepg/co_subscriber.hpp"
 #include "nativepg/notification_event.hpp"
-#include "nativepg/request.hpp"
-#include "nativepg/response.hpp"
 
 using namespace nativepg;
 namespace capy = boost::capy;
 namespace corosio = boost::corosio;
 
-// Should we attempt to issue another LISTEN?
-// Every time we connect we should renew our listens.
-// Issuing the same listen several times is OK, so finding connect events is enough
-// TODO: we should have an automatic re-subscription feature
-static bool should_issue_listen(std::span<const notification_event> events)
-{
-    return std::ranges::find_if(events, [](const notification_event& evt) {
-               return evt.type == notification_event_type::connect;
-           }) != events.end();
-}
-
-static void print_event(const notification_event& event)
-{
-    switch (event.type)
-    {
-        case nativepg::notification_event_type::connect: std::cout << "Connection established\n"; break;
-        case nativepg::notification_event_type::disconnect: std::cout << "Connection disconnected\n"; break;
-        case nativepg::notification_event_type::notify:
-            std::cout << "Received notification from process " << event.backend_pid << ", channel '"
-                      << event.channel << "', payload '" << event.payload << "'\n";
-            break;
-    }
-}
-
 static capy::io_task<> listener(co_multiplexed_connection& conn)
 {
-    std::vector<notification_event> events;
-
-    request req;
-    req.add_simple_query("LISTEN mychannel");
-
-    while (true)
-    {
-        // Wait for new events
-        if (auto [ec] = co_await conn.read_notifications(events); ec)
-        {
-            std::cerr << "Error reading events: " << ec << ": " << ec.message() << std::endl;
-            co_return {};
-        }
-
-        // Print notifications
-        for (const auto& event : events)
-            print_event(event);
-
-        // If there was a reconnection, listen again, since
-        // reconnections remove listeners
-        if (should_issue_listen(events))
-        {
-            if (auto [ec] = co_await conn.exec(req, check()); ec)
-            {
-                std::cerr << "Error issuing listening: " << ec << ": " << ec.message() << std::endl;
-                co_return {};
-            }
-        }
-    }
+    // Subscriptions are renewed automatically every time we reconnect
+    co_subscriber subscriber{conn};
+    subscriber.subscribe("mychannel", [](const notification_view& event) {
+        std::cout << "Received notification from process " << event.backend_pid << ", channel '"
+                  << event.channel << "', payload '" << event.payload << "'\n";
+    });
+
+    // Read notifications and dispatch them to subscribers.
+    // This issues the required LISTEN statements when the connection is established
+    if (auto [ec] = co_await subscriber.run(); ec)
+        std::cerr << "Error reading events: " << ec << ": " << ec.message() << std::endl;
+    co_return {};
 }
 
 static capy::task<> co_main()
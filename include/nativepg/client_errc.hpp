@@ -114,6 +114,14 @@ enum class client_errc : int
     // You issued a COPY SQL statement through an API that doesn't support COPY operations.
     // Use an appropriate API, instead
     copy_not_allowed,
+
+    // A routing pool has no server that can serve the request: there is no reachable primary
+    // for read-write requests, or no reachable replica (that is recent enough) for read-only ones
+    no_suitable_host,
+
+    // The statements added by request::add_transaction contain syncs or simple queries,
+    // which would break the transaction's rollback guarantees
+    invalid_transaction,
 };
 
 /// Creates an \ref error_code from a \ref client_errc.
@@ -19,6 +19,7 @@
 #include <span>
 
 #include "nativepg/connect_params.hpp"
+#include "nativepg/exec_item.hpp"
 #include "nativepg/extended_error.hpp"
 #include "nativepg/protocol/connection_state.hpp"
 #include "nativepg/protocol/copy.hpp"
@@ -81,6 +82,8 @@ private:
     } data_;
 };
 
+class co_resolve_cache;
+
 class co_connection
 {
     struct impl;
@@ -105,6 +108,10 @@ public:
 
     boost::capy::io_task<> connect(connect_params params, diagnostics* diag = nullptr);
 
+    // Makes connect use a resolve cache, shared with other connections. The cache must
+    // outlive the connection. Pass nullptr to resolve hostnames on every connect (the default)
+    void set_resolve_cache(co_resolve_cache* cache) noexcept;
+
     boost::capy::io_task<> exec(
         const request& req,
         response_handler_ref handler,
@@ -118,6 +125,13 @@ public:
         co_return co_await exec(req, response_handler_ref(&handler), diag);
     }
 
+    // Executes several requests, pipelining them: all of them are written at once,
+    // and responses are then dispatched to each item's handler, in order.
+    // Each item's outcome is stored in exec_item::result. A request failing doesn't affect
+    // the others. The returned error is only set for errors that affect the entire batch
+    // (e.g. network errors), and makes the connection unusable
+    boost::capy::io_task<> exec_batch(std::span<exec_item> items);
+
     // The request and the handler must live until the entire response has been read
     // with exec_some
     void setup_request(const request& req, response_handler_ref handler);
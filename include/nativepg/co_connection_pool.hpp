@@ -14,11 +14,15 @@
 #include <boost/compat/function_ref.hpp>
 
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <utility>
 
 #include "nativepg/co_connection.hpp"
 #include "nativepg/connect_params.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/resolve_cache_params.hpp"
+#include "nativepg/response_handler.hpp"
 
 namespace nativepg {
 
@@ -38,6 +42,23 @@ struct pool_params
     std::chrono::steady_clock::duration retry_interval{std::chrono::seconds(30)};
     std::chrono::steady_clock::duration ping_interval{std::chrono::seconds(30)};
     std::chrono::steady_clock::duration ping_timeout{std::chrono::seconds(10)};
+
+    // If true, hostname resolutions are shared by all the pool's connections,
+    // so refilling the pool doesn't flood the resolver
+    bool cache_resolutions{true};
+    resolve_cache_params resolve_cache{};
+
+    // Executed on each new connection, after connecting and before handing it to users.
+    // Use it to prepare statements, set session parameters or load type information,
+    // so the first user requests don't pay for it. Failures are handled like connect failures,
+    // and connect_timeout covers both. Requests without messages are not executed (the default).
+    // The request is used for the pool's lifetime, so it can't contain borrowed values (see borrowed_bytes)
+    request on_connect{};
+
+    // Returns the handler for on_connect's response. Invoked once per warm-up, with the connection
+    // being warmed up. Connections may warm up concurrently, so distinct connections should
+    // get distinct handlers, valid until the warm-up completes. If empty, errors are checked
+    std::function<response_handler_ref(co_connection&)> on_connect_handler{};
 };
 
 class pooled_connection
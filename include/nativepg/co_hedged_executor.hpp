@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_CO_HEDGED_EXECUTOR_HPP
+#define NATIVEPG_CO_HEDGED_EXECUTOR_HPP
+
+#include <boost/capy/io_task.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "nativepg/co_multiplexed_connection.hpp"
+#include "nativepg/extended_error.hpp"
+#include "nativepg/hedging_params.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+
+namespace nativepg {
+
+// Executes idempotent, read-only requests against a set of replicas, cutting tail latency.
+// If a replica doesn't answer within a delay derived from recent latencies (the 95th percentile
+// by default), the request is sent to another replica. The first successful response wins,
+// and the other attempt is cancelled. Its response is discarded by the connection as it arrives.
+// Never use this for requests with side effects: both attempts may run to completion in the server.
+// The connections are owned and run by the caller, and must outlive this object
+class co_hedged_executor
+{
+    struct impl;
+    std::unique_ptr<impl> impl_;
+
+public:
+    explicit co_hedged_executor(std::vector<co_multiplexed_connection*> replicas, hedging_params params = {});
+
+    co_hedged_executor(co_hedged_executor&&) noexcept;
+    co_hedged_executor(const co_hedged_executor&) = delete;
+
+    co_hedged_executor& operator=(co_hedged_executor&&) noexcept;
+    co_hedged_executor& operator=(const co_hedged_executor&) = delete;
+
+    ~co_hedged_executor();
+
+    // Each attempt writes its response to a different handler, since the losing attempt
+    // may have partially populated its own. Returns the index of the handler holding
+    // the response: 0 for first_handler, 1 for hedge_handler
+    boost::capy::io_task<std::size_t> exec(
+        const request& req,
+        response_handler_ref first_handler,
+        response_handler_ref hedge_handler,
+        diagnostics* diag = nullptr
+    );
+
+    // Same as the above, but creates the handlers by invoking make_handler with
+    // the index of the attempt (0 or 1)
+    template <class MakeHandler>
+        requires response_handler<std::invoke_result_t<MakeHandler&, std::size_t>>
+    boost::capy::io_task<std::size_t> exec(
+        const request& req,
+        MakeHandler make_handler,
+        diagnostics* diag = nullptr
+    )
+    {
+        // Keep the handlers alive
+        auto first_handler = make_handler(std::size_t(0));
+        auto hedge_handler = make_handler(std::size_t(1));
+        co_return co_await exec(
+            req,
+            response_handler_ref(&first_handler),
+            response_handler_ref(&hedge_handler),
+            diag
+        );
+    }
+
+    // The current hedging delay
+    std::chrono::steady_clock::duration delay() const;
+
+    // How often hedging fired
+    hedging_stats stats() const;
+};
+
+}  // namespace nativepg
+
+#endif
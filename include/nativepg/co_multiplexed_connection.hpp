@@ -12,14 +12,18 @@
 #include <boost/capy/ex/execution_context.hpp>
 #include <boost/capy/io_task.hpp>
 
+#include <chrono>
 #include <concepts>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
+#include "nativepg/co_resolve_cache.hpp"
 #include "nativepg/connect_params.hpp"
 #include "nativepg/extended_error.hpp"
 #include "nativepg/notification_event.hpp"
 #include "nativepg/request.hpp"
+#include "nativepg/request_priority.hpp"
 #include "nativepg/response_handler.hpp"
 
 namespace nativepg {
@@ -32,6 +36,38 @@ struct multiplexed_config
 
     /// Time span to wait between successive connection retries.
     std::chrono::steady_clock::duration reconnect_wait_interval = std::chrono::seconds{1};
+
+    /// Maximum number of notification events kept until read_notifications is called.
+    std::size_t max_pending_notifications = 256u;
+
+    /// What to do with notifications received when max_pending_notifications is reached.
+    /// With block, the connection stops reading until there is space available,
+    /// delaying responses to requests. With any other policy, the number of
+    /// discarded notifications is reported by notification_batch::num_dropped.
+    notification_overflow_policy notification_overflow = notification_overflow_policy::block;
+
+    /// Size of the secondary buffer used by notification_overflow_policy::spill.
+    std::size_t max_spilled_notifications = 1024u;
+
+    /// If not null, reconnects resolve hostnames through this cache, which may be shared
+    /// by a group of connections. It must outlive run(), and is run by the caller.
+    co_resolve_cache* resolve_cache = nullptr;
+
+    /// If true, concurrent executions of requests with identical payloads that are marked with
+    /// request::set_idempotent_read share a single round-trip, as long as the response
+    /// hasn't started arriving. Every handler receives all response messages.
+    /// Requests with borrowed parameter values are never shared.
+    bool deduplicate_reads = false;
+
+    /// Maximum number of bytes written at once. Pending requests are written in priority order,
+    /// so limiting writes lets higher priority requests overtake lower priority ones
+    /// submitted before them. At least one request is always written.
+    /// Zero (the default) means no limit: all pending requests are written at once.
+    std::size_t max_write_size = 0u;
+
+    /// A pending request passed over by this many writes is written next, regardless of
+    /// its priority. Prevents low priority requests from waiting forever under sustained load.
+    std::size_t max_deferred_writes = 8u;
 };
 
 class co_multiplexed_connection
@@ -58,19 +94,33 @@ public:
 
     boost::capy::io_task<> run(multiplexed_config cfg);
 
+    // If exec is cancelled while the request is being written, it completes once the write finishes,
+    // so borrowed parameter values (see borrowed_bytes) may be freed as soon as exec returns.
+    // Requests that haven't been written yet are written in priority order
     boost::capy::io_task<> exec(
         const request& req,
         response_handler_ref handler,
-        diagnostics* diag = nullptr
+        diagnostics* diag = nullptr,
+        request_priority priority = request_priority::normal
     );
 
     template <response_handler ResponseHandler>
-    boost::capy::io_task<> exec(const request& req, ResponseHandler handler, diagnostics* diag = nullptr)
+    boost::capy::io_task<> exec(
+        const request& req,
+        ResponseHandler handler,
+        diagnostics* diag = nullptr,
+        request_priority priority = request_priority::normal
+    )
     {
         // Keep the handler alive
-        co_return co_await exec(req, response_handler_ref(&handler), diag);
+        co_return co_await exec(req, response_handler_ref(&handler), diag, priority);
     }
 
+    // Waits for notification events and stores them in output, replacing its previous contents.
+    // The batch's memory is recycled, so this doesn't allocate in the steady state
+    boost::capy::io_task<> read_notifications(notification_batch& output);
+
+    // Same as the above, but copies the events into owning objects
     boost::capy::io_task<> read_notifications(std::vector<notification_event>& output);
 };
 
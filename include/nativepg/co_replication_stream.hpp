@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_CO_REPLICATION_STREAM_HPP
+#define NATIVEPG_CO_REPLICATION_STREAM_HPP
+
+#include <boost/capy/io_task.hpp>
+
+#include <memory>
+#include <span>
+
+#include "nativepg/co_connection.hpp"
+#include "nativepg/protocol/replication.hpp"
+#include "nativepg/replication_params.hpp"
+
+namespace nativepg {
+
+// Streams changes from a logical replication slot, using a co_connection
+// that was connected with connect_params::replication set.
+// The connection can't be used for anything else while streaming.
+// Standby status updates are sent in the background when status_interval elapses
+// or the server requests them, while read() is running.
+class co_replication_stream
+{
+    struct impl;
+    std::unique_ptr<impl> impl_;
+
+public:
+    explicit co_replication_stream(co_connection& conn);
+
+    co_replication_stream(co_replication_stream&&) noexcept;
+    co_replication_stream& operator=(co_replication_stream&&) noexcept;
+    ~co_replication_stream();
+
+    // Issues START_REPLICATION and waits until the server starts streaming
+    boost::capy::io_task<> start(const logical_replication_params& params);
+
+    // Waits for the next batch of XLogData messages. Messages point into the connection's
+    // read buffer, and are valid until the next call. An empty batch means that the stream
+    // has ended (e.g. after stop()), and the connection can be used for other commands again
+    boost::capy::io_task<std::span<const protocol::xlog_data>> read();
+
+    // Records that all changes up to lsn have been durably processed, so the server may discard them.
+    // This is reported to the server on the next status update, so it doesn't perform I/O
+    void confirm(protocol::lsn_t lsn) noexcept;
+
+    // Ends the stream. Takes effect on the next call to read(), which will keep returning
+    // any data that was already in flight, followed by an empty batch
+    void stop() noexcept;
+};
+
+}  // namespace nativepg
+
+#endif
@@ -0,0 +1,63 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_CO_RESOLVE_CACHE_HPP
+#define NATIVEPG_CO_RESOLVE_CACHE_HPP
+
+#include <boost/capy/concept/executor.hpp>
+#include <boost/capy/ex/execution_context.hpp>
+#include <boost/capy/io_task.hpp>
+
+#include <concepts>
+#include <memory>
+
+#include "nativepg/resolve_cache_params.hpp"
+
+namespace nativepg {
+
+class co_connection;
+
+namespace detail {
+struct co_resolve_cache_impl;
+}  // namespace detail
+
+// Caches hostname resolutions, to be shared by a group of connections to the same servers
+// (see co_connection::set_resolve_cache). Concurrent connects to the same host issue a single
+// resolver request, and failures are also cached for a short time.
+// Connection pools have their own. Use this to share resolutions between multiplexed connections
+class co_resolve_cache
+{
+    std::unique_ptr<detail::co_resolve_cache_impl> impl_;
+
+    friend class co_connection;
+
+public:
+    explicit co_resolve_cache(boost::capy::execution_context& ctx, resolve_cache_params params = {});
+
+    template <class Ex>
+        requires(!std::same_as<Ex, co_resolve_cache> && boost::capy::Executor<Ex>)
+    explicit co_resolve_cache(const Ex& ex, resolve_cache_params params = {})
+        : co_resolve_cache{ex.context(), params}
+    {
+    }
+
+    co_resolve_cache(co_resolve_cache&&) noexcept;
+    co_resolve_cache(const co_resolve_cache&) = delete;
+
+    co_resolve_cache& operator=(co_resolve_cache&&) noexcept;
+    co_resolve_cache& operator=(const co_resolve_cache&) = delete;
+
+    ~co_resolve_cache();
+
+    // Refreshes entries in use before they expire, until cancelled. Optional:
+    // if not running, expired entries are resolved again when a connection needs them
+    boost::capy::io_task<> run();
+};
+
+}  // namespace nativepg
+
+#endif
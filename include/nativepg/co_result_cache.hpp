@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_CO_RESULT_CACHE_HPP
+#define NATIVEPG_CO_RESULT_CACHE_HPP
+
+#include <boost/capy/io_task.hpp>
+
+#include "nativepg/co_multiplexed_connection.hpp"
+#include "nativepg/extended_error.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+#include "nativepg/result_cache.hpp"
+
+namespace nativepg {
+
+// Executes a read-only request, serving it from cache if possible.
+// Misses execute the request in conn and cache the response, as described by opts
+boost::capy::io_task<> exec_cached(
+    co_multiplexed_connection& conn,
+    result_cache& cache,
+    const request& req,
+    response_handler_ref handler,
+    const cache_options& opts = {},
+    diagnostics* diag = nullptr
+);
+
+template <response_handler ResponseHandler>
+boost::capy::io_task<> exec_cached(
+    co_multiplexed_connection& conn,
+    result_cache& cache,
+    const request& req,
+    ResponseHandler handler,
+    const cache_options& opts = {},
+    diagnostics* diag = nullptr
+)
+{
+    // Keep the handler alive
+    co_return co_await exec_cached(conn, cache, req, response_handler_ref(&handler), opts, diag);
+}
+
+// Listens on result_cache_params::invalidation_channel, and applies the notifications
+// received by conn to cache until an error occurs. Reconnections invalidate all entries,
+// and the channel is listened again. Like co_subscriber::run, this must be
+// the only reader of the connection's notifications
+boost::capy::io_task<> run_cache_invalidation(co_multiplexed_connection& conn, result_cache& cache);
+
+}  // namespace nativepg
+
+#endif
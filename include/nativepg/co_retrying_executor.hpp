@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_CO_RETRYING_EXECUTOR_HPP
+#define NATIVEPG_CO_RETRYING_EXECUTOR_HPP
+
+#include <boost/capy/io_task.hpp>
+
+#include <cstddef>
+#include <memory>
+
+#include "nativepg/co_connection.hpp"
+#include "nativepg/co_multiplexed_connection.hpp"
+#include "nativepg/extended_error.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+#include "nativepg/retry_params.hpp"
+
+namespace nativepg {
+
+// Executes requests, retrying them when they fail because of serialization failures (40001)
+// or deadlocks (40P01), as commonly happens under the SERIALIZABLE isolation level.
+// Retries wait for a jittered, exponentially growing backoff, and are limited by a retry budget
+// shared by all the requests executed by this object.
+// Only use this for requests that can be safely executed again, like transactions added with
+// request::add_transaction. The handler is set up again before each execution, discarding
+// any state left by a failed one. Not thread-safe
+class co_retrying_executor
+{
+    struct impl;
+    std::unique_ptr<impl> impl_;
+
+public:
+    explicit co_retrying_executor(retry_params params = {});
+
+    co_retrying_executor(co_retrying_executor&&) noexcept;
+    co_retrying_executor(const co_retrying_executor&) = delete;
+
+    co_retrying_executor& operator=(co_retrying_executor&&) noexcept;
+    co_retrying_executor& operator=(const co_retrying_executor&) = delete;
+
+    ~co_retrying_executor();
+
+    // Returns the number of executions performed, including the first one.
+    // On failure, the error is the one from the last execution
+    boost::capy::io_task<std::size_t> exec(
+        co_connection& conn,
+        const request& req,
+        response_handler_ref handler,
+        diagnostics* diag = nullptr
+    );
+
+    boost::capy::io_task<std::size_t> exec(
+        co_multiplexed_connection& conn,
+        const request& req,
+        response_handler_ref handler,
+        diagnostics* diag = nullptr
+    );
+
+    template <class Connection, response_handler ResponseHandler>
+    boost::capy::io_task<std::size_t> exec(
+        Connection& conn,
+        const request& req,
+        ResponseHandler handler,
+        diagnostics* diag = nullptr
+    )
+    {
+        // Keep the handler alive
+        co_return co_await exec(conn, req, response_handler_ref(&handler), diag);
+    }
+
+    // How often retries happened
+    retry_stats stats() const;
+};
+
+}  // namespace nativepg
+
+#endif
@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_CO_ROUTING_POOL_HPP
+#define NATIVEPG_CO_ROUTING_POOL_HPP
+
+#include <boost/assert.hpp>
+#include <boost/capy/concept/executor.hpp>
+#include <boost/capy/ex/execution_context.hpp>
+#include <boost/capy/io_task.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "nativepg/co_connection.hpp"
+#include "nativepg/co_connection_pool.hpp"
+#include "nativepg/connect_params.hpp"
+#include "nativepg/routing_params.hpp"
+
+namespace nativepg {
+
+namespace detail {
+class co_routing_pool_impl;
+}  // namespace detail
+
+struct routing_pool_params
+{
+    // One entry per server. Servers may be listed in any order: roles are detected
+    // by the pool, and may change over time (e.g. after a failover)
+    std::vector<connect_params> hosts;
+
+    // Applied to each host's pool. The transport member is ignored
+    pool_params pool;
+
+    load_balancing balancing{load_balancing::least_loaded};
+
+    // How often each server's role, latency and WAL position are checked, using pg_is_in_recovery().
+    // Checks run on a dedicated connection per server, with pool.connect_timeout and pool.ping_timeout
+    std::chrono::steady_clock::duration role_check_interval{std::chrono::seconds(5)};
+
+    // If true, read-only requests are routed to the primary when no replica can serve them
+    bool fallback_to_primary{true};
+};
+
+// A connection obtained from a co_routing_pool
+class routed_connection
+{
+    pooled_connection conn_{};
+    std::size_t* in_use_{};  // load counter of the host this connection belongs to
+    std::size_t host_index_{};
+
+    routed_connection(pooled_connection&& conn, std::size_t& in_use, std::size_t host_index) noexcept
+        : conn_(std::move(conn)), in_use_(&in_use), host_index_(host_index)
+    {
+    }
+
+    void release() noexcept
+    {
+        if (in_use_)
+        {
+            --*in_use_;
+            in_use_ = nullptr;
+        }
+    }
+
+    friend class detail::co_routing_pool_impl;
+
+public:
+    routed_connection() noexcept = default;
+
+    routed_connection(routed_connection&& other) noexcept
+        : conn_(std::move(other.conn_)),
+          in_use_(std::exchange(other.in_use_, nullptr)),
+          host_index_(other.host_index_)
+    {
+    }
+
+    routed_connection& operator=(routed_connection&& other) noexcept
+    {
+        release();
+        conn_ = std::move(other.conn_);
+        in_use_ = std::exchange(other.in_use_, nullptr);
+        host_index_ = other.host_index_;
+        return *this;
+    }
+
+    routed_connection(const routed_connection&) = delete;
+    routed_connection& operator=(const routed_connection&) = delete;
+
+    ~routed_connection() { release(); }
+
+    bool valid() const noexcept { return conn_.valid(); }
+
+    // The index in routing_pool_params::hosts of the server this connection is connected to
+    std::size_t host_index() const noexcept { return host_index_; }
+
+    co_connection& get() noexcept { return conn_.get(); }
+
+    const co_connection& get() const noexcept { return conn_.get(); }
+
+    co_connection* operator->() noexcept { return &get(); }
+
+    const co_connection* operator->() const noexcept { return &get(); }
+
+    void return_without_reset() noexcept
+    {
+        BOOST_ASSERT(valid());
+        conn_.return_without_reset();
+        release();
+    }
+};
+
+// Manages a co_connection_pool per server in a primary/replicas setup,
+// routing read-write requests to the primary and read-only requests to replicas.
+// Server roles are periodically checked, so routing adapts to failovers.
+class co_routing_pool
+{
+    std::unique_ptr<detail::co_routing_pool_impl> impl_;
+
+    co_routing_pool(boost::capy::execution_context& ctx, routing_pool_params&& params, int);
+
+public:
+    co_routing_pool(boost::capy::execution_context& ctx, routing_pool_params params)
+        : co_routing_pool(ctx, std::move(params), 0)
+    {
+    }
+
+    template <boost::capy::Executor Ex>
+    co_routing_pool(const Ex& ex, routing_pool_params params)
+        : co_routing_pool(ex.context(), std::move(params), 0)
+    {
+    }
+
+    co_routing_pool(const co_routing_pool&) = delete;
+    co_routing_pool& operator=(const co_routing_pool&) = delete;
+
+    co_routing_pool(co_routing_pool&& other) noexcept;
+
+    co_routing_pool& operator=(co_routing_pool&& other) noexcept;
+
+    ~co_routing_pool();
+
+    bool valid() const noexcept { return impl_.get() != nullptr; }
+
+    // Runs the per-host pools and role checks until cancelled
+    boost::capy::io_task<> run();
+
+    // Gets a connection to the server that should serve a request, as described by opts.
+    // Waits until all server roles have been checked once. Fails with client_errc::no_suitable_host
+    // if no server can currently serve the request
+    boost::capy::io_task<routed_connection> get_connection(route_options opts = {});
+
+    // The role last detected for each host, in the order of routing_pool_params::hosts
+    host_role role(std::size_t host_index) const;
+};
+
+}  // namespace nativepg
+
+#endif
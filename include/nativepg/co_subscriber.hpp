@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_CO_SUBSCRIBER_HPP
+#define NATIVEPG_CO_SUBSCRIBER_HPP
+
+#include <boost/capy/io_task.hpp>
+
+#include <string_view>
+#include <utility>
+
+#include "nativepg/co_multiplexed_connection.hpp"
+#include "nativepg/notification_event.hpp"
+#include "nativepg/subscription_registry.hpp"
+
+namespace nativepg {
+
+// Lets many components share the notifications received by a co_multiplexed_connection.
+// Components subscribe to channels, and notifications are dispatched to the channel's subscribers.
+// LISTEN and UNLISTEN statements are batched into a single request, and channels are
+// listened again every time the connection is re-established.
+// run() must be the only reader of the connection's notifications.
+class co_subscriber
+{
+    co_multiplexed_connection* conn_;
+    subscription_registry registry_;
+    notification_batch events_;
+
+public:
+    explicit co_subscriber(co_multiplexed_connection& conn) noexcept : conn_(&conn) {}
+
+    // Registers a handler for a channel. No I/O is performed. The server is
+    // informed on the next call to sync(), or after the current batch of notifications
+    // has been dispatched, if called from a handler.
+    subscription_id subscribe(std::string_view channel, notification_handler handler)
+    {
+        return registry_.subscribe(channel, std::move(handler));
+    }
+
+    // Removes a subscription. The server is informed as described in subscribe()
+    void unsubscribe(subscription_id id) { registry_.unsubscribe(id); }
+
+    // Sends any pending LISTEN and UNLISTEN statements, in a single request
+    boost::capy::io_task<> sync();
+
+    // Syncs, then reads notifications and dispatches them to subscribers until an error occurs.
+    // Connection events are handled internally
+    boost::capy::io_task<> run();
+
+    const subscription_registry& registry() const noexcept { return registry_; }
+};
+
+}  // namespace nativepg
+
+#endif
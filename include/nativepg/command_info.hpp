@@ -8,6 +8,7 @@
 #ifndef NATIVEPG_COMMAND_INFO_HPP
 #define NATIVEPG_COMMAND_INFO_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -31,6 +32,44 @@ struct command_info
     friend bool operator==(const command_info&, const command_info&) = default;
 };
 
+// Information about the execution of a batch added with request::add_execute_batch
+struct batch_info
+{
+    // The number of rows in the batch that were executed successfully
+    std::size_t num_executed{};
+
+    // The sum of the rows affected by each execution. Executions whose
+    // CommandComplete doesn't include a row count are not considered
+    std::uint64_t affected_rows{};
+
+    // If an execution failed, its index within the batch.
+    // The server skips all subsequent executions.
+    std::optional<std::size_t> failed_index{};
+
+    friend bool operator==(const batch_info&, const batch_info&) = default;
+};
+
+// Information about the execution of a transaction added with request::add_transaction
+struct transaction_info
+{
+    // The number of statements that were executed successfully, excluding BEGIN and COMMIT
+    std::size_t num_executed{};
+
+    // The sum of the rows affected by each statement. Statements whose
+    // CommandComplete doesn't include a row count are not considered
+    std::uint64_t affected_rows{};
+
+    // If a statement failed, its index within the transaction (i.e. the number of Execute messages
+    // added before it). The server skips all subsequent statements, and the transaction is rolled back.
+    // Not set if BEGIN or COMMIT failed
+    std::optional<std::size_t> failed_index{};
+
+    // Whether COMMIT succeeded. If false, none of the statements had any effect
+    bool committed{};
+
+    friend bool operator==(const transaction_info&, const transaction_info&) = default;
+};
+
 }  // namespace nativepg
 
 #endif
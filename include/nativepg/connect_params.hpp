@@ -8,10 +8,18 @@
 #ifndef NATIVEPG_CONNECT_PARAMS_HPP
 #define NATIVEPG_CONNECT_PARAMS_HPP
 
+#include <chrono>
 #include <string>
+#include <vector>
 
 namespace nativepg {
 
+struct host_address
+{
+    std::string hostname;
+    unsigned short port{5432};
+};
+
 struct connect_params
 {
     // TODO: UNIX sockets
@@ -21,7 +29,19 @@ struct connect_params
     std::string username{"postgres"};
     std::string password{};
     std::string database{"postgres"};
+
+    // If true, the connection is started in logical replication mode (replication=database).
+    // Such connections accept replication commands like START_REPLICATION, in addition to simple queries
+    bool replication{false};
     // TODO: support arbitrary startup params?
+
+    // Additional servers, for failover. If not empty, co_connection races connection attempts,
+    // happy eyeballs style: hostname is tried first, then each of these in order. A new attempt
+    // starts every connect_stagger, or as soon as the previous one fails. The first attempt
+    // to complete the startup wins, and the others are cancelled.
+    // The Asio-based connection doesn't support this: it ignores these and connects to hostname only
+    std::vector<host_address> fallback_hosts{};
+    std::chrono::steady_clock::duration connect_stagger{std::chrono::milliseconds(250)};
 };
 
 }  // namespace nativepg
@@ -10,19 +10,23 @@
 
 #include <boost/asio/any_io_executor.hpp>
 #include <boost/asio/async_result.hpp>
+#include <boost/asio/buffer.hpp>
 #include <boost/asio/compose.hpp>
 #include <boost/asio/connect.hpp>
 #include <boost/asio/consign.hpp>
 #include <boost/asio/deferred.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/system/error_code.hpp>
 
 #include <cstddef>
 #include <memory>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "nativepg/connect_params.hpp"
 #include "nativepg/extended_error.hpp"
@@ -42,8 +46,65 @@ struct connection_impl
     boost::asio::ip::tcp::resolver resolv;
     boost::asio::ip::tcp::socket sock;
     protocol::connection_state st{};
+    std::vector<boost::asio::const_buffer> write_buffers;
 
-    explicit connection_impl(boost::asio::any_io_executor ex) : resolv(ex), sock(std::move(ex)) {}
+    // State for full-duplex writes. The timer never expires, and is cancelled when the write finishes
+    boost::asio::steady_timer duplex_timer;
+    bool duplex_write_pending{false};
+    boost::system::error_code duplex_write_ec;
+    std::size_t duplex_write_bytes{};
+
+    explicit connection_impl(boost::asio::any_io_executor ex)
+        : resolv(ex), sock(ex), duplex_timer(std::move(ex))
+    {
+    }
+
+    // Composes write_buffers from the chunks of a request (or anything with for_each_chunk),
+    // so borrowed parameter values are not copied. Returns the number of bytes to write
+    template <class ChunkSource>
+    std::size_t prepare_write_buffers(const ChunkSource& src)
+    {
+        std::size_t size = 0u;
+        write_buffers.clear();
+        src.for_each_chunk([this, &size](std::span<const unsigned char> chunk) {
+            write_buffers.push_back(boost::asio::buffer(chunk.data(), chunk.size()));
+            size += chunk.size();
+        });
+        return size;
+    }
+
+    // Starts writing write_buffers in the background
+    void start_duplex_write()
+    {
+        BOOST_ASSERT(!duplex_write_pending);
+        duplex_write_pending = true;
+        duplex_write_ec = {};
+        duplex_write_bytes = 0u;
+        duplex_timer.expires_at((boost::asio::steady_timer::time_point::max)());
+        boost::asio::async_write(
+            sock,
+            write_buffers,
+            [this](boost::system::error_code ec, std::size_t bytes) {
+                duplex_write_pending = false;
+                duplex_write_ec = ec;
+                duplex_write_bytes = bytes;
+
+                // Unblock the reader, so the FSM can be resumed with the write's outcome
+                boost::system::error_code ignored;
+                sock.cancel(ignored);
+                duplex_timer.cancel();
+            }
+        );
+    }
+
+    // Reads whatever the server sends into the read buffer while a full-duplex write is in progress,
+    // without parsing it, so the server never stalls sending its response
+    template <class Self>
+    void start_duplex_read(Self& self)
+    {
+        st.read_buffer.prepare(4096u);
+        sock.async_read_some(st.read_buffer.prepared_area(), std::move(self));
+    }
 };
 
 struct physical_connect_op
@@ -122,18 +183,75 @@ struct connect_op
 
 struct exec_op
 {
+    enum class duplex_state
+    {
+        none,
+        reading,    // reading while a full-duplex write is in progress
+        cut_short,  // reading failed, and we're waiting for the cancelled write
+    };
+
     connection_impl& impl;
     protocol::detail::exec_fsm fsm_;
+    duplex_state duplex_{duplex_state::none};
+    boost::system::error_code read_ec_{};
 
     template <class Self>
     void operator()(Self& self, boost::system::error_code ec = {}, std::size_t bytes_transferred = {})
     {
-        auto res = fsm_.resume(impl.st, ec, bytes_transferred);
+        protocol::detail::exec_fsm::result res{boost::system::error_code()};
+        switch (duplex_)
+        {
+            case duplex_state::reading:
+            {
+                // The FSM is resumed with the write's outcome once it has finished
+                impl.st.read_buffer.commit(bytes_transferred);
+                if (impl.duplex_write_pending)
+                {
+                    if (!ec)
+                    {
+                        impl.start_duplex_read(self);
+                        return;
+                    }
+
+                    // Reading failed before the write finished. The write is cut short, leaving the stream
+                    // in the middle of a message. The connection can't be used until it's re-established
+                    duplex_ = duplex_state::cut_short;
+                    read_ec_ = ec;
+                    boost::system::error_code ignored;
+                    impl.sock.close(ignored);
+                    impl.duplex_timer.async_wait(std::move(self));
+                    return;
+                }
+                duplex_ = duplex_state::none;
+                res = fsm_.resume(impl.st, impl.duplex_write_ec, impl.duplex_write_bytes);
+                break;
+            }
+            case duplex_state::cut_short:
+            {
+                duplex_ = duplex_state::none;
+                res = fsm_.resume(impl.st, read_ec_, impl.duplex_write_bytes);
+                break;
+            }
+            default: res = fsm_.resume(impl.st, ec, bytes_transferred); break;
+        }
+
         switch (res.type())
         {
             case protocol::startup_fsm::result_type::write:
-                boost::asio::async_write(impl.sock, res.write_data(), std::move(self));
+            {
+                if (impl.prepare_write_buffers(fsm_) > protocol::detail::full_duplex_threshold)
+                {
+                    // Read the response while writing
+                    impl.start_duplex_write();
+                    duplex_ = duplex_state::reading;
+                    impl.start_duplex_read(self);
+                }
+                else
+                {
+                    boost::asio::async_write(impl.sock, impl.write_buffers, std::move(self));
+                }
                 break;
+            }
             case protocol::startup_fsm::result_type::read:
                 impl.sock.async_read_some(res.read_buffer(), std::move(self));
                 break;
@@ -0,0 +1,33 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_DETAIL_HEX_HPP
+#define NATIVEPG_DETAIL_HEX_HPP
+
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace nativepg::detail {
+
+// Hex codec used by the bytea text format (\x followed by hex pairs).
+// These are vectorized (SSE2/AVX2, when available at compile time), with a scalar fallback.
+
+// Decodes a sequence of hex pairs (upper or lower case) into output.
+// input.size() must be even, and output must point to input.size() / 2 writable bytes.
+// Returns client_errc::protocol_value_error if input contains invalid characters.
+// On error, the contents of output are unspecified.
+[[nodiscard]] boost::system::error_code hex_decode(std::string_view input, unsigned char* output) noexcept;
+
+// Encodes input as lowercase hex pairs. output must point to 2 * input.size() writable chars.
+void hex_encode(std::span<const unsigned char> input, char* output) noexcept;
+
+}  // namespace nativepg::detail
+
+#endif
@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_DETAIL_PARSE_NUMBER_HPP
+#define NATIVEPG_DETAIL_PARSE_NUMBER_HPP
+
+#include <boost/endian/conversion.hpp>
+
+#include <cfloat>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+// Fast parsing of the numbers that PostgreSQL sends in text format.
+// Digits are processed 8 at a time using SWAR (SIMD within a register).
+// Inputs outside the fast paths (leading zeros, long mantissas, infinities...)
+// are handed to std::from_chars, so results are always the same.
+
+namespace nativepg::detail {
+
+// Loads 8 characters as an integer, with the first character in the lowest byte
+inline std::uint64_t swar_load(const char* p) noexcept
+{
+    return boost::endian::endian_load<std::uint64_t, 8, boost::endian::order::little>(
+        reinterpret_cast<const unsigned char*>(p)
+    );
+}
+
+// Are all the 8 characters in v decimal digits?
+constexpr bool swar_is_eight_digits(std::uint64_t v) noexcept
+{
+    return ((v & 0xf0f0f0f0f0f0f0f0u) | (((v + 0x0606060606060606u) & 0xf0f0f0f0f0f0f0f0u) >> 4)) ==
+           0x3333333333333333u;
+}
+
+// Converts 8 digits to their value. Requires swar_is_eight_digits(v)
+constexpr std::uint32_t swar_parse_eight_digits(std::uint64_t v) noexcept
+{
+    constexpr std::uint64_t mask = 0x000000ff000000ffu;
+    constexpr std::uint64_t mul1 = 100u + (1000000ull << 32);
+    constexpr std::uint64_t mul2 = 1u + (10000ull << 32);
+    v -= 0x3030303030303030u;
+    v = (v * 10u) + (v >> 8);  // Combine digit pairs
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return static_cast<std::uint32_t>(v);
+}
+
+// Accumulates the digits in [first, last) into value, stopping at the first non-digit.
+// The caller must ensure that value doesn't overflow (at most 19 digits).
+inline const char* accumulate_digits(const char* first, const char* last, std::uint64_t& value) noexcept
+{
+    while (last - first >= 8)
+    {
+        const std::uint64_t v = swar_load(first);
+        if (!swar_is_eight_digits(v))
+            break;
+        value = value * 100000000u + swar_parse_eight_digits(v);
+        first += 8;
+    }
+    while (first != last)
+    {
+        const unsigned digit = static_cast<unsigned char>(*first) - static_cast<unsigned>('0');
+        if (digit > 9u)
+            break;
+        value = value * 10u + digit;
+        ++first;
+    }
+    return first;
+}
+
+template <class T>
+bool parse_number_fallback(std::string_view sv, T& to) noexcept
+{
+    T result{};
+    auto [ptr, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), result);
+    if (ec != std::errc{} || ptr != sv.data() + sv.size())
+        return false;
+    to = result;
+    return true;
+}
+
+// Parses a decimal integer, with an optional minus sign for signed types.
+// Returns false if sv isn't a valid integer or doesn't fit in T.
+template <std::integral T>
+bool parse_text_integer(std::string_view sv, T& to) noexcept
+{
+    static_assert(sizeof(T) <= sizeof(std::uint64_t));
+    using unsigned_type = std::make_unsigned_t<T>;
+
+    const char* first = sv.data();
+    const char* last = first + sv.size();
+
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (first != last && *first == '-')
+        {
+            negative = true;
+            ++first;
+        }
+    }
+
+    // 19 digits always fit in a std::uint64_t. Longer inputs are either errors
+    // or have leading zeros, which PostgreSQL doesn't generate
+    if (first == last || last - first > 19)
+        return parse_number_fallback(sv, to);
+
+    std::uint64_t value = 0u;
+    if (accumulate_digits(first, last, value) != last)
+        return false;
+
+    // Range check. The magnitude of the minimum value is max + 1
+    const std::uint64_t max_magnitude = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) +
+                                        (negative ? 1u : 0u);
+    if (value > max_magnitude)
+        return false;
+
+    // Conversion to signed is modular in C++20
+    const auto magnitude = static_cast<unsigned_type>(value);
+    to = static_cast<T>(negative ? static_cast<unsigned_type>(0u - magnitude) : magnitude);
+    return true;
+}
+
+// Exact powers of 10 for the floating point fast path
+template <class T>
+struct float_fast_path_traits;
+
+template <>
+struct float_fast_path_traits<float>
+{
+    static constexpr std::uint64_t max_mantissa = std::uint64_t(1) << 24;
+    static constexpr int max_exponent = 10;
+    static constexpr float powers[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+};
+
+template <>
+struct float_fast_path_traits<double>
+{
+    static constexpr std::uint64_t max_mantissa = std::uint64_t(1) << 53;
+    static constexpr int max_exponent = 22;
+    static constexpr double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+};
+
+// Clinger's fast path: if both the decimal mantissa and the power of 10 are exactly representable,
+// a single IEEE multiplication or division yields the correctly rounded result.
+// This requires floating point operations to be evaluated in their own precision (not x87).
+// Returns false if the input is not a plain decimal number within the fast path limits.
+template <std::floating_point T>
+bool parse_text_floating_fast(std::string_view sv, T& to) noexcept
+{
+    using traits = float_fast_path_traits<T>;
+    if constexpr (FLT_EVAL_METHOD != 0 || !std::numeric_limits<T>::is_iec559)
+    {
+        return false;
+    }
+    else
+    {
+        const char* first = sv.data();
+        const char* last = first + sv.size();
+
+        bool negative = false;
+        if (first != last && *first == '-')
+        {
+            negative = true;
+            ++first;
+        }
+
+        // Mantissa: integer and fractional parts, at most 19 digits in total
+        std::uint64_t mantissa = 0u;
+        const char* int_end = accumulate_digits(first, last, mantissa);
+        std::ptrdiff_t num_digits = int_end - first;
+        int exponent = 0;
+        const char* p = int_end;
+        if (p != last && *p == '.')
+        {
+            ++p;
+            const char* frac_end = accumulate_digits(p, last, mantissa);
+            exponent = -static_cast<int>(frac_end - p);
+            num_digits += frac_end - p;
+            p = frac_end;
+        }
+        if (num_digits == 0 || num_digits > 19)
+            return false;
+
+        // Exponent
+        if (p != last && (*p == 'e' || *p == 'E'))
+        {
+            ++p;
+            bool exp_negative = false;
+            if (p != last && (*p == '-' || *p == '+'))
+            {
+                exp_negative = *p == '-';
+                ++p;
+            }
+            std::uint64_t exp_value = 0u;
+            const char* exp_end = accumulate_digits(p, last, exp_value);
+            if (exp_end == p || exp_end - p > 4)
+                return false;
+            exponent += exp_negative ? -static_cast<int>(exp_value) : static_cast<int>(exp_value);
+            p = exp_end;
+        }
+
+        if (p != last || mantissa > traits::max_mantissa || exponent < -traits::max_exponent ||
+            exponent > traits::max_exponent)
+            return false;
+
+        T value = static_cast<T>(mantissa);
+        if (exponent < 0)
+            value /= traits::powers[-exponent];
+        else
+            value *= traits::powers[exponent];
+        to = negative ? -value : value;
+        return true;
+    }
+}
+
+// Parses a floating point number. Returns false if sv isn't valid or is out of range.
+// Infinities and NaNs (e.g. "Infinity", "NaN") are supported through the fallback
+template <std::floating_point T>
+bool parse_text_floating(std::string_view sv, T& to) noexcept
+{
+    // from_chars implements Eisel-Lemire in modern standard libraries
+    return parse_text_floating_fast(sv, to) || parse_number_fallback(sv, to);
+}
+
+}  // namespace nativepg::detail
+
+#endif
@@ -0,0 +1,30 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_EXEC_ITEM_HPP
+#define NATIVEPG_EXEC_ITEM_HPP
+
+#include "nativepg/extended_error.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+
+namespace nativepg {
+
+// A request and its response handler, to be executed as part of a batch.
+// The request and the handler must live until the batch operation completes
+struct exec_item
+{
+    const request* req;
+    response_handler_ref handler;
+
+    // Output. The outcome of this request
+    extended_error result{};
+};
+
+}  // namespace nativepg
+
+#endif
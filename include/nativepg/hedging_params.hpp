@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_HEDGING_PARAMS_HPP
+#define NATIVEPG_HEDGING_PARAMS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace nativepg {
+
+// Configures when co_hedged_executor sends a second copy of a request
+struct hedging_params
+{
+    // The hedge is sent when the first attempt takes longer than this
+    // quantile of the latencies recently observed. Must be in (0, 1]
+    double quantile{0.95};
+
+    // Number of recent latencies the quantile is computed from
+    std::size_t window{1000u};
+
+    // Until this many latencies have been recorded, initial_delay is used
+    std::size_t min_samples{20u};
+
+    std::chrono::steady_clock::duration initial_delay{std::chrono::milliseconds(50)};
+
+    // Bounds for the computed delay
+    std::chrono::steady_clock::duration min_delay{std::chrono::milliseconds(1)};
+    std::chrono::steady_clock::duration max_delay{std::chrono::seconds(1)};
+
+    // Maximum fraction of requests that may be hedged. Limits the extra load
+    // when all servers are slow, which would otherwise cause every request to be sent twice
+    double max_hedge_ratio{0.1};
+};
+
+// Counters describing how often hedging fired
+struct hedging_stats
+{
+    // Requests executed
+    std::uint64_t num_requests{};
+
+    // Requests for which a second attempt was sent
+    std::uint64_t num_hedged{};
+
+    // Requests answered by the second attempt
+    std::uint64_t num_hedge_wins{};
+};
+
+}  // namespace nativepg
+
+#endif
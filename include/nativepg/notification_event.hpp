@@ -8,8 +8,16 @@
 #ifndef NATIVEPG_NOTIFICATION_EVENT_HPP
 #define NATIVEPG_NOTIFICATION_EVENT_HPP
 
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace nativepg {
 
@@ -36,6 +44,248 @@ struct notification_event
     std::string payload{};
 };
 
+// Like notification_event, but pointing to storage owned by a notification_batch
+struct notification_view
+{
+    // What did happen?
+    notification_event_type type;
+
+    // If type == notify, the process ID of the notifying backend
+    std::int32_t backend_pid{};
+
+    // If type == notify, the channel that was notified
+    std::string_view channel{};
+
+    // If type == notify, the payload passed to NOTIFY
+    std::string_view payload{};
+
+    operator notification_event() const
+    {
+        return {type, backend_pid, std::string(channel), std::string(payload)};
+    }
+};
+
+// What to do when a multiplexed connection receives a notification but
+// max_pending_notifications events are already waiting to be read
+enum class notification_overflow_policy
+{
+    // Stop reading from the connection until the consumer reads notifications.
+    // This delays the responses to any request running in the connection
+    block,
+
+    // Discard the oldest pending notification
+    drop_oldest,
+
+    // Discard the incoming notification
+    drop_newest,
+
+    // Discard the incoming notification. If a pending notification has the same channel and payload,
+    // no information is lost, and the notification is not reported as dropped
+    coalesce,
+
+    // Store the incoming notification in a secondary buffer, of size max_spilled_notifications.
+    // If that is full, discard the incoming notification
+    spill,
+};
+
+// A batch of notification events, as returned by read_notifications.
+// Strings are stored contiguously in an arena, with each channel name stored once per batch.
+// Views are valid until the batch is passed again to read_notifications, which recycles its memory.
+// Once the batch and the connection's internal buffers have grown enough, no allocations are performed.
+class notification_batch
+{
+    struct entry
+    {
+        notification_event_type type;
+        std::int32_t backend_pid;
+        std::size_t channel_index;
+        std::size_t payload_offset;
+        std::size_t payload_size;
+    };
+
+    // Channel names stored in the arena, to avoid storing them once per notification.
+    // A handful of channels is typically used, so linear search is fine
+    struct channel_entry
+    {
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    std::vector<entry> entries_;
+    std::vector<char> arena_;
+    std::vector<channel_entry> channels_;
+    std::size_t first_{};       // entries before this one have been erased
+    std::size_t dead_bytes_{};  // arena bytes used by erased entries
+    std::size_t num_dropped_{};
+
+    std::string_view get_string(std::size_t offset, std::size_t size) const
+    {
+        return {arena_.data() + offset, size};
+    }
+
+    std::size_t add_string(std::string_view value)
+    {
+        auto offset = arena_.size();
+        arena_.insert(arena_.end(), value.begin(), value.end());
+        return offset;
+    }
+
+    std::size_t intern_channel(std::string_view channel)
+    {
+        for (std::size_t i = 0u; i < channels_.size(); ++i)
+        {
+            if (get_string(channels_[i].offset, channels_[i].size) == channel)
+                return i;
+        }
+        channels_.push_back({add_string(channel), channel.size()});
+        return channels_.size() - 1u;
+    }
+
+    // Removes erased entries and their strings. Strings are appended in order,
+    // so they can be moved towards the beginning of the arena in a single pass
+    void compact()
+    {
+        std::size_t cursor = 0u;
+        auto move_string = [this, &cursor](std::size_t& offset, std::size_t size) {
+            std::copy(arena_.begin() + offset, arena_.begin() + offset + size, arena_.begin() + cursor);
+            offset = cursor;
+            cursor += size;
+        };
+
+        auto ch = channels_.begin();
+        for (auto ent = entries_.begin() + first_; ent != entries_.end(); ++ent)
+        {
+            for (; ch != channels_.end() && ch->offset < ent->payload_offset; ++ch)
+                move_string(ch->offset, ch->size);
+            move_string(ent->payload_offset, ent->payload_size);
+        }
+        for (; ch != channels_.end(); ++ch)
+            move_string(ch->offset, ch->size);
+
+        arena_.resize(cursor);
+        entries_.erase(entries_.begin(), entries_.begin() + first_);
+        first_ = 0u;
+        dead_bytes_ = 0u;
+    }
+
+public:
+    class iterator
+    {
+        const notification_batch* self_{};
+        std::size_t index_{};
+
+    public:
+        using value_type = notification_view;
+        using difference_type = std::ptrdiff_t;
+        using reference = notification_view;
+
+        // operator* returns a proxy, so this is only a legacy input iterator
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator() = default;
+        iterator(const notification_batch* self, std::size_t index) noexcept : self_(self), index_(index) {}
+
+        notification_view operator*() const { return (*self_)[index_]; }
+        iterator& operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+        iterator operator++(int) noexcept
+        {
+            auto res = *this;
+            ++index_;
+            return res;
+        }
+        friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept = default;
+    };
+
+    notification_batch() = default;
+
+    std::size_t size() const noexcept { return entries_.size() - first_; }
+    bool empty() const noexcept { return size() == 0u; }
+
+    notification_view operator[](std::size_t i) const
+    {
+        BOOST_ASSERT(i < size());
+        const auto& ent = entries_[first_ + i];
+        if (ent.type != notification_event_type::notify)
+            return {ent.type};
+        const auto& ch = channels_[ent.channel_index];
+        return {
+            ent.type,
+            ent.backend_pid,
+            get_string(ch.offset, ch.size),
+            get_string(ent.payload_offset, ent.payload_size),
+        };
+    }
+
+    iterator begin() const noexcept { return {this, 0u}; }
+    iterator end() const noexcept { return {this, size()}; }
+    notification_view back() const { return (*this)[size() - 1u]; }
+
+    // How many notifications were discarded because of the overflow policy
+    // before the events in this batch were received
+    std::size_t num_dropped() const noexcept { return num_dropped_; }
+    void set_num_dropped(std::size_t value) noexcept { num_dropped_ = value; }
+
+    // Appends an event, copying its strings into the arena
+    void push_back(const notification_view& evt)
+    {
+        if (evt.type != notification_event_type::notify)
+        {
+            entries_.push_back({evt.type, 0, 0u, arena_.size(), 0u});
+            return;
+        }
+        auto channel_index = intern_channel(evt.channel);
+        auto payload_offset = add_string(evt.payload);
+        entries_.push_back({evt.type, evt.backend_pid, channel_index, payload_offset, evt.payload.size()});
+    }
+
+    // Removes the last event. Its strings are kept in the arena until the batch is cleared
+    void pop_back()
+    {
+        BOOST_ASSERT(!empty());
+        entries_.pop_back();
+    }
+
+    // Removes the i-th event. Erasing the first one is cheap. The arena is compacted
+    // when erased strings take more space than live ones, so memory usage stays bounded
+    void erase(std::size_t i)
+    {
+        BOOST_ASSERT(i < size());
+        dead_bytes_ += entries_[first_ + i].payload_size;
+        if (i == 0u)
+            ++first_;
+        else
+            entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(first_ + i));
+        if (dead_bytes_ * 2u > arena_.size() || first_ * 2u > entries_.size())
+            compact();
+    }
+
+    // Removes all events, keeping the allocated memory
+    void clear() noexcept
+    {
+        entries_.clear();
+        arena_.clear();
+        channels_.clear();
+        first_ = 0u;
+        dead_bytes_ = 0u;
+        num_dropped_ = 0u;
+    }
+
+    void swap(notification_batch& other) noexcept
+    {
+        entries_.swap(other.entries_);
+        arena_.swap(other.arena_);
+        channels_.swap(other.channels_);
+        std::swap(first_, other.first_);
+        std::swap(dead_bytes_, other.dead_bytes_);
+        std::swap(num_dropped_, other.num_dropped_);
+    }
+};
+
 }  // namespace nativepg
 
 #endif
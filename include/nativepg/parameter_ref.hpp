@@ -15,12 +15,39 @@
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <span>
 #include <string_view>
 #include <system_error>
 #include <type_traits>
+#include <vector>
+
+#include "nativepg/detail/hex.hpp"
 
 namespace nativepg {
 
+// A bytea parameter referencing a user-supplied buffer, rather than owning it.
+// When sent in binary by the typed request functions (static statements,
+// add_execute(statement, values...) and add_execute_batch), the value is not copied
+// into the request. It is written to the socket directly from the user buffer instead.
+// Other request functions copy it, like any other std::span<const std::byte>.
+// The buffer must remain valid until the request has been written.
+struct borrowed_bytes
+{
+    std::span<const std::byte> value;
+
+    operator std::span<const std::byte>() const noexcept { return value; }
+};
+
+// Like borrowed_bytes, but for text parameters. Text values use the same representation
+// in text and binary, so they are never copied by the typed request functions
+struct borrowed_text
+{
+    std::string_view value;
+
+    operator std::string_view() const noexcept { return value; }
+};
+
 namespace detail {
 
 // There might be some duplication with types/ here.
@@ -42,6 +69,11 @@ struct supports_binary<T> : std::true_type
 {
 };
 
+template <std::convertible_to<std::span<const std::byte>> T>
+struct supports_binary<T> : std::true_type
+{
+};
+
 // Serialization functions.
 // TODO: remove bool, char and charXY_t from this
 template <std::integral T>
@@ -73,6 +105,52 @@ inline void serialize_binary(std::string_view value, std::vector<unsigned char>&
     to.insert(to.end(), value.begin(), value.end());
 }
 
+inline void serialize_text(std::span<const std::byte> value, std::vector<unsigned char>& to)
+{
+    // bytea text format is \x followed by hex pairs. Size the buffer once and encode in bulk
+    auto offset = to.size();
+    to.resize(offset + 2u + value.size() * 2u);
+    to[offset] = '\\';
+    to[offset + 1] = 'x';
+    hex_encode(
+        {reinterpret_cast<const unsigned char*>(value.data()), value.size()},
+        reinterpret_cast<char*>(to.data() + offset + 2u)
+    );
+}
+
+inline void serialize_binary(std::span<const std::byte> value, std::vector<unsigned char>& to)
+{
+    const auto* data = reinterpret_cast<const unsigned char*>(value.data());
+    to.insert(to.end(), data, data + value.size());
+}
+
+// An estimate of the number of bytes that serializing a value will add to a request,
+// used to reserve buffer space. Exact except for text integers, where it's an upper bound
+template <std::integral T>
+constexpr std::size_t serialized_size_hint(const T&, bool binary) noexcept
+{
+    return binary ? sizeof(T) : static_cast<std::size_t>(std::numeric_limits<T>::digits10) + 2u;
+}
+
+inline std::size_t serialized_size_hint(std::string_view value, bool) noexcept { return value.size(); }
+
+inline std::size_t serialized_size_hint(std::span<const std::byte> value, bool binary) noexcept
+{
+    return binary ? value.size() : 2u + value.size() * 2u;
+}
+
+// Borrowed values are only copied when sent as text bytea
+inline std::size_t serialized_size_hint(borrowed_bytes value, bool binary) noexcept
+{
+    return binary ? 0u : 2u + value.value.size() * 2u;
+}
+
+inline std::size_t serialized_size_hint(borrowed_text, bool) noexcept { return 0u; }
+
+// Is this a type whose value can be referenced by a request, rather than copied?
+template <class T>
+inline constexpr bool is_borrowed_v = std::is_same_v<T, borrowed_bytes> || std::is_same_v<T, borrowed_text>;
+
 // Type OIDs when doing serialization
 // clang-format off
 template <class T> struct parameter_type_oid;
@@ -80,6 +158,7 @@ template <> struct parameter_type_oid<std::int16_t> { static inline constexpr st
 template <> struct parameter_type_oid<std::int32_t> { static inline constexpr std::int32_t value = 23; };
 template <> struct parameter_type_oid<std::int64_t> { static inline constexpr std::int32_t value = 20; };
 template <std::convertible_to<std::string_view> T> struct parameter_type_oid<T> { static inline constexpr std::int32_t value = 25; };
+template <std::convertible_to<std::span<const std::byte>> T> struct parameter_type_oid<T> { static inline constexpr std::int32_t value = 17; };
 // clang-format on
 
 // Access private functions in parameter_ref
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "nativepg/extended_error.hpp"
+#include "nativepg/protocol/data_row.hpp"
 #include "nativepg/protocol/detail/read_buffer.hpp"
 
 namespace nativepg::protocol {
@@ -24,6 +25,9 @@ struct connection_state
     // Read buffer. TODO: make this configurable
     detail::read_buffer read_buffer{4096};
 
+    // Scratch space to deliver runs of DataRows in a single batch. Reused to avoid allocations
+    std::vector<data_row> row_batch;
+
     // The ID of the process that is managing our connection (aka connection ID)
     std::uint32_t backend_process_id{};
 
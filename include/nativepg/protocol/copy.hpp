@@ -46,7 +46,7 @@ inline boost::system::error_code parse(boost::span<const unsigned char> data, co
 // The body is a chunk of user-supplied data that might be large, and is likely
 // better sent using scatter/gather I/O.
 // Use serialize_header with this message type byte
-inline constexpr std::uint8_t copy_data_message_type = static_cast<std::uint8_t>('c');
+inline constexpr std::uint8_t copy_data_message_type = static_cast<std::uint8_t>('d');
 
 struct copy_done
 {
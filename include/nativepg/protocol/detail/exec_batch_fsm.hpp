@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_PROTOCOL_DETAIL_EXEC_BATCH_FSM_HPP
+#define NATIVEPG_PROTOCOL_DETAIL_EXEC_BATCH_FSM_HPP
+
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "nativepg/exec_item.hpp"
+#include "nativepg/protocol/connection_state.hpp"
+#include "nativepg/protocol/read_response_fsm.hpp"
+#include "nativepg/protocol/startup_fsm.hpp"
+
+namespace nativepg::protocol::detail {
+
+// Executes several requests with a single write, then reads their responses in order.
+// Every valid request ends with a Sync (or is a simple query), so errors in one request
+// don't affect the others. Requests that fail the initial checks are not sent,
+// and get the error in their result. The error returned by resume
+// is only set for errors that affect the entire batch (e.g. network errors)
+class exec_batch_fsm
+{
+public:
+    using result_type = startup_fsm::result_type;
+    using result = startup_fsm::result;
+
+    exec_batch_fsm(std::span<exec_item> items) noexcept : items_(items) {}
+
+    result resume(connection_state& st, boost::system::error_code ec, std::size_t bytes_transferred);
+
+    // When the FSM asks for a write, the payloads of the requests that passed the checks
+    // should be written, in order. This invokes fn for every chunk to write
+    template <class Fn>
+    void for_each_chunk(Fn&& fn) const
+    {
+        for (const auto& item : items_)
+        {
+            if (!item.result.code)
+                item.req->for_each_chunk(fn);
+        }
+    }
+
+private:
+    int resume_point_{0};
+    std::span<exec_item> items_;
+    std::size_t current_{};
+    std::optional<read_response_fsm> read_fsm_;
+
+    boost::system::error_code fail_pending(boost::system::error_code ec);
+};
+
+}  // namespace nativepg::protocol::detail
+
+#endif
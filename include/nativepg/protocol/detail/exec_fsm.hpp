@@ -21,7 +21,15 @@
 
 namespace nativepg::protocol::detail {
 
-// TODO: test
+// Requests bigger than this are written concurrently with reading their response (full-duplex).
+// Otherwise, the server's responses could fill the socket buffers while we're still writing,
+// and both sides would stall. When doing this, the caller reads whatever the server sends into
+// the connection's read buffer while writing, without resuming the FSM. Once the write has finished,
+// the FSM is resumed with its outcome, and parses what was read. If reading fails before the write
+// finishes, the write is cut short, the connection must be closed, and the FSM is resumed
+// with the read error.
+inline constexpr std::size_t full_duplex_threshold = 64u * 1024u;
+
 class exec_fsm
 {
 public:
@@ -33,6 +41,17 @@ public:
 
     result resume(connection_state& st, boost::system::error_code ec, std::size_t bytes_transferred);
 
+    const request& get_request() const { return read_fsm_.get_request(); }
+
+    // When the FSM asks for a write, the request's chunks should be written, in order.
+    // This invokes fn for every chunk to write. The write result carries no data, since borrowed
+    // parameter values (see borrowed_bytes) are not part of the request's payload
+    template <class Fn>
+    void for_each_chunk(Fn&& fn) const
+    {
+        read_fsm_.get_request().for_each_chunk(fn);
+    }
+
     extended_error get_result(boost::system::error_code ec) const
     {
         return ec ? extended_error{ec, {}} : read_fsm_.get_handler().result();
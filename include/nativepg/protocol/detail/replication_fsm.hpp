@@ -0,0 +1,153 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_PROTOCOL_DETAIL_REPLICATION_FSM_HPP
+#define NATIVEPG_PROTOCOL_DETAIL_REPLICATION_FSM_HPP
+
+#include <boost/assert.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "nativepg/protocol/any_backend_message.hpp"
+#include "nativepg/protocol/connection_state.hpp"
+#include "nativepg/protocol/replication.hpp"
+#include "nativepg/replication_params.hpp"
+
+namespace nativepg::protocol::detail {
+
+// Composes the START_REPLICATION command for a logical replication slot
+std::string compose_start_replication(const logical_replication_params& params);
+
+// Runs START_REPLICATION and the CopyBoth streaming loop that follows it.
+// XLogData messages are delivered in batches, one per read. Keepalives are handled internally.
+// Standby status updates are batched: they are sent when status_interval elapses or the server
+// requests a reply. The caller passes the current time on each resume and, while reading,
+// should resume the FSM with no error and no bytes when next_status_time() is reached.
+class replication_fsm
+{
+public:
+    enum class result_type
+    {
+        write,
+        read,
+        started,  // the server has entered CopyBoth mode
+        data,     // a batch of XLogData messages is available
+        done,
+    };
+
+    class result
+    {
+        result_type type_;
+        union
+        {
+            boost::system::error_code ec_;
+            std::span<unsigned char> buff_;
+            std::span<const xlog_data> data_;
+        };
+
+        result(result_type t, std::span<unsigned char> buff) noexcept : type_(t), buff_(buff) {}
+        result(std::span<const xlog_data> data) noexcept : type_(result_type::data), data_(data) {}
+
+    public:
+        result(boost::system::error_code ec) noexcept : type_(result_type::done), ec_(ec) {}
+        result(result_type t) noexcept : type_(t), ec_() {}
+
+        static result read(std::span<unsigned char> buff) { return {result_type::read, buff}; }
+        static result write(std::span<const unsigned char> buff)
+        {
+            return {
+                result_type::write,
+                {const_cast<unsigned char*>(buff.data()), buff.size()}
+            };
+        }
+        static result data(std::span<const xlog_data> value) { return {value}; }
+
+        result_type type() const { return type_; }
+
+        boost::system::error_code error() const
+        {
+            BOOST_ASSERT(type_ == result_type::done);
+            return ec_;
+        }
+        std::span<const unsigned char> write_data() const
+        {
+            BOOST_ASSERT(type_ == result_type::write);
+            return buff_;
+        }
+        std::span<unsigned char> read_buffer() const
+        {
+            BOOST_ASSERT(type_ == result_type::read);
+            return buff_;
+        }
+
+        // Point into the connection's read buffer. Valid until the FSM is resumed
+        std::span<const xlog_data> xlog_messages() const
+        {
+            BOOST_ASSERT(type_ == result_type::data);
+            return data_;
+        }
+    };
+
+    explicit replication_fsm(const logical_replication_params& params)
+        : start_query_(compose_start_replication(params)), status_interval_(params.status_interval)
+    {
+    }
+
+    result resume(
+        connection_state& st,
+        boost::system::error_code ec,
+        std::size_t bytes_transferred,
+        std::chrono::steady_clock::time_point now
+    );
+
+    // Records that all changes up to lsn have been durably processed, so the server may discard them.
+    // Reported on the next status update
+    void confirm(lsn_t lsn) noexcept { flushed_lsn_ = (std::max)(flushed_lsn_, lsn); }
+
+    // Ends the stream, sending CopyDone at the next opportunity.
+    // Messages that were already in flight are still delivered
+    void request_stop() noexcept { stop_requested_ = true; }
+
+    // When the next periodic status update is due
+    std::chrono::steady_clock::time_point next_status_time() const noexcept { return next_status_; }
+
+    // The position of the last WAL byte received + 1
+    lsn_t received_lsn() const noexcept { return received_lsn_; }
+    lsn_t flushed_lsn() const noexcept { return flushed_lsn_; }
+
+private:
+    int resume_point_{0};
+    std::string start_query_;
+    std::chrono::steady_clock::duration status_interval_;
+    std::chrono::steady_clock::time_point next_status_{};
+    std::size_t consumed_{};
+    std::size_t needed_bytes_{};
+    std::vector<xlog_data> batch_;
+    boost::system::error_code err_;  // server error that will end the operation
+    lsn_t received_lsn_{};
+    lsn_t flushed_lsn_{};
+    bool copy_both_{};           // CopyBothResponse received
+    bool server_copy_done_{};    // server sent CopyDone
+    bool client_copy_done_{};    // we sent CopyDone
+    bool reply_requested_{};     // server asked for a status update
+    bool stop_requested_{};
+    bool finished_{};            // ReadyForQuery received
+
+    boost::system::error_code on_message(connection_state& st, const any_backend_message& msg);
+    bool status_due(std::chrono::steady_clock::time_point now) const noexcept;
+    boost::system::error_code compose_status(connection_state& st, std::chrono::steady_clock::time_point now);
+};
+
+}  // namespace nativepg::protocol::detail
+
+#endif
@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_PROTOCOL_PGOUTPUT_HPP
+#define NATIVEPG_PROTOCOL_PGOUTPUT_HPP
+
+#include <boost/core/span.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/variant2/variant.hpp>
+
+#include <cstdint>
+#include <string_view>
+
+#include "nativepg/field_view.hpp"
+#include "nativepg/protocol/describe.hpp"
+#include "nativepg/protocol/replication.hpp"
+#include "nativepg/protocol/views.hpp"
+
+namespace nativepg {
+namespace protocol {
+
+// Messages sent by the pgoutput logical decoding plugin, contained in XLogData messages.
+// Like other protocol messages, these are views into the received data.
+// Only protocol version 1 is supported (the streaming plugin option must be off).
+namespace pgoutput {
+
+// How a column's value is sent in a TupleData
+enum class tuple_column_kind : unsigned char
+{
+    null = 'n',
+    unchanged_toast = 'u',  // a TOASTed value that didn't change. The actual value is not sent
+    text = 't',
+    binary = 'b',
+};
+
+struct tuple_column
+{
+    tuple_column_kind kind;
+
+    // The serialized value. NULL if kind is null or unchanged_toast
+    field_view value;
+};
+
+}  // namespace pgoutput
+
+namespace detail {
+
+template <>
+struct forward_traits<pgoutput::tuple_column>
+{
+    static pgoutput::tuple_column dereference(const unsigned char* data);
+    static const unsigned char* advance(const unsigned char* data);
+};
+
+}  // namespace detail
+
+namespace pgoutput {
+
+struct tuple_data
+{
+    // A tuple_column per column in the relation, in the order described by the Relation message
+    forward_parsing_view<tuple_column> columns;
+};
+
+struct begin_message
+{
+    // The final LSN of the transaction
+    lsn_t final_lsn;
+
+    // Commit timestamp of the transaction
+    std::int64_t commit_time;
+
+    // Transaction ID
+    std::int32_t xid;
+};
+
+struct commit_message
+{
+    // Currently unused
+    std::int8_t flags;
+
+    // The LSN of the commit
+    lsn_t commit_lsn;
+
+    // The end LSN of the transaction
+    lsn_t end_lsn;
+
+    // Commit timestamp of the transaction
+    std::int64_t commit_time;
+};
+
+struct origin_message
+{
+    // The LSN of the commit on the origin server
+    lsn_t commit_lsn;
+
+    // Name of the origin
+    std::string_view name;
+};
+
+struct relation_column
+{
+    // 1 marks the column as part of the key
+    std::int8_t flags;
+
+    std::string_view name;
+
+    // The object ID of the column's data type
+    std::int32_t type_oid;
+
+    // The type modifier of the column (atttypmod)
+    std::int32_t type_modifier;
+
+    bool is_key() const noexcept { return (flags & 1) != 0; }
+};
+
+}  // namespace pgoutput
+
+namespace detail {
+
+template <>
+struct forward_traits<pgoutput::relation_column>
+{
+    static pgoutput::relation_column dereference(const unsigned char* data);
+    static const unsigned char* advance(const unsigned char* data);
+};
+
+}  // namespace detail
+
+namespace pgoutput {
+
+// Sent before the first change to a relation in a session, and whenever its definition changes
+struct relation_message
+{
+    std::int32_t oid;
+    std::string_view namespace_name;  // empty for pg_catalog
+    std::string_view relation_name;
+
+    // Replica identity setting for the relation (same as relreplident in pg_class)
+    std::int8_t replica_identity;
+
+    forward_parsing_view<relation_column> columns;
+};
+
+struct type_message
+{
+    std::int32_t oid;
+    std::string_view namespace_name;  // empty for pg_catalog
+    std::string_view name;
+};
+
+struct insert_message
+{
+    std::int32_t relation_oid;
+    tuple_data new_tuple;
+};
+
+// Describes what an old tuple contains, in updates and deletes
+enum class old_tuple_kind : unsigned char
+{
+    none = 0,   // no old tuple was sent
+    key = 'K',  // only the columns of the replica identity index
+    old = 'O',  // the entire row (REPLICA IDENTITY FULL)
+};
+
+struct update_message
+{
+    std::int32_t relation_oid;
+    old_tuple_kind old_kind;
+    tuple_data old_tuple;  // empty if old_kind is none
+    tuple_data new_tuple;
+};
+
+struct delete_message
+{
+    std::int32_t relation_oid;
+    old_tuple_kind old_kind;  // never none
+    tuple_data old_tuple;
+};
+
+struct truncate_message
+{
+    // 1 for CASCADE, 2 for RESTART IDENTITY
+    std::int8_t options;
+    random_access_parsing_view<std::int32_t> relation_oids;
+};
+
+// A message emitted by pg_logical_emit_message. Only sent if the messages plugin option is on
+struct logical_message
+{
+    // 1 if the message is transactional
+    std::int8_t flags;
+    lsn_t lsn;
+    std::string_view prefix;
+    boost::span<const unsigned char> content;
+};
+
+// data contains the entire message, including the message type byte
+boost::system::error_code parse(boost::span<const unsigned char> data, begin_message& to);
+boost::system::error_code parse(boost::span<const unsigned char> data, commit_message& to);
+boost::system::error_code parse(boost::span<const unsigned char> data, origin_message& to);
+boost::system::error_code parse(boost::span<const unsigned char> data, relation_message& to);
+boost::system::error_code parse(boost::span<const unsigned char> data, type_message& to);
+boost::system::error_code parse(boost::span<const unsigned char> data, insert_message& to);
+boost::system::error_code parse(boost::span<const unsigned char> data, update_message& to);
+boost::system::error_code parse(boost::span<const unsigned char> data, delete_message& to);
+boost::system::error_code parse(boost::span<const unsigned char> data, truncate_message& to);
+boost::system::error_code parse(boost::span<const unsigned char> data, logical_message& to);
+
+using any_message = boost::variant2::variant<
+    begin_message,
+    commit_message,
+    origin_message,
+    relation_message,
+    type_message,
+    insert_message,
+    update_message,
+    delete_message,
+    truncate_message,
+    logical_message>;
+
+// Parses any of the above, identified by its first byte. Usually, data is xlog_data::data
+boost::system::error_code parse(boost::span<const unsigned char> data, any_message& to);
+
+}  // namespace pgoutput
+}  // namespace protocol
+}  // namespace nativepg
+
+#endif
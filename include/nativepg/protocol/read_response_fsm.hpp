@@ -15,6 +15,7 @@
 #include <span>
 
 #include "nativepg/protocol/any_backend_message.hpp"
+#include "nativepg/protocol/data_row.hpp"
 #include "nativepg/protocol/notice_error.hpp"
 #include "nativepg/request.hpp"
 #include "nativepg/response_handler.hpp"
@@ -55,6 +56,11 @@ public:
 
     result resume(const any_backend_message& msg);
 
+    // Are we in a state where DataRows are expected? If so, resume_rows may be used
+    // instead of resume to deliver a run of consecutive DataRows in a single call
+    bool accepts_rows() const;
+    result resume_rows(std::span<const data_row> rows);
+
 private:
     enum class state_t;
 
@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_PROTOCOL_REPLICATION_HPP
+#define NATIVEPG_PROTOCOL_REPLICATION_HPP
+
+#include <boost/core/span.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nativepg {
+namespace protocol {
+
+// Messages exchanged during streaming replication. These are sent as the contents
+// of CopyData messages, and are identified by their first byte.
+
+// A position in the write-ahead log
+using lsn_t = std::uint64_t;
+
+// Formats an LSN as expected by replication commands (e.g. 16/B374D848)
+std::string format_lsn(lsn_t value);
+
+// Timestamps are expressed as microseconds since 2000-01-01 (midnight, UTC)
+std::int64_t to_replication_timestamp(std::chrono::system_clock::time_point tp);
+
+// Returns the first byte of a CopyData message's contents, which identifies
+// the replication message. Returns 0 if empty.
+inline unsigned char replication_message_type(boost::span<const unsigned char> copy_data)
+{
+    return copy_data.empty() ? 0u : copy_data[0];
+}
+
+inline constexpr unsigned char xlog_data_message_type = static_cast<unsigned char>('w');
+inline constexpr unsigned char primary_keepalive_message_type = static_cast<unsigned char>('k');
+
+struct xlog_data
+{
+    // The starting point of the WAL data in this message
+    lsn_t wal_start;
+
+    // The current end of WAL on the server
+    lsn_t wal_end;
+
+    // The server's system clock at the time of transmission
+    std::int64_t send_time;
+
+    // A section of the WAL data stream. For logical replication, a message of the output plugin
+    boost::span<const unsigned char> data;
+};
+// data contains the entire CopyData contents, including the message type byte
+boost::system::error_code parse(boost::span<const unsigned char> data, xlog_data& to);
+
+struct primary_keepalive
+{
+    // The current end of WAL on the server
+    lsn_t wal_end;
+
+    // The server's system clock at the time of transmission
+    std::int64_t send_time;
+
+    // If true, the client should reply to this message as soon as possible, to avoid a timeout disconnect
+    bool reply_requested;
+};
+// data contains the entire CopyData contents, including the message type byte
+boost::system::error_code parse(boost::span<const unsigned char> data, primary_keepalive& to);
+
+struct standby_status_update
+{
+    // The location of the last WAL byte + 1 received and written to disk in the standby
+    lsn_t written_lsn;
+
+    // The location of the last WAL byte + 1 flushed to disk in the standby.
+    // For logical replication, the server may discard WAL before this position
+    lsn_t flushed_lsn;
+
+    // The location of the last WAL byte + 1 applied in the standby
+    lsn_t applied_lsn;
+
+    // The client's system clock at the time of transmission
+    std::int64_t send_time;
+
+    // If true, the server should reply to this message immediately
+    bool reply_requested;
+};
+// Serializes an entire CopyData message with the update
+boost::system::error_code serialize(const standby_status_update& msg, std::vector<unsigned char>& to);
+
+}  // namespace protocol
+}  // namespace nativepg
+
+#endif
@@ -98,6 +98,9 @@ public:
     // Is the range empty?
     bool empty() const { return size_ == 0u; }
 
+    // The serialized items, as received from the server
+    boost::span<const unsigned char> serialized() const { return data_; }
+
     // Range functions
     iterator begin() const { return iterator(data_.begin()); }
     iterator end() const { return iterator(data_.end()); }
@@ -224,6 +227,9 @@ public:
     // Is the range empty?
     bool empty() const { return size_ == 0u; }
 
+    // The serialized items, as received from the server
+    boost::span<const unsigned char> serialized() const { return {data_, size_ * sizeof(T)}; }
+
     T at(std::size_t i) const
     {
         detail::at_range_check(i, size_);
@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_RELATION_CACHE_HPP
+#define NATIVEPG_RELATION_CACHE_HPP
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "nativepg/detail/field_traits.hpp"
+#include "nativepg/detail/row_traits.hpp"
+#include "nativepg/protocol/describe.hpp"
+#include "nativepg/protocol/pgoutput.hpp"
+#include "nativepg/response.hpp"
+
+namespace nativepg {
+
+struct relation_column_info
+{
+    std::string name;
+    std::int32_t type_oid{};
+    std::int32_t type_modifier{};
+    bool is_key{};
+};
+
+// The definition of a relation, as sent by pgoutput in a Relation message
+struct relation_info
+{
+    std::int32_t oid{};
+    std::string namespace_name;
+    std::string relation_name;
+    std::int8_t replica_identity{};
+    std::vector<relation_column_info> columns;
+
+    // Changes every time the relation is (re)defined
+    std::uint64_t version{};
+};
+
+// Maps relation OIDs to their definitions, so changes (which only contain the relation OID)
+// can be interpreted. The server sends a Relation message before the first change to a relation
+// in a replication session, and whenever its definition changes. A cache should thus be used
+// for a single replication session.
+// Relations are only allocated when defined, so decoding changes doesn't allocate.
+class relation_cache
+{
+    std::unordered_map<std::int32_t, relation_info> relations_;
+    std::uint64_t next_version_{1u};
+
+public:
+    relation_cache() = default;
+
+    // Stores or replaces a relation's definition
+    const relation_info& store(const protocol::pgoutput::relation_message& msg);
+
+    // Calls store() for Relation messages. Other messages are ignored
+    void on_message(const protocol::pgoutput::any_message& msg);
+
+    // Returns nullptr if the relation hasn't been defined
+    const relation_info* find(std::int32_t oid) const;
+
+    std::size_t size() const noexcept { return relations_.size(); }
+
+    void clear() noexcept { relations_.clear(); }
+};
+
+namespace detail {
+
+// Like compute_pos_map, but for relations defined by pgoutput
+boost::system::error_code compute_relation_pos_map(
+    const relation_info& rel,
+    std::span<const std::string_view> name_table,
+    std::span<pos_map_entry> output
+);
+
+}  // namespace detail
+
+// Parses pgoutput tuples into a Boost.Describe'd struct, matching members to columns by name.
+// Fields are parsed as in resultset_callback: each member must have a matching column
+// with a compatible type. The mapping is computed the first time a relation is seen and
+// reused while its definition doesn't change, so decoding a tuple doesn't allocate.
+// Members for unchanged TOAST values are left untouched.
+template <class T>
+class tuple_decoder
+{
+    const relation_info* rel_{};
+    std::uint64_t version_{};
+    boost::system::error_code setup_ec_;
+    std::array<detail::pos_map_entry, detail::row_size_v<T>> pos_map_;
+    std::vector<protocol::pgoutput::tuple_column> columns_;
+
+    void setup(const relation_info& rel)
+    {
+        rel_ = &rel;
+        version_ = rel.version;
+
+        // Compute the relation => C++ map
+        setup_ec_ = detail::compute_relation_pos_map(rel, detail::row_name_table_v<T>, pos_map_);
+        if (setup_ec_)
+            return;
+
+        // Metadata check
+        using type_identities = boost::mp11::mp_transform<std::type_identity, detail::row_field_types_t<T>>;
+        std::size_t idx = 0u;
+        boost::mp11::mp_for_each<type_identities>([&idx, this](auto type_identity) {
+            using FieldType = typename decltype(type_identity)::type;
+            auto ec = detail::field_is_compatible<FieldType>::call(pos_map_[idx++].descr);
+            if (!setup_ec_)
+                setup_ec_ = ec;
+        });
+    }
+
+public:
+    tuple_decoder() = default;
+
+    // tuple must belong to rel, which must be alive and not modified during the call
+    boost::system::error_code decode(
+        const relation_info& rel,
+        const protocol::pgoutput::tuple_data& tuple,
+        T& to
+    )
+    {
+        if (&rel != rel_ || rel.version != version_)
+            setup(rel);
+        if (setup_ec_)
+            return setup_ec_;
+
+        // Copy the columns to a random access collection. Storage is reused between calls
+        columns_.assign(tuple.columns.begin(), tuple.columns.end());
+        if (columns_.size() != rel.columns.size())
+            return client_errc::protocol_value_error;
+
+        boost::system::error_code ec;
+        std::size_t idx = 0u;
+        detail::for_each_member(to, [&ec, &idx, this](auto& member) {
+            using FieldType = std::decay_t<decltype(member)>;
+            const detail::pos_map_entry& ent = pos_map_[idx++];
+            const auto& col = columns_[ent.db_index];
+            if (col.kind == protocol::pgoutput::tuple_column_kind::unchanged_toast)
+                return;
+            auto descr = ent.descr;
+            if (col.kind == protocol::pgoutput::tuple_column_kind::binary)
+                descr.fmt_code = protocol::format_code::binary;
+            auto ec2 = detail::field_parse<FieldType>::call(col.value, descr, member);
+            if (!ec)
+                ec = ec2;
+        });
+        return ec;
+    }
+};
+
+}  // namespace nativepg
+
+#endif
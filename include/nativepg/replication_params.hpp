@@ -0,0 +1,41 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_REPLICATION_PARAMS_HPP
+#define NATIVEPG_REPLICATION_PARAMS_HPP
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nativepg/protocol/replication.hpp"
+
+namespace nativepg {
+
+// Configuration to stream changes from a logical replication slot
+struct logical_replication_params
+{
+    // The replication slot to stream from. Must have been created beforehand
+    std::string slot_name;
+
+    // Where to start streaming. Zero means the slot's confirmed position
+    protocol::lsn_t start_lsn{};
+
+    // Options passed to the output plugin, as (name, value) pairs.
+    // For pgoutput: {"proto_version", "1"}, {"publication_names", "mypub"}
+    std::vector<std::pair<std::string, std::string>> plugin_options;
+
+    // How often to send standby status updates to the server. Updates are batched:
+    // they are sent when this interval elapses or the server requests a reply, never per message.
+    // Must be lower than the server's wal_sender_timeout
+    std::chrono::steady_clock::duration status_interval{std::chrono::seconds(10)};
+};
+
+}  // namespace nativepg
+
+#endif
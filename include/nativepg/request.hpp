@@ -9,21 +9,31 @@
 #define NATIVEPG_REQUEST_HPP
 
 #include <boost/core/span.hpp>
+#include <boost/endian/conversion.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/system/system_error.hpp>
 #include <boost/throw_exception.hpp>
 
+#include <algorithm>
 #include <array>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
+#include <limits>
+#include <ranges>
 #include <span>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "nativepg/client_errc.hpp"
 #include "nativepg/parameter_ref.hpp"
 #include "nativepg/protocol/close.hpp"
 #include "nativepg/protocol/flush.hpp"
+#include "nativepg/static_statement.hpp"
 #include "protocol/bind.hpp"
 #include "protocol/common.hpp"
 #include "protocol/describe.hpp"
@@ -46,6 +56,93 @@ enum class request_message_type
     sync,
 };
 
+namespace detail {
+
+// Serializes a Bind parameter, preceded by its length, without type erasure
+template <class T>
+boost::system::error_code serialize_bind_parameter(
+    const T& value,
+    protocol::format_code fmt,
+    std::vector<unsigned char>& to
+)
+{
+    const std::size_t offset = to.size();
+    to.resize(offset + 4u);
+    if constexpr (supports_binary<T>::value)
+    {
+        if (fmt == protocol::format_code::binary)
+            serialize_binary(value, to);
+        else
+            serialize_text(value, to);
+    }
+    else
+    {
+        serialize_text(value, to);
+    }
+    const std::size_t size = to.size() - offset - 4u;
+    if (size > static_cast<std::size_t>((std::numeric_limits<std::int32_t>::max)()))
+        return client_errc::value_too_big;
+    boost::endian::store_big_s32(to.data() + offset, static_cast<std::int32_t>(size));
+    return {};
+}
+
+// Serializes the Bind message header, portal name, statement name, parameter format codes
+// and number of parameters. Like make_static_bind_prefix, but for statement names known at runtime.
+// The message length is left as zero
+inline void serialize_bind_prefix(
+    std::string_view statement_name,
+    protocol::format_code fmt,
+    std::int16_t num_params,
+    std::vector<unsigned char>& to
+)
+{
+    to.push_back('B');
+    to.insert(to.end(), {0x00, 0x00, 0x00, 0x00});
+    to.push_back(0x00);  // unnamed portal
+    to.insert(to.end(), statement_name.begin(), statement_name.end());
+    to.push_back(0x00);
+    if (fmt == protocol::format_code::text)
+        to.insert(to.end(), {0x00, 0x00});  // all parameters use text
+    else
+        to.insert(to.end(), {0x00, 0x01, 0x00, static_cast<unsigned char>(fmt)});  // all parameters use fmt
+    const auto num_params_offset = to.size();
+    to.resize(num_params_offset + 2u);
+    boost::endian::store_big_s16(to.data() + num_params_offset, num_params);
+}
+
+// A parameter value referenced by a request, rather than copied into its payload
+struct borrowed_value
+{
+    // Position in the payload where the value should be inserted
+    std::size_t offset;
+
+    // The value itself
+    std::span<const unsigned char> data;
+};
+
+// Invokes fn for each contiguous chunk of bytes in payload, with the borrowed values
+// inserted at their offsets. Borrowed values must be sorted by offset
+template <class Fn>
+void for_each_chunk(std::span<const unsigned char> payload, std::span<const borrowed_value> borrowed, Fn&& fn)
+{
+    std::size_t offset = 0u;
+    for (const auto& value : borrowed)
+    {
+        if (value.offset > offset)
+            fn(payload.subspan(offset, value.offset - offset));
+        if (!value.data.empty())
+            fn(value.data);
+        offset = value.offset;
+    }
+    if (offset < payload.size())
+        fn(payload.subspan(offset));
+}
+
+// Access private members in request
+struct request_access;
+
+}  // namespace detail
+
 template <std::size_t N>
 struct bound_statement
 {
@@ -61,12 +158,15 @@ struct statement
     bound_statement<sizeof...(Params)> bind(const Params&... values) { return {name, {values...}}; }
 };
 
-// TODO: a clear method is missing
 class request
 {
     std::vector<unsigned char> buffer_;
     std::vector<request_message_type> types_;
+    std::vector<detail::borrowed_value> borrowed_;
     bool autosync_;
+    bool idempotent_read_{};
+
+    friend struct detail::request_access;
 
     void check(boost::system::error_code ec)
     {
@@ -91,6 +191,116 @@ class request
             add(protocol::sync{});
     }
 
+    // Adds a message that has already been serialized
+    request& add_serialized(std::span<const unsigned char> msg, request_message_type type)
+    {
+        types_.reserve(types_.size() + 1u);  // strong guarantee
+        buffer_.insert(buffer_.end(), msg.begin(), msg.end());
+        types_.push_back(type);
+        return *this;
+    }
+
+    // Describe and Execute messages for the unnamed portal, with no row limit
+    static constexpr unsigned char describe_portal_msg[] = {'D', 0x00, 0x00, 0x00, 0x06, 'P', 0x00};
+    static constexpr unsigned char execute_msg[] = {
+        'E', 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    // Reserves space for at least size more bytes, keeping geometric growth
+    void reserve_payload(std::size_t size)
+    {
+        const std::size_t required = buffer_.size() + size;
+        if (required > buffer_.capacity())
+            buffer_.reserve((std::max)(required, 2u * buffer_.capacity()));
+    }
+
+    // Serializes a Bind parameter as T. Borrowed values are recorded rather than copied,
+    // unless they need to be transformed (e.g. to hex)
+    template <class T, class U>
+    boost::system::error_code add_typed_parameter(const U& value, protocol::format_code fmt)
+    {
+        if constexpr (detail::is_borrowed_v<T>)
+        {
+            const T& borrowed = value;
+            if (std::is_same_v<T, borrowed_text> || fmt == protocol::format_code::binary)
+            {
+                const auto data = std::as_bytes(std::span(borrowed.value));
+                if (data.size() > static_cast<std::size_t>((std::numeric_limits<std::int32_t>::max)()))
+                    return client_errc::value_too_big;
+                const std::size_t offset = buffer_.size();
+                buffer_.resize(offset + 4u);
+                boost::endian::store_big_s32(buffer_.data() + offset, static_cast<std::int32_t>(data.size()));
+                borrowed_.push_back(
+                    {offset + 4u, {reinterpret_cast<const unsigned char*>(data.data()), data.size()}}
+                );
+                return {};
+            }
+        }
+        return detail::serialize_bind_parameter<T>(value, fmt, buffer_);
+    }
+
+    // Completes a Bind message whose prefix (see detail::make_static_bind_prefix) has been written
+    // at offset, given a tuple with the parameter values, which are serialized as Params
+    // without type erasure. On error, the buffer is restored to offset
+    template <class... Params, class Tuple>
+    boost::system::error_code finish_typed_bind(
+        std::size_t offset,
+        const Tuple& values,
+        protocol::format_code fmt,
+        protocol::format_code result_codes
+    )
+    {
+        types_.reserve(types_.size() + 1u);  // strong guarantee
+        const std::size_t first_borrowed = borrowed_.size();
+
+        // Parameters
+        boost::system::error_code ec;
+        std::apply(
+            [&](const auto&... vals) { ((ec = ec ? ec : add_typed_parameter<Params>(vals, fmt)), ...); },
+            values
+        );
+
+        // Result format codes
+        if (result_codes == protocol::format_code::text)
+        {
+            buffer_.insert(buffer_.end(), {0x00, 0x00});
+        }
+        else
+        {
+            buffer_.insert(buffer_.end(), {0x00, 0x01, 0x00, static_cast<unsigned char>(result_codes)});
+        }
+
+        // Message length, including any borrowed values
+        std::size_t size = buffer_.size() - offset - 1u;
+        for (std::size_t i = first_borrowed; i < borrowed_.size(); ++i)
+            size += borrowed_[i].data.size();
+        if (!ec && size > static_cast<std::size_t>((std::numeric_limits<std::int32_t>::max)()))
+            ec = client_errc::value_too_big;
+        if (ec)
+        {
+            buffer_.resize(offset);
+            borrowed_.resize(first_borrowed);
+            return ec;
+        }
+        boost::endian::store_big_s32(buffer_.data() + offset + 1u, static_cast<std::int32_t>(size));
+        types_.push_back(request_message_type::bind);
+        return {};
+    }
+
+    // Adds a Bind message given its serialized prefix and the parameter values. See finish_typed_bind
+    template <class... Params, class Tuple>
+    boost::system::error_code add_typed_bind(
+        std::span<const unsigned char> prefix,
+        const Tuple& values,
+        protocol::format_code fmt,
+        protocol::format_code result_codes
+    )
+    {
+        const std::size_t offset = buffer_.size();
+        buffer_.insert(buffer_.end(), prefix.begin(), prefix.end());
+        return finish_typed_bind<Params...>(offset, values, fmt, result_codes);
+    }
+
 public:
     enum class param_format
     {
@@ -107,10 +317,38 @@ public:
     bool autosync() const { return autosync_; }
     void set_autosync(bool value) { autosync_ = value; }
 
-    // Returns the serialized payload
+    // Marks the request as idempotent and read-only: running it once or many times
+    // at the same moment yields the same results and has no side effects.
+    // co_multiplexed_connection may then share its execution with identical concurrent
+    // requests (see multiplexed_config::deduplicate_reads)
+    bool idempotent_read() const { return idempotent_read_; }
+    void set_idempotent_read(bool value) { idempotent_read_ = value; }
+
+    // Returns the serialized payload. If the request contains borrowed
+    // parameter values, these are not part of the payload. Use for_each_chunk to get them
     std::span<const unsigned char> payload() const { return buffer_; }
     std::span<const request_message_type> messages() const { return types_; }
 
+    // Does the request reference any borrowed parameter value (see borrowed_bytes)?
+    bool has_borrowed_values() const noexcept { return !borrowed_.empty(); }
+
+    // Invokes fn(std::span<const unsigned char>) for each contiguous chunk of bytes
+    // that must be written to send the request, in order. The chunks alternate between
+    // the payload and the borrowed parameter values. Suitable to build gather lists
+    template <class Fn>
+    void for_each_chunk(Fn&& fn) const
+    {
+        detail::for_each_chunk(buffer_, borrowed_, fn);
+    }
+
+    // Removes all messages, keeping the allocated memory, so the request can be reused
+    void clear() noexcept
+    {
+        buffer_.clear();
+        types_.clear();
+        borrowed_.clear();
+    }
+
     // Adds a simple query (PQsendQuery)
     request& add_simple_query(std::string_view q) { return add(protocol::query{q}); }
 
@@ -158,6 +396,15 @@ public:
         return add_prepare(query, stmt.name, type_oids);
     }
 
+    // Prepares a statement whose Parse message was serialized at compile time (PQsendPrepare)
+    template <fixed_string Name, fixed_string Query, class... Params>
+    request& add_prepare(const static_statement<Name, Query, Params...>&)
+    {
+        add_serialized(static_statement<Name, Query, Params...>::parse_message, request_message_type::parse);
+        maybe_add_sync();
+        return *this;
+    }
+
     // Executes a named prepared statement (PQsendQueryPrepared)
     // Parameter format defaults to text because binary requires sending
     // type OIDs in prepare, and we're not sure if the user did it
@@ -198,6 +445,178 @@ public:
         return add_execute(stmt.name, stmt.params, fmt, result_codes, max_num_rows);
     }
 
+    // Executes a named prepared statement with the given values (PQsendQueryPrepared).
+    // Parameter types are known at compile time, so space for all the messages is reserved once,
+    // and parameters are serialized without type erasure.
+    // Parameters are sent in binary if all of them support it, and in text otherwise.
+    template <class... Params>
+    request& add_execute(const statement<Params...>& stmt, const std::type_identity_t<Params>&... values)
+    {
+        static_assert(
+            sizeof...(Params) <= static_cast<std::size_t>((std::numeric_limits<std::int16_t>::max)())
+        );
+        constexpr bool all_binary = (detail::supports_binary<Params>::value && ...);
+        constexpr auto fmt = all_binary ? protocol::format_code::binary : protocol::format_code::text;
+
+        // Bind (header, names, format codes, parameters and result format codes), Describe, Execute and Sync
+        const std::size_t params_size = (0u + ... + (4u + detail::serialized_size_hint(values, all_binary)));
+        const std::size_t bind_size = 1u + 4u + 1u + stmt.name.size() + 1u + (all_binary ? 4u : 2u) + 2u +
+                                      params_size + 2u;
+        reserve_payload(bind_size + sizeof(describe_portal_msg) + sizeof(execute_msg) + 5u);
+        types_.reserve(types_.size() + 4u);
+
+        const std::size_t offset = buffer_.size();
+        detail::serialize_bind_prefix(stmt.name, fmt, sizeof...(Params), buffer_);
+        check(finish_typed_bind<Params...>(offset, std::tie(values...), fmt, protocol::format_code::text));
+        add_serialized(describe_portal_msg, request_message_type::describe);
+        add_serialized(execute_msg, request_message_type::execute);
+        maybe_add_sync();
+        return *this;
+    }
+
+    // Executes a statement prepared with add_prepare(static_statement) (PQsendQueryPrepared).
+    // The fixed part of the Bind message is copied from static storage, and parameters
+    // are serialized without type erasure
+    template <class Statement, class... Params>
+    request& add_execute(
+        const bound_static_statement<Statement, Params...>& stmt,
+        param_format fmt = param_format::select_best,
+        protocol::format_code result_codes = protocol::format_code::text,
+        std::int32_t max_num_rows = 0
+    )
+    {
+        const auto fmt_code = fmt == param_format::select_best && Statement::supports_binary
+                                  ? protocol::format_code::binary
+                                  : protocol::format_code::text;
+        const auto prefix = Statement::bind_prefix(fmt_code);
+        check(add_typed_bind<Params...>(prefix, stmt.params, fmt_code, result_codes));
+        add(protocol::describe{protocol::portal_or_statement::portal, {}});
+        add(protocol::execute{
+            .portal_name = {},
+            .max_num_rows = max_num_rows,
+        });
+        maybe_add_sync();
+        return *this;
+    }
+
+    // Executes a named prepared statement once for each element in rows (e.g. a std::vector or std::span),
+    // which must be tuple-like objects holding values convertible to Params.
+    // Adds a Bind and an Execute message per row and a single Sync at the end (if autosync is enabled).
+    // No Describe messages are sent, so the server doesn't send row metadata for each row.
+    // If any row fails, the server skips the remaining ones.
+    // Use check_execute_batch to handle the response.
+    template <class... Params, std::ranges::contiguous_range Rows>
+        requires std::ranges::sized_range<Rows>
+    request& add_execute_batch(
+        const statement<Params...>& stmt,
+        const Rows& rows_range,
+        param_format fmt = param_format::select_best,
+        protocol::format_code result_codes = protocol::format_code::text
+    )
+    {
+        using Row = std::ranges::range_value_t<Rows>;
+        const std::span<const Row> rows(std::ranges::data(rows_range), std::ranges::size(rows_range));
+
+        static_assert(std::tuple_size_v<Row> == sizeof...(Params), "Wrong number of values in row");
+        static_assert(
+            sizeof...(Params) <= static_cast<std::size_t>((std::numeric_limits<std::int16_t>::max)())
+        );
+
+        // Everything before the parameters is the same for all rows, so serialize it once
+        constexpr bool all_binary = (detail::supports_binary<Params>::value && ...);
+        const auto fmt_code = fmt == param_format::select_best && all_binary
+                                  ? protocol::format_code::binary
+                                  : protocol::format_code::text;
+        std::vector<unsigned char> prefix;
+        detail::serialize_bind_prefix(stmt.name, fmt_code, sizeof...(Params), prefix);
+
+        // Reserve space for all the messages
+        std::size_t size = rows.size() * (prefix.size() + 4u + sizeof(execute_msg)) + 5u;
+        for (const Row& row : rows)
+        {
+            size += std::apply(
+                [](const auto&... vals) {
+                    return (0u + ... + (4u + detail::serialized_size_hint(vals, all_binary)));
+                },
+                row
+            );
+        }
+        reserve_payload(size);
+        types_.reserve(types_.size() + 2u * rows.size() + 1u);
+
+        // If any row fails to serialize, the request is left unchanged
+        const std::size_t initial_size = buffer_.size();
+        const std::size_t initial_msgs = types_.size();
+        const std::size_t initial_borrowed = borrowed_.size();
+        for (const Row& row : rows)
+        {
+            auto ec = add_typed_bind<Params...>(prefix, row, fmt_code, result_codes);
+            if (ec)
+            {
+                buffer_.resize(initial_size);
+                types_.resize(initial_msgs);
+                borrowed_.resize(initial_borrowed);
+                check(ec);
+            }
+            add_serialized(execute_msg, request_message_type::execute);
+        }
+        maybe_add_sync();
+        return *this;
+    }
+
+    // Adds a transaction that runs in a single round-trip: BEGIN, the statements added by
+    // add_statements(request&), COMMIT and a Sync, followed by ROLLBACK and another Sync.
+    // Statements are not separated by syncs, so if any of them fails, the server skips the remaining
+    // ones and COMMIT, and ROLLBACK discards the partial work. If COMMIT succeeded,
+    // ROLLBACK has no effect (the server issues a warning). begin_statement may specify options,
+    // e.g. "BEGIN ISOLATION LEVEL SERIALIZABLE". Both syncs are added regardless of autosync.
+    // add_statements must use the extended protocol (e.g. add_query and add_execute) and must not add syncs.
+    // Otherwise, the request is left unchanged and client_errc::invalid_transaction is thrown.
+    // Use check_transaction to handle the response.
+    template <std::invocable<request&> Fn>
+    request& add_transaction(Fn&& add_statements, std::string_view begin_statement = "BEGIN")
+    {
+        // If anything fails, the request is left unchanged
+        const std::size_t initial_size = buffer_.size();
+        const std::size_t initial_msgs = types_.size();
+        const std::size_t initial_borrowed = borrowed_.size();
+        const bool initial_autosync = autosync_;
+        auto restore = [&] {
+            buffer_.resize(initial_size);
+            types_.resize(initial_msgs);
+            borrowed_.resize(initial_borrowed);
+            autosync_ = initial_autosync;
+        };
+
+        autosync_ = false;
+        try
+        {
+            add_query(begin_statement, {});
+            const std::size_t first_statement = types_.size();
+            std::forward<Fn>(add_statements)(*this);
+            const bool valid = std::ranges::none_of(
+                std::span(types_).subspan(first_statement),
+                [](request_message_type type) {
+                    return type == request_message_type::sync || type == request_message_type::query;
+                }
+            );
+            if (!valid)
+                check(client_errc::invalid_transaction);
+            add_query("COMMIT", {});
+            add(protocol::sync{});
+            add_query("ROLLBACK", {});
+            add(protocol::sync{});
+        }
+        catch (...)
+        {
+            restore();
+            throw;
+        }
+
+        autosync_ = initial_autosync;
+        return *this;
+    }
+
     // Describes a named prepared statement (PQsendDescribePrepared)
     request& add_describe_statement(std::string_view statement_name)
     {
@@ -298,6 +717,16 @@ public:
     request& add(protocol::sync value) { return add_advanced_impl(value, request_message_type::sync); }
 };
 
+namespace detail {
+
+struct request_access
+{
+    static std::vector<unsigned char>& buffer(request& req) noexcept { return req.buffer_; }
+    static std::span<const borrowed_value> borrowed(const request& req) noexcept { return req.borrowed_; }
+};
+
+}  // namespace detail
+
 }  // namespace nativepg
 
 #endif
@@ -0,0 +1,25 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_REQUEST_PRIORITY_HPP
+#define NATIVEPG_REQUEST_PRIORITY_HPP
+
+namespace nativepg {
+
+// The priority of a request executed by a co_multiplexed_connection.
+// The server answers requests in the order they're written, so priorities
+// only reorder requests that haven't been written yet
+enum class request_priority
+{
+    low,
+    normal,
+    high,
+};
+
+}  // namespace nativepg
+
+#endif
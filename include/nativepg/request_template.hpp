@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_REQUEST_TEMPLATE_HPP
+#define NATIVEPG_REQUEST_TEMPLATE_HPP
+
+#include <boost/assert.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/parameter_ref.hpp"
+#include "nativepg/protocol/common.hpp"
+#include "nativepg/request.hpp"
+
+namespace nativepg {
+
+// A request that executes a prepared statement, and can be re-rendered with new parameter values.
+// The entire message sequence (Bind, Describe, Execute and Sync) is serialized once,
+// recording the offset of each parameter. When re-rendering, fixed-width binary parameters
+// (integers) are overwritten in place. Variable-width ones, and any parameter after them,
+// are serialized again in a single pass that recomputes the length fields.
+template <class... Params>
+class request_template
+{
+    static constexpr std::size_t num_params = sizeof...(Params);
+
+    // Same format selection as add_execute(bound_statement)
+    static constexpr bool use_binary = (detail::supports_binary<Params>::value && ...);
+    static constexpr protocol::format_code fmt = use_binary ? protocol::format_code::binary
+                                                            : protocol::format_code::text;
+
+    // Parameters before this index have a fixed width and can always be patched in place
+    static constexpr std::size_t first_variable_param = [] {
+        constexpr bool fixed[] = {(use_binary && std::integral<Params>)..., false};
+        std::size_t i = 0u;
+        while (i < num_params && fixed[i])
+            ++i;
+        return i;
+    }();
+
+    request req_;
+    std::array<std::size_t, num_params> slots_{};  // offset of each parameter's length field
+    std::vector<unsigned char> tail_;                // everything after the Bind parameters
+    std::size_t bind_tail_size_{};                   // how many bytes of tail_ belong to the Bind message
+
+    std::vector<unsigned char>& buffer() noexcept { return detail::request_access::buffer(req_); }
+
+    template <std::size_t I, class T>
+    boost::system::error_code render_param(const T& value)
+    {
+        if constexpr (I < first_variable_param)
+        {
+            // In-place overwrite. The length doesn't change
+            BOOST_ASSERT(boost::endian::load_big_s32(buffer().data() + slots_[I]) == sizeof(T));
+            boost::endian::endian_store<T, sizeof(T), boost::endian::order::big>(
+                buffer().data() + slots_[I] + 4u,
+                value
+            );
+            return {};
+        }
+        else
+        {
+            // Append, recording the new offset
+            slots_[I] = buffer().size();
+            return detail::serialize_bind_parameter(value, fmt, buffer());
+        }
+    }
+
+    template <std::size_t... I>
+    void render(std::index_sequence<I...>, const Params&... values)
+    {
+        auto& buff = buffer();
+
+        // Discard everything from the first variable-width parameter
+        if constexpr (first_variable_param < num_params)
+            buff.resize(slots_[first_variable_param]);
+
+        // Write the parameters
+        boost::system::error_code ec;
+        ((ec = ec ? ec : render_param<I>(values)), ...);
+
+        if constexpr (first_variable_param < num_params)
+        {
+            // Add the constant part again, and recompute the Bind message length.
+            // The Bind message is the first one, and its length doesn't include the message type
+            const std::size_t bind_size = buff.size() + bind_tail_size_ - 1u;
+            buff.insert(buff.end(), tail_.begin(), tail_.end());
+            if (!ec && bind_size > static_cast<std::size_t>((std::numeric_limits<std::int32_t>::max)()))
+                ec = client_errc::value_too_big;
+            if (!ec)
+                boost::endian::store_big_s32(buff.data() + 1u, static_cast<std::int32_t>(bind_size));
+        }
+
+        // If an error happened, the template is left in an unspecified state
+        if (ec)
+            BOOST_THROW_EXCEPTION(boost::system::system_error(ec));
+    }
+
+public:
+    // Serializes the messages to execute the given prepared statement with the given values.
+    // Uses the same defaults as request::add_execute(bound_statement)
+    request_template(std::string_view statement_name, const Params&... initial_values)
+    {
+        req_.add_execute(bound_statement<num_params>{statement_name, {initial_values...}});
+
+        // Locate the parameters, which come after the header, portal name, statement name,
+        // format codes and parameter count
+        const auto& buff = buffer();
+        std::size_t offset = 1u + 4u + 1u + statement_name.size() + 1u + (use_binary ? 4u : 2u) + 2u;
+        for (std::size_t i = 0u; i < num_params; ++i)
+        {
+            slots_[i] = offset;
+            offset += 4u + static_cast<std::size_t>(boost::endian::load_big_s32(buff.data() + offset));
+        }
+
+        // Everything else is constant: result format codes, Describe, Execute and Sync
+        const auto bind_end = 1u + static_cast<std::size_t>(boost::endian::load_big_s32(buff.data() + 1u));
+        bind_tail_size_ = bind_end - offset;
+        tail_.assign(buff.begin() + static_cast<std::ptrdiff_t>(offset), buff.end());
+    }
+
+    // Re-renders the request with new parameter values
+    void set_params(const Params&... values) { render(std::index_sequence_for<Params...>{}, values...); }
+
+    // The request to pass to exec()
+    const request& get() const noexcept { return req_; }
+};
+
+}  // namespace nativepg
+
+#endif
@@ -0,0 +1,32 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_RESOLVE_CACHE_PARAMS_HPP
+#define NATIVEPG_RESOLVE_CACHE_PARAMS_HPP
+
+#include <chrono>
+
+namespace nativepg {
+
+struct resolve_cache_params
+{
+    // How long successful resolutions are reused. The resolver doesn't report
+    // the records' TTL, so this is used for all of them
+    std::chrono::steady_clock::duration ttl{std::chrono::seconds(30)};
+
+    // How long failed resolutions are remembered. Prevents a misspelled or
+    // unreachable hostname from causing a resolver request per connection attempt
+    std::chrono::steady_clock::duration negative_ttl{std::chrono::seconds(5)};
+
+    // co_resolve_cache::run refreshes entries that have been used and expire within this time,
+    // so connections rarely wait for the resolver. Zero disables background refreshes
+    std::chrono::steady_clock::duration refresh_ahead{std::chrono::seconds(5)};
+};
+
+}  // namespace nativepg
+
+#endif
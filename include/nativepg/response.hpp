@@ -204,39 +204,8 @@ class resultset_callback_t
 
             // If there was a previous failure, the field descriptions may not be present and
             // it's not safe to parse. We still need to get to the CommandComplete message
-            if (self.err_.code)
-                return;
-
-            // TODO: check that data_row has the appropriate size
-
-            // Copy the pointers to the data that we will be using to a random access collection
-            self.random_access_data_.assign(msg.columns.begin(), msg.columns.end());
-
-            // Now invoke parse
-            T row{};
-            boost::system::error_code ec;
-            std::size_t idx = 0u;
-            detail::for_each_member(row, [&ec, &idx, &self = this->self](auto& member) {
-                using FieldType = std::decay_t<decltype(member)>;
-                const detail::pos_map_entry& ent = self.pos_map_[idx++];
-                boost::system::error_code ec2 = detail::field_parse<FieldType>::call(
-                    self.random_access_data_.at(ent.db_index),
-                    ent.descr,
-                    member
-                );
-                if (!ec)
-                    ec = ec2;
-            });
-            if (ec)
-            {
-                self.store_error(ec);
-                return;
-            }
-
-            // Invoke the user-supplied callback
-            self.cb_(std::move(row));
-
-            // We still need the CommandComplete message
+            if (!self.err_.code)
+                self.parse_row(msg);
         }
 
         void on_done() const
@@ -267,6 +236,40 @@ class resultset_callback_t
         void operator()(message_skipped) const { self.store_error(client_errc::step_skipped); }
     };
 
+    void parse_row(const protocol::data_row& msg)
+    {
+        // TODO: check that data_row has the appropriate size
+
+        // Copy the pointers to the data that we will be using to a random access collection
+        random_access_data_.assign(msg.columns.begin(), msg.columns.end());
+
+        // Now invoke parse
+        T row{};
+        boost::system::error_code ec;
+        std::size_t idx = 0u;
+        detail::for_each_member(row, [&ec, &idx, this](auto& member) {
+            using FieldType = std::decay_t<decltype(member)>;
+            const detail::pos_map_entry& ent = pos_map_[idx++];
+            boost::system::error_code ec2 = detail::field_parse<FieldType>::call(
+                random_access_data_.at(ent.db_index),
+                ent.descr,
+                member
+            );
+            if (!ec)
+                ec = ec2;
+        });
+        if (ec)
+        {
+            store_error(ec);
+            return;
+        }
+
+        // Invoke the user-supplied callback
+        cb_(std::move(row));
+
+        // We still need the CommandComplete message
+    }
+
 public:
     template <std::invocable<T&&> Cb>
     explicit resultset_callback_t(Cb&& cb, command_info* out_info = nullptr)
@@ -288,6 +291,18 @@ public:
         boost::variant2::visit(visitor{*this}, msg);
     }
 
+    void on_rows(std::span<const protocol::data_row> rows, std::size_t)
+    {
+        // Same as on_message, but the checks are performed once per batch
+        BOOST_ASSERT(state_ == state_t::parsing_data);
+        for (const auto& row : rows)
+        {
+            if (err_.code)
+                break;
+            parse_row(row);
+        }
+    }
+
     const extended_error& result() const { return err_; }
 };
 
@@ -356,6 +371,46 @@ public:
     const extended_error& result() const { return err_; }
 };
 
+// A response type for a batch added with request::add_execute_batch.
+// Checks that no execution produced an error, skipping any produced rows.
+// May output a batch_info structure with the aggregated affected rows
+// and the index of the failed execution, if any
+class check_execute_batch
+{
+    batch_info* info_{};
+    extended_error err_;
+    std::size_t current_{};  // index of the execution being processed
+
+public:
+    check_execute_batch() = default;
+    check_execute_batch(batch_info& info) noexcept : info_(&info) {}
+
+    handler_setup_result setup(const request& req, std::size_t offset);
+    void on_message(const any_request_message& msg, std::size_t);
+    const extended_error& result() const { return err_; }
+};
+
+// A response type for a transaction added with request::add_transaction.
+// Checks that the transaction committed, skipping any rows produced by its statements.
+// May output a transaction_info structure with the aggregated affected rows
+// and the index of the failed statement, if any
+class check_transaction
+{
+    transaction_info* info_{};
+    extended_error err_;
+    std::size_t statements_offset_{};  // offset of the first statement, after BEGIN
+    std::size_t commit_offset_{};      // offset of COMMIT
+    std::size_t rollback_offset_{};    // offset of ROLLBACK, after COMMIT's Sync
+
+public:
+    check_transaction() = default;
+    check_transaction(transaction_info& info) noexcept : info_(&info) {}
+
+    handler_setup_result setup(const request& req, std::size_t offset);
+    void on_message(const any_request_message& msg, std::size_t offset);
+    const extended_error& result() const { return err_; }
+};
+
 // A response that checks that a single parse (e.g. when preparing a statement)
 // didn't produce an error
 class check_parse
@@ -549,6 +604,18 @@ public:
         });
     }
 
+    void on_rows(std::span<const protocol::data_row> rows, std::size_t offset)
+    {
+        // A batch of rows always belongs to a single message
+        if (offset >= offsets_[current_])
+            ++current_;
+        BOOST_ASSERT(offset < offsets_[current_]);
+
+        boost::mp11::mp_with_index<N>(current_, [this, rows, offset](auto I) {
+            detail::dispatch_rows(std::get<I>(handlers_), rows, offset);
+        });
+    }
+
     const extended_error& result() const
     {
         static_assert(N > 0);
@@ -13,6 +13,7 @@
 
 #include <concepts>
 #include <cstddef>
+#include <span>
 
 #include "nativepg/extended_error.hpp"
 #include "nativepg/protocol/bind.hpp"
@@ -74,16 +75,49 @@ concept response_handler = requires(
     { handler.result() } -> std::same_as<const extended_error&>;
 };
 
+// Response handlers may optionally handle runs of consecutive DataRows in a single call,
+// enabling tight decoding loops. Rows are delivered in order, and are only valid until the call returns.
+// Handlers not implementing this get one on_message call per row
+template <class T>
+concept row_batch_handler = requires(
+    T& handler,
+    std::span<const protocol::data_row> rows,
+    std::size_t offset
+) {
+    { handler.on_rows(rows, offset) };
+};
+
+namespace detail {
+
+// Delivers a batch of rows to a handler, using on_rows if available
+template <class T>
+void dispatch_rows(T& handler, std::span<const protocol::data_row> rows, std::size_t offset)
+{
+    if constexpr (row_batch_handler<T>)
+    {
+        handler.on_rows(rows, offset);
+    }
+    else
+    {
+        for (const auto& row : rows)
+            handler.on_message(row, offset);
+    }
+}
+
+}  // namespace detail
+
 // Type-erased reference to a response handler
 class response_handler_ref
 {
     using setup_fn = handler_setup_result (*)(void*, const request&, std::size_t);
     using on_message_fn = void (*)(void*, const any_request_message&, std::size_t);
+    using on_rows_fn = void (*)(void*, std::span<const protocol::data_row>, std::size_t);
     using result_fn = const extended_error& (*)(const void*);
 
     void* obj_;
     setup_fn setup_;
     on_message_fn on_message_;
+    on_rows_fn on_rows_;
     result_fn result_;
 
     template <class T>
@@ -98,6 +132,12 @@ class response_handler_ref
         static_cast<T*>(obj)->on_message(msg, offset);
     }
 
+    template <class T>
+    static void do_on_rows(void* obj, std::span<const protocol::data_row> rows, std::size_t offset)
+    {
+        detail::dispatch_rows(*static_cast<T*>(obj), rows, offset);
+    }
+
     template <class T>
     static const extended_error& do_result(const void* obj)
     {
@@ -107,7 +147,11 @@ class response_handler_ref
 public:
     template <response_handler T>
     response_handler_ref(T* obj) noexcept
-        : obj_(obj), setup_(&do_setup<T>), on_message_(&do_on_message<T>), result_(&do_result<T>)
+        : obj_(obj),
+          setup_(&do_setup<T>),
+          on_message_(&do_on_message<T>),
+          on_rows_(&do_on_rows<T>),
+          result_(&do_result<T>)
     {
     }
 
@@ -116,6 +160,10 @@ public:
     {
         return on_message_(obj_, req, offset);
     }
+    void on_rows(std::span<const protocol::data_row> rows, std::size_t offset)
+    {
+        return on_rows_(obj_, rows, offset);
+    }
     const extended_error& result() const { return result_(obj_); }
 };
 
@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_RESULT_CACHE_HPP
+#define NATIVEPG_RESULT_CACHE_HPP
+
+#include <boost/system/error_code.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "nativepg/extended_error.hpp"
+#include "nativepg/notification_event.hpp"
+#include "nativepg/protocol/data_row.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+
+namespace nativepg {
+
+struct result_cache_params
+{
+    // Memory used by cached responses, including their keys. Least recently used
+    // entries are evicted to stay under it. Responses bigger than this are not cached
+    std::size_t max_bytes{16u * 1024u * 1024u};
+
+    // Used when cache_options::ttl is zero
+    std::chrono::steady_clock::duration default_ttl{std::chrono::seconds(60)};
+
+    // Notifications on this channel invalidate the entries tagged with their payload.
+    // An empty payload invalidates all entries. Issue them from triggers,
+    // e.g. pg_notify('nativepg_cache_invalidation', 'countries')
+    std::string invalidation_channel{"nativepg_cache_invalidation"};
+};
+
+// How a response should be cached
+struct cache_options
+{
+    // How long the response may be served from cache. Zero means result_cache_params::default_ttl
+    std::chrono::steady_clock::duration ttl{};
+
+    // Invalidating any of these tags removes the entry (e.g. the names of the tables involved)
+    std::span<const std::string_view> tags{};
+};
+
+struct result_cache_stats
+{
+    std::uint64_t hits{};
+    std::uint64_t misses{};
+    std::uint64_t evictions{};     // entries removed to honor the memory budget
+    std::uint64_t invalidations{};  // entries removed by invalidate()
+};
+
+namespace detail {
+
+// Wraps a response handler, recording the messages it receives so they can be replayed.
+// Responses containing errors, or bigger than the maximum size, are not recorded
+class recording_handler
+{
+    response_handler_ref inner_;
+    std::size_t max_size_;
+    std::uint64_t generation_;  // the cache's generation when the request was issued
+    std::vector<unsigned char> messages_;
+    bool cacheable_{true};
+
+    void record(const any_request_message& msg, std::size_t offset);
+
+public:
+    recording_handler(response_handler_ref inner, std::size_t max_size, std::uint64_t generation) noexcept
+        : inner_(inner), max_size_(max_size), generation_(generation)
+    {
+    }
+
+    handler_setup_result setup(const request& req, std::size_t offset)
+    {
+        messages_.clear();
+        cacheable_ = true;
+        return inner_.setup(req, offset);
+    }
+
+    void on_message(const any_request_message& msg, std::size_t offset)
+    {
+        record(msg, offset);
+        inner_.on_message(msg, offset);
+    }
+
+    void on_rows(std::span<const protocol::data_row> rows, std::size_t offset)
+    {
+        for (const auto& row : rows)
+            record(row, offset);
+        inner_.on_rows(rows, offset);
+    }
+
+    const extended_error& result() const { return inner_.result(); }
+
+    bool cacheable() const { return cacheable_ && !result().code.failed(); }
+
+    std::span<const unsigned char> messages() const { return messages_; }
+
+    std::uint64_t generation() const { return generation_; }
+};
+
+}  // namespace detail
+
+// Caches responses to read-only requests, keyed by the request's serialized bytes
+// (statements plus parameters). Hits deliver the recorded messages to the handler,
+// without touching the network. Entries expire after their TTL, are evicted in LRU order
+// to honor a memory budget, and can be invalidated by tags. See co_result_cache.hpp
+// to use it with connections. Not thread-safe
+class result_cache
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+private:
+    struct entry
+    {
+        std::string key;
+        std::vector<unsigned char> messages;
+        std::vector<std::string> tags;
+        clock::time_point expires;
+        std::size_t cost;
+    };
+
+    result_cache_params params_;
+    std::list<entry> lru_;  // most recently used first
+    std::unordered_map<std::string_view, std::list<entry>::iterator> index_;
+    std::string key_scratch_;
+    std::vector<protocol::data_row> row_batch_;  // reused by replays
+    std::size_t memory_usage_{};
+    std::uint64_t generation_{};  // incremented by invalidations
+    result_cache_stats stats_;
+
+    const std::string& compute_key(const request& req);
+    void erase(std::list<entry>::iterator it);
+
+public:
+    explicit result_cache(result_cache_params params = {});
+
+    // Non-copyable, since the index points into the entries
+    result_cache(const result_cache&) = delete;
+    result_cache& operator=(const result_cache&) = delete;
+
+    // If req has a cached response, delivers it to handler and returns the outcome.
+    // Otherwise, returns an empty optional
+    std::optional<boost::system::error_code> replay(
+        const request& req,
+        response_handler_ref handler,
+        clock::time_point now = clock::now()
+    );
+
+    // Wraps a handler to record the response to a request that missed the cache.
+    // Create it before sending the request
+    detail::recording_handler make_recorder(response_handler_ref handler) const
+    {
+        return detail::recording_handler(handler, params_.max_bytes, generation_);
+    }
+
+    // Stores the response recorded by recorder, if it's cacheable. Responses to requests
+    // issued before an invalidation are not stored, since they may reflect outdated data
+    void store(
+        const request& req,
+        const detail::recording_handler& recorder,
+        const cache_options& opts = {},
+        clock::time_point now = clock::now()
+    );
+
+    // Removes the entries with the given tag. Returns the number of entries removed
+    std::size_t invalidate(std::string_view tag);
+
+    // Applies the invalidations requested by notifications in params.invalidation_channel.
+    // Notifications may have been lost while disconnected or when dropped because of overflow,
+    // so reconnections and dropped notifications invalidate all entries
+    void on_notification(const notification_view& notif);
+    void on_notifications(const notification_batch& batch);
+
+    void clear();
+
+    const result_cache_params& params() const { return params_; }
+    std::size_t size() const { return index_.size(); }
+    std::size_t memory_usage() const { return memory_usage_; }
+    const result_cache_stats& stats() const { return stats_; }
+};
+
+}  // namespace nativepg
+
+#endif
@@ -0,0 +1,52 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_RETRY_PARAMS_HPP
+#define NATIVEPG_RETRY_PARAMS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace nativepg {
+
+// Configures how co_retrying_executor retries serialization failures and deadlocks
+struct retry_params
+{
+    // Maximum number of executions of a request, including the first one
+    std::size_t max_attempts{5u};
+
+    // The backoff before the n-th retry is initial_backoff * backoff_multiplier^(n-1),
+    // capped at max_backoff. The actual wait is chosen at random between half and the full
+    // value, so clients that conflicted with each other don't retry at the same time
+    std::chrono::steady_clock::duration initial_backoff{std::chrono::milliseconds(10)};
+    std::chrono::steady_clock::duration max_backoff{std::chrono::seconds(1)};
+    double backoff_multiplier{2.0};
+
+    // Retry budget. Each request earns retry_ratio retries, and up to max_retry_tokens
+    // may be accumulated. Each retry spends one. When contention is persistent, this limits
+    // the extra load to a fraction of the requests, instead of multiplying it by max_attempts
+    double retry_ratio{0.2};
+    double max_retry_tokens{10.0};
+};
+
+// Counters describing how often retries happened
+struct retry_stats
+{
+    // Requests executed
+    std::uint64_t num_requests{};
+
+    // Executions beyond the first one
+    std::uint64_t num_retries{};
+
+    // Retryable failures that were not retried because the budget was exhausted
+    std::uint64_t num_budget_exhausted{};
+};
+
+}  // namespace nativepg
+
+#endif
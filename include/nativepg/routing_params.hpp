@@ -0,0 +1,52 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_ROUTING_PARAMS_HPP
+#define NATIVEPG_ROUTING_PARAMS_HPP
+
+#include "nativepg/protocol/replication.hpp"
+
+namespace nativepg {
+
+// The role of a server, as detected by the routing pool
+enum class host_role
+{
+    unknown,  // not yet detected, or the server is unreachable
+    primary,
+    replica,
+};
+
+// How read-only requests are distributed among replicas
+enum class load_balancing
+{
+    // The replica with fewer connections in use. Ties are broken by latency
+    least_loaded,
+
+    // Weighs the connections in use by each replica's latency
+    latency_weighted,
+};
+
+enum class access_mode
+{
+    read_write,
+    read_only,
+};
+
+// Describes how a connection will be used
+struct route_options
+{
+    access_mode mode{access_mode::read_write};
+
+    // For read-your-writes consistency in read-only requests. Only replicas known to have
+    // replayed the WAL up to this position are considered. Obtain it after committing
+    // by running SELECT pg_current_wal_lsn() - '0/0'. Zero disables the check
+    protocol::lsn_t min_lsn{};
+};
+
+}  // namespace nativepg
+
+#endif
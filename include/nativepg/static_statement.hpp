@@ -0,0 +1,155 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_STATIC_STATEMENT_HPP
+#define NATIVEPG_STATIC_STATEMENT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "nativepg/parameter_ref.hpp"
+#include "nativepg/protocol/common.hpp"
+
+namespace nativepg {
+
+// A string that can be used as a template argument,
+// as in static_statement<"get_user", "SELECT * FROM users WHERE id = $1", std::int32_t>
+template <std::size_t N>
+struct fixed_string
+{
+    char value[N]{};
+
+    constexpr fixed_string(const char (&str)[N]) noexcept { std::copy_n(str, N, value); }
+
+    constexpr std::string_view view() const noexcept { return {value, N - 1u}; }
+};
+
+namespace detail {
+
+// Writes protocol messages into a fixed-size array at compile time
+template <std::size_t N>
+struct static_message_writer
+{
+    std::array<unsigned char, N> data{};
+    std::size_t offset{};
+
+    constexpr void add_byte(unsigned char value) { data[offset++] = value; }
+
+    constexpr void add_string(std::string_view value)
+    {
+        for (char c : value)
+            add_byte(static_cast<unsigned char>(c));
+        add_byte(0);  // NULL terminator
+    }
+
+    template <class IntType>
+    constexpr void add_integral(IntType value)
+    {
+        // Big endian
+        const auto unsigned_value = static_cast<std::make_unsigned_t<IntType>>(value);
+        for (std::size_t i = sizeof(IntType); i > 0u; --i)
+            add_byte(static_cast<unsigned char>(unsigned_value >> (8u * (i - 1u))));
+    }
+};
+
+// Serializes the entire Parse message
+template <fixed_string Name, fixed_string Query, class... Params>
+constexpr auto make_static_parse_message()
+{
+    constexpr std::size_t size = 1u + 4u + Name.view().size() + 1u + Query.view().size() + 1u + 2u +
+                                 4u * sizeof...(Params);
+    static_message_writer<size> writer;
+    writer.add_byte('P');
+    writer.add_integral(static_cast<std::int32_t>(size - 1u));
+    writer.add_string(Name.view());
+    writer.add_string(Query.view());
+    writer.add_integral(static_cast<std::int16_t>(sizeof...(Params)));
+    (writer.add_integral(parameter_type_oid<Params>::value), ...);
+    return writer.data;
+}
+
+// Serializes the Bind message header, portal name, statement name, parameter format codes
+// and number of parameters. The message length is not known until the parameters have been
+// serialized, and is left as zero
+template <fixed_string Name, protocol::format_code Fmt, std::size_t NumParams>
+constexpr auto make_static_bind_prefix()
+{
+    constexpr std::size_t fmt_codes_size = Fmt == protocol::format_code::text ? 2u : 4u;
+    constexpr std::size_t size = 1u + 4u + 1u + Name.view().size() + 1u + fmt_codes_size + 2u;
+    static_message_writer<size> writer;
+    writer.add_byte('B');
+    writer.add_integral(std::int32_t(0));
+    writer.add_string({});  // unnamed portal
+    writer.add_string(Name.view());
+    if constexpr (Fmt == protocol::format_code::text)
+    {
+        writer.add_integral(std::int16_t(0));  // all parameters use text
+    }
+    else
+    {
+        writer.add_integral(std::int16_t(1));  // all parameters use the following code
+        writer.add_integral(static_cast<std::int16_t>(Fmt));
+    }
+    writer.add_integral(static_cast<std::int16_t>(NumParams));
+    return writer.data;
+}
+
+}  // namespace detail
+
+template <class Statement, class... Params>
+struct bound_static_statement
+{
+    std::tuple<const Params&...> params;
+};
+
+// A prepared statement whose name, query and parameter types are known at compile time.
+// The Parse message and the fixed part of the Bind message are serialized at compile time,
+// so adding them to a request is a copy plus the parameter payloads.
+// Parameters are sent in binary if all of them support it, and in text otherwise.
+template <fixed_string Name, fixed_string Query, class... Params>
+class static_statement
+{
+    static_assert(sizeof...(Params) <= static_cast<std::size_t>((std::numeric_limits<std::int16_t>::max)()));
+    static_assert(Name.view().find('\0') == std::string_view::npos, "Statement names can't contain NULLs");
+    static_assert(Query.view().find('\0') == std::string_view::npos, "Queries can't contain NULLs");
+
+    static constexpr auto text_bind_prefix = detail::
+        make_static_bind_prefix<Name, protocol::format_code::text, sizeof...(Params)>();
+    static constexpr auto binary_bind_prefix = detail::
+        make_static_bind_prefix<Name, protocol::format_code::binary, sizeof...(Params)>();
+
+public:
+    using bound_type = bound_static_statement<static_statement, Params...>;
+
+    static constexpr std::string_view name = Name.view();
+    static constexpr std::string_view query = Query.view();
+    static constexpr bool supports_binary = (detail::supports_binary<Params>::value && ...);
+
+    // The entire Parse message
+    static constexpr auto parse_message = detail::make_static_parse_message<Name, Query, Params...>();
+
+    // The Bind message up to (and including) the number of parameters
+    static constexpr std::span<const unsigned char> bind_prefix(protocol::format_code fmt) noexcept
+    {
+        if (fmt == protocol::format_code::binary)
+            return binary_bind_prefix;
+        return text_bind_prefix;
+    }
+
+    bound_type bind(const Params&... values) const noexcept { return {{values...}}; }
+};
+
+}  // namespace nativepg
+
+#endif
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_SUBSCRIPTION_REGISTRY_HPP
+#define NATIVEPG_SUBSCRIPTION_REGISTRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "nativepg/notification_event.hpp"
+#include "nativepg/request.hpp"
+
+namespace nativepg {
+
+// Invoked for every notification received in a channel
+using notification_handler = std::function<void(const notification_view&)>;
+
+// Identifies a subscription, to be passed to unsubscribe
+struct subscription_id
+{
+    std::uint64_t value{};
+
+    friend bool operator==(subscription_id, subscription_id) noexcept = default;
+};
+
+// Tracks which channels the application is interested in, and dispatches notifications
+// to their subscribers. This is the sans-IO part of co_subscriber.
+// Subscribing and unsubscribing don't perform I/O. Instead, the registry computes which
+// LISTEN and UNLISTEN statements should be sent to the server so it matches the registry.
+// These are composed into a single, pipelined request.
+class subscription_registry
+{
+    struct subscriber
+    {
+        std::uint64_t id;
+        notification_handler handler;
+        bool active;  // false if unsubscribed while dispatching
+    };
+
+    // A deque keeps references valid if a handler subscribes while being invoked
+    struct channel_state
+    {
+        std::deque<subscriber> subscribers;
+        std::size_t num_active{};
+        bool listening{};          // whether the server is (or will be) listening to the channel
+    };
+
+    // Enables lookups by string_view without creating a string
+    struct string_hash
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    std::unordered_map<std::string, channel_state, string_hash, std::equal_to<>> channels_;
+    std::unordered_map<std::uint64_t, std::string> id_to_channel_;
+    std::uint64_t next_id_{1u};
+    bool resync_all_{};   // the server state is unknown
+    bool dispatching_{};  // subscribers can't be removed from the deques
+    std::vector<channel_state*> unsubscribed_while_dispatching_;  // cleaned up once dispatch finishes
+
+    static void remove_unsubscribed(channel_state& ch);
+
+public:
+    subscription_registry() = default;
+
+    // Registers a handler for a channel. Channel names are case-sensitive.
+    // If nobody was subscribed to the channel, a LISTEN will be sent on the next sync.
+    // May be called from a notification handler.
+    subscription_id subscribe(std::string_view channel, notification_handler handler);
+
+    // Removes a subscription. If it was the channel's last one, an UNLISTEN will be sent
+    // on the next sync. Unknown IDs are ignored. May be called from a notification handler.
+    void unsubscribe(subscription_id id);
+
+    // Whether there are LISTEN or UNLISTEN statements to be sent
+    bool needs_sync() const noexcept;
+
+    // Adds the required LISTEN and UNLISTEN statements to req, one query each,
+    // and assumes that they will succeed. Returns false if there was nothing to add.
+    bool prepare_sync(request& req);
+
+    // Call after executing a request composed by prepare_sync. If it failed,
+    // all statements will be sent again on the next sync.
+    void on_sync_finished(bool success) noexcept;
+
+    // Call when a new physical connection is established, which isn't listening to any channel
+    void on_connect();
+
+    // Invokes the handlers subscribed to the event's channel.
+    // Events with a type other than notify are ignored. Returns the number of handlers invoked.
+    std::size_t dispatch(const notification_view& evt);
+
+    // Number of channels with subscribers
+    std::size_t num_channels() const noexcept;
+};
+
+}  // namespace nativepg
+
+#endif
@@ -8,6 +8,7 @@
 #ifndef NATIVEPG_TYPES_BASE_HPP
 #define NATIVEPG_TYPES_BASE_HPP
 
+#include <boost/assert.hpp>
 #include <boost/endian/conversion.hpp>
 #include <boost/system/error_code.hpp>
 
@@ -19,9 +20,12 @@
 #include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "nativepg/client_errc.hpp"
+#include "nativepg/detail/hex.hpp"
+#include "nativepg/detail/parse_number.hpp"
 #include "nativepg/field_view.hpp"
 
 namespace nativepg {
@@ -55,13 +59,30 @@ namespace detail {
 template <typename T>
 error_code parse_text_to_number(const std::string_view& sv, T& to)
 {
-    T result = 0;
-    auto [ptr, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), result);
-    if (ec == std::errc{} && ptr == sv.data() + sv.size())
-        to = std::move(result);  // Success
-    else if (sv.size() != 0)
-        return client_errc::protocol_value_error;
+    // Empty strings leave to untouched
+    if (sv.empty())
+        return {};
+
+    bool ok = false;
+    if constexpr (std::is_floating_point_v<T>)
+        ok = nativepg::detail::parse_text_floating(sv, to);
+    else
+        ok = nativepg::detail::parse_text_integer(sv, to);
+    return ok ? error_code() : error_code(client_errc::protocol_value_error);
+}
 
+// Batched parsing of a run of values of the same column
+template <typename T, typename Fn>
+error_code parse_batch(std::span<const field_view> from, std::span<T> to, Fn&& parse_fn)
+{
+    BOOST_ASSERT(from.size() == to.size());
+    for (std::size_t i = 0; i < from.size(); ++i)
+    {
+        if (from[i].is_null())
+            return client_errc::unexpected_null;
+        if (auto ec = parse_fn(from[i].data_str(), to[i]))
+            return ec;
+    }
     return {};
 }
 
@@ -100,17 +121,9 @@ error_code parse_text_bytea(const field_view& from, T& to)
     sv.remove_prefix(2);
     if (sv.size() % 2 != 0)
         return client_errc::protocol_value_error;
-    to.clear();
-    to.reserve(sv.size() / 2);
-    for (std::size_t i = 0; i < sv.size(); i += 2)
-    {
-        unsigned char byte{};
-        if (auto [ptr, ec] = std::from_chars(sv.data() + i, sv.data() + i + 2, byte, 16);
-            ec != std::errc{} || ptr != sv.data() + i + 2)
-            return client_errc::protocol_value_error;
-        to.push_back(static_cast<std::byte>(byte));
-    }
-    return {};
+    // Size the output once and decode in bulk
+    to.resize(sv.size() / 2);
+    return nativepg::detail::hex_decode(sv, reinterpret_cast<unsigned char*>(to.data()));
 }
 
 template <class T = std::vector<std::byte>>
@@ -153,6 +166,17 @@ error_code parse_text_int(const field_view& from, T& to)
     return detail::parse_text_to_number<T>(sv, to);
 }
 
+// Batched version, for a run of values of the same column.
+// to.size() must be equal to from.size(). Stops at the first error, leaving the preceding values
+// written. NULLs yield client_errc::unexpected_null.
+template <class T>
+error_code parse_text_int_batch(std::span<const field_view> from, std::span<T> to)
+{
+    return detail::parse_batch(from, to, [](std::string_view sv, T& value) {
+        return detail::parse_text_to_number<T>(sv, value);
+    });
+}
+
 template <class T>
 error_code parse_binary_int(const field_view& from, T& to)
 {
@@ -170,6 +194,15 @@ error_code parse_text_float(const field_view& from, T& to)
     return detail::parse_text_to_number<T>(sv, to);
 }
 
+// Batched version, with the same semantics as parse_text_int_batch
+template <class T>
+error_code parse_text_float_batch(std::span<const field_view> from, std::span<T> to)
+{
+    return detail::parse_batch(from, to, [](std::string_view sv, T& value) {
+        return detail::parse_text_to_number<T>(sv, value);
+    });
+}
+
 template <class T>
 error_code parse_binary_float(const field_view& from, T& to)
 {
@@ -8,49 +8,85 @@
 #include <boost/assert.hpp>
 #include <boost/capy/buffers.hpp>
 #include <boost/capy/buffers/make_buffer.hpp>
+#include <boost/capy/ex/async_event.hpp>
 #include <boost/capy/ex/execution_context.hpp>
+#include <boost/capy/ex/this_coro.hpp>
 #include <boost/capy/io_task.hpp>
+#include <boost/capy/task.hpp>
+#include <boost/capy/timeout.hpp>
+#include <boost/capy/when_any.hpp>
 #include <boost/capy/write.hpp>
 #include <boost/corosio/connect.hpp>
 #include <boost/corosio/resolver.hpp>
 #include <boost/corosio/tcp_socket.hpp>
+#include <boost/system/error_code.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 #include "nativepg/co_connection.hpp"
+#include "nativepg/co_resolve_cache.hpp"
 #include "nativepg/connect_params.hpp"
+#include "nativepg/exec_item.hpp"
 #include "nativepg/extended_error.hpp"
 #include "nativepg/protocol/connection_state.hpp"
 #include "nativepg/protocol/detail/connect_fsm.hpp"
+#include "nativepg/protocol/detail/exec_batch_fsm.hpp"
 #include "nativepg/protocol/detail/exec_fsm.hpp"
 #include "nativepg/protocol/detail/exec_some_fsm.hpp"
 #include "nativepg/protocol/parse_message.hpp"
 #include "nativepg/request.hpp"
 #include "nativepg/response.hpp"
 #include "nativepg/response_handler.hpp"
+#include "nativepg_internal/connect_race/connect_race_tracker.hpp"
+#include "nativepg_internal/resolve_cache/co_resolve_cache_impl.hpp"
 
 namespace capy = boost::capy;
 namespace corosio = boost::corosio;
 
 namespace nativepg {
 
+namespace {
+
+// How much space is made available in the read buffer for each read during full-duplex writes
+constexpr std::size_t duplex_read_size = 4096u;
+
+}  // namespace
+
 struct co_connection::impl
 {
+    capy::execution_context& ctx;  // to create the connections used by multi-host connects
     corosio::resolver resolv;
+    co_resolve_cache* resolve_cache{};
+    detail::co_resolve_cache_impl* resolve_cache_impl{};
     corosio::tcp_socket sock;
     protocol::connection_state st{};
     capy::any_stream stream{&sock};
     std::vector<capy::const_buffer> copy_out_buffers;
+    std::vector<capy::const_buffer> write_buffers;
     std::optional<protocol::detail::exec_some_fsm> exec_some_fsm;
 
-    explicit impl(capy::execution_context& ctx) : resolv(ctx), sock(ctx) {}
+    explicit impl(capy::execution_context& ctx) : ctx(ctx), resolv(ctx), sock(ctx) {}
 
-    capy::io_task<> physical_connect(const connect_params& params)
+    // Uses the resolve cache, if any
+    capy::io_task<corosio::resolver_results> resolve(const connect_params& params)
     {
+        if (resolve_cache_impl)
+            co_return co_await resolve_cache_impl->resolve(resolv, params.hostname, params.port);
         auto [ec, endpoints] = co_await resolv.resolve(params.hostname, std::to_string(params.port));
+        co_return {ec, std::move(endpoints)};
+    }
+
+    capy::io_task<> physical_connect(const connect_params& params)
+    {
+        auto [ec, endpoints] = co_await resolve(params);
         if (ec)
             co_return {ec};
 
@@ -58,6 +94,86 @@ struct co_connection::impl
         co_return {ec2};
     }
 
+    // Composes write_buffers from the chunks of a request (or anything with for_each_chunk),
+    // so borrowed parameter values are not copied. Returns the number of bytes to write
+    template <class ChunkSource>
+    std::size_t prepare_write_buffers(const ChunkSource& src)
+    {
+        std::size_t size = 0u;
+        write_buffers.clear();
+        src.for_each_chunk([this, &size](std::span<const unsigned char> chunk) {
+            write_buffers.push_back(capy::make_buffer(chunk));
+            size += chunk.size();
+        });
+        return size;
+    }
+
+    // Writes a request as a gather list
+    template <class Stream>
+    capy::io_task<std::size_t> write_request(Stream& s, const request& req)
+    {
+        prepare_write_buffers(req);
+        auto [ec, bytes] = co_await capy::write(s, write_buffers);
+        co_return {ec, bytes};
+    }
+
+    // The write side of a full-duplex operation. Like in the multiplexer, results are reported
+    // out of band, so when_any finishes when either side completes
+    capy::io_task<> duplex_write(
+        boost::system::error_code& write_ec,
+        std::size_t& bytes_written,
+        bool& finished
+    )
+    {
+        auto [ec, bytes] = co_await capy::write(sock, write_buffers);
+        write_ec = ec;
+        bytes_written = bytes;
+        finished = true;
+        co_return {};
+    }
+
+    // The read side of a full-duplex operation. Reads whatever the server sends into the read buffer,
+    // without parsing it, so the server never stalls sending its response. Runs until cancelled
+    capy::io_task<> duplex_read(boost::system::error_code& read_ec)
+    {
+        while (true)
+        {
+            st.read_buffer.prepare(duplex_read_size);
+            auto [ec, bytes] = co_await sock.read_some(capy::make_buffer(st.read_buffer.prepared_area()));
+            st.read_buffer.commit(bytes);
+            if (ec)
+            {
+                read_ec = ec;
+                co_return {};
+            }
+        }
+    }
+
+    // Writes write_buffers while reading the response, so neither side stalls for big requests
+    // (see full_duplex_threshold). The FSM must have just requested a write.
+    // It's resumed with the write's outcome once the write has finished,
+    // and then parses the part of the response that was read meanwhile
+    template <class Fsm>
+    capy::task<> write_and_read(Fsm& fsm, typename Fsm::result& res)
+    {
+        boost::system::error_code write_ec, read_ec;
+        std::size_t bytes_written = 0u;
+        bool write_finished = false;
+        [[maybe_unused]] auto when_any_res = co_await capy::when_any(
+            duplex_write(write_ec, bytes_written, write_finished),
+            duplex_read(read_ec)
+        );
+
+        // If reading failed, the write was cut short, and the stream is left in the middle
+        // of a message. The connection can't be used until it's re-established
+        if (!write_finished)
+        {
+            sock.close();  // this can't fail in Corosio
+            write_ec = read_ec;
+        }
+        res = fsm.resume(st, write_ec, bytes_written);
+    }
+
     void setup_request(const request& req, response_handler_ref handler)
     {
         BOOST_ASSERT(!exec_some_fsm.has_value());
@@ -101,10 +217,7 @@ struct co_connection::impl
             {
                 case protocol::detail::exec_some_fsm::result_type::write:
                 {
-                    auto [ec, bytes] = co_await capy::write(
-                        stream,
-                        capy::make_buffer(fsm.get_request().payload())
-                    );
+                    auto [ec, bytes] = co_await write_request(stream, fsm.get_request());
                     if (ec)
                         co_return {ec, {}};
                     break;
@@ -144,12 +257,139 @@ struct co_connection::impl
     }
 };
 
+namespace {
+
+// A connection attempt to one of the servers of a multi-host connect
+struct connect_attempt
+{
+    co_connection conn;
+    connect_params params;
+    std::error_code ec;
+    diagnostics diag;
+    capy::async_event failed_ev;  // set on failure, so the next attempt starts without waiting
+
+    connect_attempt(capy::execution_context& ctx, co_resolve_cache* cache, connect_params&& params)
+        : conn(ctx), params(std::move(params))
+    {
+        conn.set_resolve_cache(cache);
+    }
+};
+
+struct connect_race
+{
+    std::vector<std::unique_ptr<connect_attempt>> attempts;
+    detail::connect_race_tracker tracker;
+
+    // Never set. Waited on by attempts that failed, so the others decide the outcome
+    capy::async_event give_up_ev;
+
+    connect_race(capy::execution_context& ctx, co_resolve_cache* cache, const connect_params& params)
+        : tracker(params.fallback_hosts.size() + 1u)
+    {
+        // Attempts connect to a single server
+        auto make_params = [&params](const std::string& hostname, unsigned short port) {
+            connect_params res = params;
+            res.hostname = hostname;
+            res.port = port;
+            res.fallback_hosts.clear();
+            return res;
+        };
+
+        attempts.reserve(params.fallback_hosts.size() + 1u);
+        auto add_attempt = [&](const std::string& hostname, unsigned short port) {
+            attempts.push_back(std::make_unique<connect_attempt>(ctx, cache, make_params(hostname, port)));
+        };
+        add_attempt(params.hostname, params.port);
+        for (const auto& host : params.fallback_hosts)
+            add_attempt(host.hostname, host.port);
+    }
+};
+
+// Lets the other attempts decide the outcome
+capy::task<> give_up(connect_race& race)
+{
+    auto [ec] = co_await race.give_up_ev.wait();
+    static_cast<void>(ec);
+}
+
+// These tasks don't return an error code so when_any
+// finishes when they return
+capy::io_task<> run_connect_attempt(connect_race& race, std::size_t idx)
+{
+    auto& att = *race.attempts[idx];
+    auto [ec] = co_await att.conn.connect(att.params, &att.diag);
+    att.ec = ec;
+    if (!ec)
+    {
+        race.tracker.on_success(idx);
+    }
+    else
+    {
+        // If all attempts failed, the last one to do so finishes, so the race completes
+        const bool all_failed = race.tracker.on_failure(idx);
+        att.failed_ev.set();
+        if (!all_failed)
+            co_await give_up(race);
+    }
+    co_return {};
+}
+
+capy::io_task<> wait_failed(connect_attempt& att)
+{
+    auto [ec] = co_await att.failed_ev.wait();
+    co_return {ec};
+}
+
+capy::io_task<> race_from(connect_race& race, std::size_t idx, std::chrono::steady_clock::duration stagger);
+
+// Starts the attempt after idx once the stagger delay elapses, or as soon as attempt idx fails
+capy::io_task<> start_next(connect_race& race, std::size_t idx, std::chrono::steady_clock::duration stagger)
+{
+    if (race.tracker.has_next(idx))
+    {
+        // Returns a timeout error if attempt idx is still running
+        auto [ec] = co_await capy::timeout(wait_failed(*race.attempts[idx]), stagger);
+        static_cast<void>(ec);
+        auto tok = co_await capy::this_coro::stop_token;
+        if (tok.stop_requested())
+            co_return {};
+    }
+
+    // Nothing to start, or it was already started. Wait until the race is decided
+    const auto next = race.tracker.start_next(idx);
+    if (next == detail::connect_race_tracker::no_attempt)
+    {
+        co_await give_up(race);
+        co_return {};
+    }
+
+    co_return co_await race_from(race, next, stagger);
+}
+
+// Runs attempt idx and, concurrently, the ones after it. The first one to succeed cancels the rest
+capy::io_task<> race_from(connect_race& race, std::size_t idx, std::chrono::steady_clock::duration stagger)
+{
+    [[maybe_unused]] auto res = co_await capy::when_any(
+        run_connect_attempt(race, idx),
+        start_next(race, idx, stagger)
+    );
+    co_return {};
+}
+
+}  // namespace
+
 co_connection::co_connection(capy::execution_context& ctx) : impl_(std::make_unique<impl>(ctx)) {}
 
 co_connection& co_connection::operator=(co_connection&&) noexcept = default;
 
 co_connection::~co_connection() = default;
 
+void co_connection::set_resolve_cache(co_resolve_cache* cache) noexcept
+{
+    impl_->resolve_cache = cache;
+    impl_->resolve_cache_impl = cache ? cache->impl_.get() : nullptr;
+}
+
 // TODO: I'd prefer having connect_params be a view
 // const references here may cause dangling parameters
 // TODO: proper reset
@@ -157,6 +397,21 @@ capy::io_task<> co_connection::connect(connect_params params, diagnostics* diag)
 {
     using protocol::detail::connect_fsm;
 
+    // Multi-host: race connections and keep the winner's. The losers are closed on destruction
+    if (!params.fallback_hosts.empty())
+    {
+        connect_race race(impl_->ctx, impl_->resolve_cache, params);
+        co_await race_from(race, 0u, params.connect_stagger);
+
+        // If all attempts failed, report the last error
+        auto& att = *race.attempts[race.tracker.result()];
+        if (race.tracker.succeeded())
+            std::swap(impl_, att.conn.impl_);
+        if (diag)
+            *diag = std::move(att.diag);
+        co_return {att.ec};
+    }
+
     // Initialize
     connect_fsm fsm_(params);
     auto res = fsm_.resume(impl_->st, {}, 0u);
@@ -214,8 +469,16 @@ capy::io_task<> co_connection::exec(const request& req, response_handler_ref han
         {
             case protocol::startup_fsm::result_type::write:
             {
-                auto [ec, bytes] = co_await capy::write(impl_->sock, capy::make_buffer(res.write_data()));
-                res = fsm_.resume(impl_->st, ec, bytes);
+                const auto size = impl_->prepare_write_buffers(fsm_);
+                if (size > protocol::detail::full_duplex_threshold)
+                {
+                    co_await impl_->write_and_read(fsm_, res);
+                }
+                else
+                {
+                    auto [ec, bytes] = co_await capy::write(impl_->sock, impl_->write_buffers);
+                    res = fsm_.resume(impl_->st, ec, bytes);
+                }
                 break;
             }
             case protocol::startup_fsm::result_type::read:
@@ -236,6 +499,45 @@ capy::io_task<> co_connection::exec(const request& req, response_handler_ref han
     }
 }
 
+capy::io_task<> co_connection::exec_batch(std::span<exec_item> items)
+{
+    using protocol::detail::exec_batch_fsm;
+
+    // Initialize
+    exec_batch_fsm fsm_(items);
+    auto res = fsm_.resume(impl_->st, {}, 0u);
+
+    while (true)
+    {
+        switch (res.type())
+        {
+            case exec_batch_fsm::result_type::write:
+            {
+                // A single write for all the requests
+                const auto size = impl_->prepare_write_buffers(fsm_);
+                if (size > protocol::detail::full_duplex_threshold)
+                {
+                    co_await impl_->write_and_read(fsm_, res);
+                }
+                else
+                {
+                    auto [ec, bytes] = co_await capy::write(impl_->sock, impl_->write_buffers);
+                    res = fsm_.resume(impl_->st, ec, bytes);
+                }
+                break;
+            }
+            case exec_batch_fsm::result_type::read:
+            {
+                auto [ec, bytes] = co_await impl_->sock.read_some(capy::make_buffer(res.read_buffer()));
+                res = fsm_.resume(impl_->st, ec, bytes);
+                break;
+            }
+            case exec_batch_fsm::result_type::done: co_return {res.error()};
+            default: BOOST_ASSERT(false); co_return {};
+        }
+    }
+}
+
 void co_connection::setup_request(const request& req, response_handler_ref handler)
 {
     return impl_->setup_request(req, handler);
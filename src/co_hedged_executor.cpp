@@ -0,0 +1,237 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/capy/delay.hpp>
+#include <boost/capy/ex/async_event.hpp>
+#include <boost/capy/io_task.hpp>
+#include <boost/capy/task.hpp>
+#include <boost/capy/when_any.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "nativepg/co_hedged_executor.hpp"
+#include "nativepg/co_multiplexed_connection.hpp"
+#include "nativepg/extended_error.hpp"
+#include "nativepg/hedging_params.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+#include "nativepg_internal/hedging/hedge_delay_tracker.hpp"
+
+namespace capy = boost::capy;
+using namespace nativepg;
+
+namespace {
+
+void check_hedging_params(
+    const std::vector<co_multiplexed_connection*>& replicas,
+    const hedging_params& params
+)
+{
+    const char* msg = nullptr;
+    if (replicas.empty())
+        msg = "co_hedged_executor requires at least one connection";
+    else if (std::ranges::find(replicas, nullptr) != replicas.end())
+        msg = "co_hedged_executor connections must not be null";
+    else if (!(params.quantile > 0.0 && params.quantile <= 1.0))
+        msg = "hedging_params::quantile must be in the (0, 1] interval";
+    else if (params.window == 0u)
+        msg = "hedging_params::window must be greater than zero";
+    else if (params.min_samples > params.window)
+        msg = "hedging_params::min_samples must be less than or equal to hedging_params::window";
+    else if (params.min_delay.count() < 0 || params.min_delay > params.max_delay)
+        msg = "hedging_params::min_delay must be non-negative and less than or equal to max_delay";
+    else if (!(params.max_hedge_ratio >= 0.0))
+        msg = "hedging_params::max_hedge_ratio must be non-negative";
+
+    if (msg != nullptr)
+    {
+        BOOST_THROW_EXCEPTION(std::invalid_argument(msg));
+    }
+}
+
+constexpr std::size_t no_winner = static_cast<std::size_t>(-1);
+
+// Shared by the two attempts of a request
+struct attempt_state
+{
+    // Attempts that may still produce a response
+    std::size_t pending{2u};
+
+    // The first attempt that got a response
+    std::size_t winner{no_winner};
+
+    // Measured from the start of the request, rather than the winning attempt.
+    // When the hedge wins, this is a lower bound of the first attempt's latency,
+    // which is what the hedge delay is computed from
+    std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+    std::chrono::steady_clock::duration latency{};
+
+    std::error_code ec[2]{};
+    bool finished[2]{};
+    diagnostics diag[2]{};
+
+    // Never set. Waited on by attempts that can't produce a response,
+    // so the other attempt decides the outcome
+    capy::async_event give_up_ev;
+};
+
+}  // namespace
+
+struct nativepg::co_hedged_executor::impl
+{
+    std::vector<co_multiplexed_connection*> replicas;
+    detail::hedge_delay_tracker tracker;
+    std::size_t next_replica{};
+
+    impl(std::vector<co_multiplexed_connection*>&& replicas, const hedging_params& params)
+        : replicas(std::move(replicas)), tracker(params)
+    {
+        check_hedging_params(this->replicas, params);
+    }
+
+    // If both attempts give up, the last one to do so finishes, so the request completes
+    static capy::task<> give_up(attempt_state& st)
+    {
+        if (--st.pending > 0u)
+        {
+            auto [ec] = co_await st.give_up_ev.wait();
+            static_cast<void>(ec);
+        }
+    }
+
+    // These tasks don't return an error code so when_any
+    // finishes when they return
+    capy::io_task<> run_attempt(
+        std::size_t attempt,
+        std::size_t replica,
+        const request& req,
+        response_handler_ref handler,
+        attempt_state& st
+    )
+    {
+        auto [ec] = co_await replicas[replica]->exec(req, handler, &st.diag[attempt]);
+        st.ec[attempt] = ec;
+        st.finished[attempt] = true;
+
+        // Errors reported by the server (or by the handler, when parsing rows) are responses, too.
+        // Sending the request to another replica would yield the same outcome
+        if (!ec || handler.result().code.failed())
+        {
+            if (st.winner != no_winner)
+                co_return {};
+            st.winner = attempt;
+            st.latency = std::chrono::steady_clock::now() - st.start;
+        }
+        else
+        {
+            // Network errors and the like. The other attempt may still succeed
+            co_await give_up(st);
+        }
+        co_return {};
+    }
+
+    capy::io_task<> run_hedge(
+        std::size_t replica,
+        const request& req,
+        response_handler_ref handler,
+        attempt_state& st
+    )
+    {
+        // Cancelled because the first attempt got a response
+        auto [ec] = co_await capy::delay(tracker.delay());
+        if (ec)
+            co_return {};
+
+        // Hedging budget exceeded
+        if (!tracker.on_hedge_timer())
+        {
+            co_await give_up(st);
+            co_return {};
+        }
+
+        co_return co_await run_attempt(1u, replica, req, handler, st);
+    }
+
+    capy::io_task<std::size_t> exec(
+        const request& req,
+        response_handler_ref first_handler,
+        response_handler_ref hedge_handler,
+        diagnostics* diag
+    )
+    {
+        tracker.on_request_started();
+
+        // Spread the first attempts among replicas. The hedge goes to the next one
+        const auto first_replica = next_replica;
+        next_replica = (next_replica + 1u) % replicas.size();
+
+        attempt_state st;
+        if (replicas.size() == 1u)
+        {
+            st.pending = 1u;
+            co_await run_attempt(0u, first_replica, req, first_handler, st);
+        }
+        else
+        {
+            // The attempt that loses is cancelled. If its request has already been sent,
+            // the connection discards the response when it arrives
+            const auto hedge_replica = next_replica;
+            [[maybe_unused]] auto res = co_await capy::when_any(
+                run_attempt(0u, first_replica, req, first_handler, st),
+                run_hedge(hedge_replica, req, hedge_handler, st)
+            );
+        }
+
+        // If no attempt got a response, report the first one's error
+        // (the hedge may have not been sent)
+        std::size_t idx = st.winner;
+        if (idx == no_winner)
+            idx = st.finished[0] ? 0u : 1u;
+        else
+            tracker.on_response(st.latency, idx == 1u);
+
+        if (diag)
+            *diag = std::move(st.diag[idx]);
+        co_return {st.ec[idx], idx};
+    }
+};
+
+co_hedged_executor::co_hedged_executor(
+    std::vector<co_multiplexed_connection*> replicas,
+    hedging_params params
+)
+    : impl_(std::make_unique<impl>(std::move(replicas), params))
+{
+}
+
+co_hedged_executor::co_hedged_executor(co_hedged_executor&&) noexcept = default;
+
+co_hedged_executor& co_hedged_executor::operator=(co_hedged_executor&&) noexcept = default;
+
+co_hedged_executor::~co_hedged_executor() = default;
+
+capy::io_task<std::size_t> co_hedged_executor::exec(
+    const request& req,
+    response_handler_ref first_handler,
+    response_handler_ref hedge_handler,
+    diagnostics* diag
+)
+{
+    return impl_->exec(req, first_handler, hedge_handler, diag);
+}
+
+std::chrono::steady_clock::duration co_hedged_executor::delay() const { return impl_->tracker.delay(); }
+
+hedging_stats co_hedged_executor::stats() const { return impl_->tracker.stats(); }
@@ -5,19 +5,24 @@
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 //
 
+#include <boost/capy/buffers.hpp>
 #include <boost/capy/buffers/make_buffer.hpp>
 #include <boost/capy/cond.hpp>
 #include <boost/capy/delay.hpp>
 #include <boost/capy/error.hpp>
 #include <boost/capy/ex/async_event.hpp>
+#include <boost/capy/ex/run.hpp>
 #include <boost/capy/ex/this_coro.hpp>
 #include <boost/capy/io_task.hpp>
+#include <boost/capy/task.hpp>
 #include <boost/capy/when_any.hpp>
 #include <boost/capy/write.hpp>
 
 #include <memory>
+#include <stop_token>
 #include <system_error>
 #include <utility>
+#include <vector>
 
 #include "nativepg/client_errc.hpp"
 #include "nativepg/co_connection.hpp"
@@ -36,23 +41,27 @@ struct nativepg::co_multiplexed_connection::impl
     co_connection conn;
     detail::multiplexer mpx;
     capy::async_event write_evt;
-    detail::notification_queue notif_queue{256u};  // TODO: make configurable
+    capy::async_event write_done_evt;  // set while no write is in progress
+    detail::notification_queue notif_queue{multiplexed_config{}.max_pending_notifications};
+    notification_batch notif_scratch;  // used by read_notifications(vector)
+    bool deduplicate_reads{};
 
-    explicit impl(boost::capy::execution_context& ctx) : conn(ctx) {}
+    explicit impl(boost::capy::execution_context& ctx) : conn(ctx) { write_done_evt.set(); }
 
     // These tasks don't return an error code so when_any
     // finishes when they return
     capy::io_task<> writer()
     {
         auto& stream = conn.stream();
+        std::vector<capy::const_buffer> buffers;
 
         while (true)
         {
             // Attempt to prepare any pending requests
-            auto buff = mpx.prepare_write();
+            auto chunks = mpx.prepare_write();
 
             // No more requests to write. Wait for more
-            if (buff.empty())
+            if (chunks.empty())
             {
                 write_evt.clear();
                 auto [ec] = co_await write_evt.wait();
@@ -63,7 +72,16 @@ struct nativepg::co_multiplexed_connection::impl
 
             // Write the request.
             // TODO: this will have to change once we implement health checks
-            auto [ec, bytes] = co_await capy::write(stream, capy::make_buffer(buff));
+            // Requests are written as a gather list, so borrowed parameter values are not copied.
+            buffers.clear();
+            for (auto chunk : chunks)
+                buffers.push_back(capy::make_buffer(chunk));
+            write_done_evt.clear();
+            auto [ec, bytes] = co_await capy::write(stream, buffers);
+
+            // Cancelled requests waiting for their borrowed values to be released can complete now
+            mpx.on_write_finished();
+            write_done_evt.set();
             if (ec)
                 co_return {};
         }
@@ -102,15 +120,9 @@ struct nativepg::co_multiplexed_connection::impl
                 // Account for the message bytes
                 consumed += res.size;
 
-                // Handle notifications
-                // TODO: although this is a valid backpressure strategy,
-                // it interacts poorly with running requests in the same coroutine.
-                // This is known in Boost.Redis. I'd like to make it better. Options include
-                //    a. Let exec() and read_notifies() handle run()'s work. This buys built-in
-                //       backpressure, but eliminates the option of built-in health-checks.
-                //    b. Make exec() unblock the reader if it's waiting for a message.
-                //       Makes the upper limit soft. May need to tear down the connection
-                //       if too many notifications stack.
+                // Handle notifications. Only waits if the overflow policy is block.
+                // Other policies discard notifications instead, so a slow consumer
+                // never delays responses to requests running in this connection
                 if (res.message.type() == protocol::any_backend_message::kind::notification_response)
                 {
                     const auto& notif_msg = res.message.get_notification_response();
@@ -134,6 +146,14 @@ struct nativepg::co_multiplexed_connection::impl
     capy::io_task<> run(multiplexed_config cfg)
     {
         auto tok = co_await capy::this_coro::stop_token;
+        notif_queue.set_config(
+            cfg.max_pending_notifications,
+            cfg.notification_overflow,
+            cfg.max_spilled_notifications
+        );
+        conn.set_resolve_cache(cfg.resolve_cache);
+        deduplicate_reads = cfg.deduplicate_reads;
+        mpx.set_write_limits(cfg.max_write_size, cfg.max_deferred_writes);
 
         while (true)
         {
@@ -170,7 +190,12 @@ struct nativepg::co_multiplexed_connection::impl
         }
     }
 
-    boost::capy::io_task<> exec(const request& req, response_handler_ref handler, diagnostics* diag = nullptr)
+    boost::capy::io_task<> exec(
+        const request& req,
+        response_handler_ref handler,
+        diagnostics* diag,
+        request_priority priority
+    )
     {
         // Check that the request is valid
         if (auto req_ec = protocol::detail::setup_request(req, handler))
@@ -185,8 +210,15 @@ struct nativepg::co_multiplexed_connection::impl
             done_event.set();
         };
 
-        // Add the request to the multiplexer
-        auto* elm = mpx.add(&req, handler, on_done);
+        // Add the request to the multiplexer. Shared executions copy the request,
+        // which doesn't extend the lifetime of borrowed values, so these are never shared
+        const bool shared = deduplicate_reads && req.idempotent_read() && !req.has_borrowed_values();
+        detail::multiplexer_elem* elm = nullptr;
+        detail::shared_ticket ticket{};
+        if (shared)
+            ticket = mpx.add_shared(&req, handler, on_done, priority);
+        else
+            elm = mpx.add(&req, handler, on_done, priority);
 
         // Signal the writer that it has job to be done
         write_evt.set();
@@ -206,7 +238,23 @@ struct nativepg::co_multiplexed_connection::impl
         }
         else
         {
-            mpx.cancel(elm);
+            // Shared requests never have borrowed values
+            const bool wait_write = !shared && mpx.borrowed_values_in_use(elm);
+            if (shared)
+                mpx.cancel(ticket);
+            else
+                mpx.cancel(elm);
+
+            // The write in progress references borrowed values. Wait until it finishes, so the caller
+            // may free them once we return. We need to replace the stop token so this has any effect
+            if (wait_write)
+            {
+                co_await capy::run(std::stop_token())([this]() -> capy::task<> {
+                    auto [ec] = co_await write_done_evt.wait();
+                    BOOST_ASSERT(!ec);
+                    static_cast<void>(ec);
+                }());
+            }
             co_return {boost::capy::error::canceled};
         }
     }
@@ -231,15 +279,25 @@ boost::capy::io_task<> nativepg::co_multiplexed_connection::run(multiplexed_conf
 boost::capy::io_task<> nativepg::co_multiplexed_connection::exec(
     const request& req,
     response_handler_ref handler,
-    diagnostics* diag
+    diagnostics* diag,
+    request_priority priority
 )
 {
-    return impl_->exec(req, handler, diag);
+    return impl_->exec(req, handler, diag, priority);
+}
+
+boost::capy::io_task<> nativepg::co_multiplexed_connection::read_notifications(notification_batch& output)
+{
+    return impl_->notif_queue.read_events(output);
 }
 
 boost::capy::io_task<> nativepg::co_multiplexed_connection::read_notifications(
     std::vector<notification_event>& output
 )
 {
-    return impl_->notif_queue.read_events(output);
+    auto& batch = impl_->notif_scratch;
+    if (auto [ec] = co_await impl_->notif_queue.read_events(batch); ec)
+        co_return {ec};
+    output.assign(batch.begin(), batch.end());
+    co_return {};
 }
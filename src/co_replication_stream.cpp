@@ -0,0 +1,185 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/assert.hpp>
+#include <boost/capy/buffers/make_buffer.hpp>
+#include <boost/capy/cond.hpp>
+#include <boost/capy/delay.hpp>
+#include <boost/capy/io_task.hpp>
+#include <boost/capy/when_any.hpp>
+#include <boost/capy/write.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/co_connection.hpp"
+#include "nativepg/co_replication_stream.hpp"
+#include "nativepg/protocol/detail/replication_fsm.hpp"
+#include "nativepg/protocol/replication.hpp"
+#include "nativepg/replication_params.hpp"
+
+namespace capy = boost::capy;
+
+namespace nativepg {
+
+struct co_replication_stream::impl
+{
+    using fsm_type = protocol::detail::replication_fsm;
+    using clock_type = std::chrono::steady_clock;
+
+    co_connection* conn;
+    std::optional<fsm_type> fsm;
+    fsm_type::result res{boost::system::error_code()};
+
+    explicit impl(co_connection& c) noexcept : conn(&c) {}
+
+    // The tasks used to read with a deadline. Like in the multiplexer, results are reported
+    // out of band, so when_any finishes when either of them completes
+    capy::io_task<> read_task(
+        std::span<unsigned char> buff,
+        boost::system::error_code& ec,
+        std::size_t& bytes
+    )
+    {
+        auto [read_ec, read_bytes] = co_await conn->stream().read_some(capy::make_buffer(buff));
+        ec = read_ec;
+        bytes = read_bytes;
+        co_return {};
+    }
+
+    capy::io_task<> timer_task(clock_type::duration timeout, bool& timed_out)
+    {
+        auto [ec] = co_await capy::delay(timeout);
+        timed_out = !ec;
+        co_return {};
+    }
+
+    // Performs the read requested by the FSM. If the next status update is due before
+    // any data arrives, resumes the FSM without data, so it can send it
+    capy::io_task<> do_read()
+    {
+        boost::system::error_code ec;
+        std::size_t bytes = 0u;
+        bool timed_out = false;
+        const auto timeout = fsm->next_status_time() - clock_type::now();
+        if (timeout > clock_type::duration::zero())
+        {
+            [[maybe_unused]] auto when_any_res = co_await capy::when_any(
+                read_task(res.read_buffer(), ec, bytes),
+                timer_task(timeout, timed_out)
+            );
+        }
+        else
+        {
+            timed_out = true;
+        }
+
+        // A read cancelled because of the timer is not an error
+        if (timed_out && ec == capy::cond::canceled)
+            ec = {};
+        res = fsm->resume(conn->state(), ec, bytes, clock_type::now());
+        co_return {};
+    }
+
+    // Runs the FSM until it yields a result for the user
+    capy::io_task<> run_fsm()
+    {
+        while (true)
+        {
+            switch (res.type())
+            {
+                case fsm_type::result_type::write:
+                {
+                    auto [ec, bytes] = co_await capy::write(
+                        conn->stream(),
+                        capy::make_buffer(res.write_data())
+                    );
+                    res = fsm->resume(conn->state(), ec, bytes, clock_type::now());
+                    break;
+                }
+                case fsm_type::result_type::read: co_await do_read(); break;
+                default: co_return {};
+            }
+        }
+    }
+
+    capy::io_task<> start(const logical_replication_params& params)
+    {
+        fsm.emplace(params);
+        res = fsm->resume(conn->state(), {}, 0u, clock_type::now());
+        co_await run_fsm();
+        switch (res.type())
+        {
+            // Data may have arrived together with CopyBothResponse, so resuming is left to read()
+            case fsm_type::result_type::started: co_return {};
+            case fsm_type::result_type::done:
+            {
+                auto ec = res.error();
+                fsm.reset();
+                co_return {ec ? ec : boost::system::error_code(client_errc::unexpected_message)};
+            }
+            default: BOOST_ASSERT(false); co_return {};
+        }
+    }
+
+    capy::io_task<std::span<const protocol::xlog_data>> read()
+    {
+        // The stream has ended
+        if (!fsm.has_value())
+            co_return {{}, {}};
+
+        // Resuming the FSM consumes the previous batch and may move the read buffer,
+        // so this is deferred until the user is done with the batch
+        if (res.type() == fsm_type::result_type::started || res.type() == fsm_type::result_type::data)
+            res = fsm->resume(conn->state(), {}, 0u, clock_type::now());
+
+        co_await run_fsm();
+        switch (res.type())
+        {
+            case fsm_type::result_type::data: co_return {{}, res.xlog_messages()};
+            case fsm_type::result_type::done:
+            {
+                auto ec = res.error();
+                fsm.reset();
+                co_return {ec, {}};
+            }
+            default: BOOST_ASSERT(false); co_return {};
+        }
+    }
+};
+
+co_replication_stream::co_replication_stream(co_connection& conn) : impl_(std::make_unique<impl>(conn)) {}
+
+co_replication_stream::co_replication_stream(co_replication_stream&&) noexcept = default;
+co_replication_stream& co_replication_stream::operator=(co_replication_stream&&) noexcept = default;
+co_replication_stream::~co_replication_stream() = default;
+
+capy::io_task<> co_replication_stream::start(const logical_replication_params& params)
+{
+    return impl_->start(params);
+}
+
+capy::io_task<std::span<const protocol::xlog_data>> co_replication_stream::read() { return impl_->read(); }
+
+void co_replication_stream::confirm(protocol::lsn_t lsn) noexcept
+{
+    if (impl_->fsm)
+        impl_->fsm->confirm(lsn);
+}
+
+void co_replication_stream::stop() noexcept
+{
+    if (impl_->fsm)
+        impl_->fsm->request_stop();
+}
+
+}  // namespace nativepg
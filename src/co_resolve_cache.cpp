@@ -0,0 +1,94 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/capy/cond.hpp>
+#include <boost/capy/delay.hpp>
+#include <boost/capy/ex/async_event.hpp>
+#include <boost/capy/ex/execution_context.hpp>
+#include <boost/capy/io_task.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nativepg/co_resolve_cache.hpp"
+#include "nativepg/connect_params.hpp"
+#include "nativepg/resolve_cache_params.hpp"
+#include "nativepg_internal/resolve_cache/co_resolve_cache_impl.hpp"
+
+namespace capy = boost::capy;
+using namespace nativepg;
+
+namespace {
+
+void check_resolve_cache_params(const resolve_cache_params& params)
+{
+    const char* msg = nullptr;
+    if (params.ttl.count() <= 0)
+        msg = "resolve_cache_params::ttl must be greater than zero";
+    else if (params.negative_ttl.count() < 0)
+        msg = "resolve_cache_params::negative_ttl must not be negative";
+    else if (params.refresh_ahead.count() < 0 || params.refresh_ahead >= params.ttl)
+        msg = "resolve_cache_params::refresh_ahead must be non-negative and less than ttl";
+
+    if (msg != nullptr)
+    {
+        BOOST_THROW_EXCEPTION(std::invalid_argument(msg));
+    }
+}
+
+}  // namespace
+
+co_resolve_cache::co_resolve_cache(capy::execution_context& ctx, resolve_cache_params params)
+{
+    check_resolve_cache_params(params);
+    impl_ = std::make_unique<detail::co_resolve_cache_impl>(ctx, params);
+}
+
+co_resolve_cache::co_resolve_cache(co_resolve_cache&&) noexcept = default;
+
+co_resolve_cache& co_resolve_cache::operator=(co_resolve_cache&&) noexcept = default;
+
+co_resolve_cache::~co_resolve_cache() = default;
+
+capy::io_task<> co_resolve_cache::run()
+{
+    auto& impl = *impl_;
+
+    // Nothing to do. Wait until cancelled
+    if (impl.params.refresh_ahead.count() == 0)
+    {
+        capy::async_event never_ev;
+        auto [ec] = co_await never_ev.wait();
+        co_return {ec};
+    }
+
+    // Checking twice per refresh_ahead period guarantees that entries are seen before expiring
+    std::vector<host_address> to_refresh;
+    while (true)
+    {
+        auto [ec] = co_await capy::delay(impl.params.refresh_ahead / 2);
+        if (ec)
+            co_return {ec};
+
+        impl.table.collect_refreshes(std::chrono::steady_clock::now(), to_refresh);
+        for (const auto& addr : to_refresh)
+        {
+            // Failed refreshes keep the old entry until it expires. A transient resolver
+            // failure shouldn't prevent connecting to a host that was resolved fine
+            const auto port = std::to_string(addr.port);
+            auto [ec2, results] = co_await impl.refresh_resolv.resolve(addr.hostname, port);
+            if (ec2 == capy::cond::canceled)
+                co_return {ec2};
+            if (!ec2)
+                impl.on_resolved(addr.hostname, addr.port, ec2, results);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/capy/io_task.hpp>
+
+#include "nativepg/co_multiplexed_connection.hpp"
+#include "nativepg/co_result_cache.hpp"
+#include "nativepg/extended_error.hpp"
+#include "nativepg/notification_event.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response.hpp"
+#include "nativepg/response_handler.hpp"
+#include "nativepg/result_cache.hpp"
+#include "nativepg/subscription_registry.hpp"
+
+namespace capy = boost::capy;
+using namespace nativepg;
+
+capy::io_task<> nativepg::exec_cached(
+    co_multiplexed_connection& conn,
+    result_cache& cache,
+    const request& req,
+    response_handler_ref handler,
+    const cache_options& opts,
+    diagnostics* diag
+)
+{
+    // Hits don't perform any I/O
+    if (auto res = cache.replay(req, handler))
+        co_return {*res};
+
+    // The recorder captures the cache's generation before the request is sent,
+    // so responses racing with an invalidation are not stored
+    auto recorder = cache.make_recorder(handler);
+    auto [ec] = co_await conn.exec(req, response_handler_ref(&recorder), diag);
+    if (!ec)
+        cache.store(req, recorder, opts);
+    co_return {ec};
+}
+
+capy::io_task<> nativepg::run_cache_invalidation(co_multiplexed_connection& conn, result_cache& cache)
+{
+    subscription_registry registry;
+    registry.subscribe(
+        cache.params().invalidation_channel,
+        [&cache](const notification_view& notif) { cache.on_notification(notif); }
+    );
+    notification_batch events;
+
+    while (true)
+    {
+        // Listen initially and after reconnecting. Invalidations issued before the LISTEN
+        // took effect were missed, so the cache is cleared once it succeeds.
+        // If this fails, we retry after the next batch of notifications
+        request req;
+        if (registry.prepare_sync(req))
+        {
+            auto [ec] = co_await conn.exec(req, check());
+            registry.on_sync_finished(!ec);
+            if (!ec)
+                cache.clear();
+        }
+
+        if (auto [ec] = co_await conn.read_notifications(events); ec)
+            co_return {ec};
+
+        // Notifications may have been lost
+        if (events.num_dropped() > 0u)
+            cache.clear();
+
+        for (auto evt : events)
+        {
+            // A new physical connection isn't listening to the channel
+            if (evt.type == notification_event_type::connect)
+                registry.on_connect();
+            else
+                registry.dispatch(evt);
+        }
+    }
+}
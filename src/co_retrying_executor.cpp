@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/capy/delay.hpp>
+#include <boost/capy/io_task.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "nativepg/co_connection.hpp"
+#include "nativepg/co_multiplexed_connection.hpp"
+#include "nativepg/co_retrying_executor.hpp"
+#include "nativepg/extended_error.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+#include "nativepg/retry_params.hpp"
+#include "nativepg_internal/retry/retry_tracker.hpp"
+
+namespace capy = boost::capy;
+using namespace nativepg;
+
+namespace {
+
+void check_retry_params(const retry_params& params)
+{
+    const char* msg = nullptr;
+    if (params.max_attempts == 0u)
+        msg = "retry_params::max_attempts must be greater than zero";
+    else if (params.initial_backoff.count() < 0 || params.initial_backoff > params.max_backoff)
+        msg = "retry_params::initial_backoff must be non-negative and less than or equal to max_backoff";
+    else if (!(params.backoff_multiplier >= 1.0))
+        msg = "retry_params::backoff_multiplier must be greater than or equal to one";
+    else if (!(params.retry_ratio >= 0.0))
+        msg = "retry_params::retry_ratio must be non-negative";
+    else if (!(params.max_retry_tokens >= 0.0))
+        msg = "retry_params::max_retry_tokens must be non-negative";
+
+    if (msg != nullptr)
+    {
+        BOOST_THROW_EXCEPTION(std::invalid_argument(msg));
+    }
+}
+
+}  // namespace
+
+struct nativepg::co_retrying_executor::impl
+{
+    detail::retry_tracker tracker;
+    std::minstd_rand rng{std::random_device{}()};
+    std::uniform_real_distribution<double> jitter{0.0, 1.0};
+
+    explicit impl(const retry_params& params) : tracker(params) { check_retry_params(params); }
+
+    // co_connection and co_multiplexed_connection have the same exec signature
+    template <class Connection>
+    capy::io_task<std::size_t> exec(
+        Connection& conn,
+        const request& req,
+        response_handler_ref handler,
+        diagnostics* diag
+    )
+    {
+        tracker.on_request_started();
+        std::size_t num_attempts = 0u;
+
+        while (true)
+        {
+            // exec sets up the handler, so no state from previous attempts remains
+            auto [ec] = co_await conn.exec(req, handler, diag);
+            ++num_attempts;
+            if (!ec || !tracker.on_failure(num_attempts, ec))
+                co_return {ec, num_attempts};
+
+            // Back off. Only fails if we're cancelled
+            auto [ec_wait] = co_await capy::delay(tracker.backoff(num_attempts, jitter(rng)));
+            if (ec_wait)
+                co_return {ec_wait, num_attempts};
+        }
+    }
+};
+
+co_retrying_executor::co_retrying_executor(retry_params params) : impl_(std::make_unique<impl>(params)) {}
+
+co_retrying_executor::co_retrying_executor(co_retrying_executor&&) noexcept = default;
+
+co_retrying_executor& co_retrying_executor::operator=(co_retrying_executor&&) noexcept = default;
+
+co_retrying_executor::~co_retrying_executor() = default;
+
+capy::io_task<std::size_t> co_retrying_executor::exec(
+    co_connection& conn,
+    const request& req,
+    response_handler_ref handler,
+    diagnostics* diag
+)
+{
+    return impl_->exec(conn, req, handler, diag);
+}
+
+capy::io_task<std::size_t> co_retrying_executor::exec(
+    co_multiplexed_connection& conn,
+    const request& req,
+    response_handler_ref handler,
+    diagnostics* diag
+)
+{
+    return impl_->exec(conn, req, handler, diag);
+}
+
+retry_stats co_retrying_executor::stats() const { return impl_->tracker.stats(); }
@@ -0,0 +1,324 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/assert.hpp>
+#include <boost/capy/cond.hpp>
+#include <boost/capy/delay.hpp>
+#include <boost/capy/error.hpp>
+#include <boost/capy/ex/async_event.hpp>
+#include <boost/capy/ex/execution_context.hpp>
+#include <boost/capy/ex/io_env.hpp>
+#include <boost/capy/ex/run.hpp>
+#include <boost/capy/ex/run_async.hpp>
+#include <boost/capy/ex/this_coro.hpp>
+#include <boost/capy/io_task.hpp>
+#include <boost/capy/task.hpp>
+#include <boost/capy/timeout.hpp>
+#include <boost/capy/when_any.hpp>
+#include <boost/describe/class.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <stop_token>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/co_connection.hpp"
+#include "nativepg/co_connection_pool.hpp"
+#include "nativepg/co_routing_pool.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response.hpp"
+#include "nativepg/routing_params.hpp"
+#include "nativepg_internal/routing_pool/host_selector.hpp"
+
+namespace capy = boost::capy;
+using namespace nativepg;
+
+namespace {
+
+// Result of the role check query
+struct role_check_row
+{
+    bool in_recovery;
+    std::int64_t lsn;
+};
+BOOST_DESCRIBE_STRUCT(role_check_row, (), (in_recovery, lsn))
+
+// Replicas report the replayed WAL position, primaries the written one.
+// CASE evaluates lazily, and pg_current_wal_lsn() fails in replicas
+constexpr std::string_view role_check_query =
+    "SELECT pg_is_in_recovery() AS in_recovery, pg_wal_lsn_diff("
+    "CASE WHEN pg_is_in_recovery() THEN COALESCE(pg_last_wal_replay_lsn(), '0/0') "
+    "ELSE pg_current_wal_lsn() END, '0/0')::int8 AS lsn";
+
+void check_routing_pool_params(const routing_pool_params& params)
+{
+    const char* msg = nullptr;
+    if (params.hosts.empty())
+        msg = "routing_pool_params::hosts must not be empty";
+    else if (params.role_check_interval.count() <= 0)
+        msg = "routing_pool_params::role_check_interval must be greater than zero";
+
+    if (msg != nullptr)
+    {
+        BOOST_THROW_EXCEPTION(std::invalid_argument(msg));
+    }
+}
+
+pool_params make_host_pool_params(const routing_pool_params& params, std::size_t host_index)
+{
+    pool_params res = params.pool;
+    res.transport = params.hosts[host_index];
+    return res;
+}
+
+}  // namespace
+
+namespace nativepg::detail {
+
+class co_routing_pool_impl
+{
+    enum class state_t
+    {
+        initial,
+        running,
+        cancelled,
+    };
+
+    // Role checks run on a dedicated connection per host. Using pooled connections would make
+    // them wait behind user traffic, so loaded hosts would fail the check and drop out of routing
+    struct role_checker
+    {
+        co_connection conn;
+        bool connected{};
+    };
+
+    routing_pool_params params_;
+    state_t state_{state_t::initial};
+    std::vector<co_connection_pool> pools_;
+    std::vector<role_checker> checkers_;
+    std::vector<host_status> hosts_;
+    request role_check_req_;
+    std::size_t num_checked_{};
+    std::size_t num_running_{};
+    capy::async_event roles_checked_ev_;  // set once all hosts have been checked
+    capy::async_event stop_ev_;           // never set. Waited on to detect cancellation
+    capy::async_event cancel_ev_;
+    capy::async_event children_finished_ev_;
+
+    // Runs a child task until the pool is cancelled
+    capy::task<> run_child(capy::io_task<> child)
+    {
+        [[maybe_unused]] auto res = co_await capy::when_any(std::move(child), cancel_ev_.wait());
+        if (--num_running_ == 0u)
+            children_finished_ev_.set();
+    }
+
+    // As in co_connection_pool, this is safe because run() doesn't finish
+    // until all children have exited
+    void launch(const capy::io_env* env, capy::io_task<> child)
+    {
+        ++num_running_;
+        capy::run_async(env->executor, env->frame_allocator)(run_child(std::move(child)));
+    }
+
+    // Like in connection_node, a zero timeout disables it
+    static capy::io_task<> with_timeout(capy::io_task<> op, std::chrono::steady_clock::duration timeout)
+    {
+        if (timeout.count() > 0)
+        {
+            co_return co_await capy::timeout(std::move(op), timeout);
+        }
+        else
+        {
+            co_return co_await std::move(op);
+        }
+    }
+
+    // Connects the host's role checker if required, and runs the role check query.
+    // Only the query is timed, so latency measures the server's round-trip time
+    capy::io_task<> check_role_once(
+        std::size_t host_index,
+        role_check_row& row,
+        std::chrono::steady_clock::duration& latency
+    )
+    {
+        auto& checker = checkers_[host_index];
+        if (!checker.connected)
+        {
+            auto [ec] = co_await with_timeout(
+                checker.conn.connect(params_.hosts[host_index]),
+                params_.pool.connect_timeout
+            );
+            if (ec)
+                co_return {ec};
+            checker.connected = true;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto [ec] = co_await with_timeout(
+            checker.conn.exec(
+                role_check_req_,
+                resultset_callback<role_check_row>([&row](role_check_row&& r) { row = r; })
+            ),
+            params_.pool.ping_timeout
+        );
+        latency = std::chrono::steady_clock::now() - start;
+
+        // The connection's state is unknown after a failure. Reconnect on the next check
+        if (ec)
+            checker.connected = false;
+        co_return {ec};
+    }
+
+    // Periodically checks a host's role
+    capy::io_task<> check_role(std::size_t host_index)
+    {
+        auto tok = co_await capy::this_coro::stop_token;
+        while (true)
+        {
+            role_check_row row{};
+            std::chrono::steady_clock::duration latency{};
+            auto [ec] = co_await check_role_once(host_index, row, latency);
+            if (tok.stop_requested())
+                co_return {};
+
+            // Record the outcome
+            auto& host = hosts_[host_index];
+            const bool first = !host.checked;
+            if (ec)
+            {
+                on_role_check_failed(host);
+            }
+            else
+            {
+                const auto lsn = static_cast<protocol::lsn_t>(row.lsn);
+                on_role_checked(host, row.in_recovery, lsn, latency);
+            }
+            if (first && ++num_checked_ == hosts_.size())
+                roles_checked_ev_.set();
+
+            // Wait until the next check
+            auto [ec2] = co_await capy::delay(params_.role_check_interval);
+            if (ec2)
+                co_return {};
+        }
+    }
+
+public:
+    co_routing_pool_impl(capy::execution_context& ctx, routing_pool_params&& params)
+        : params_(std::move(params)), hosts_(params_.hosts.size())
+    {
+        check_routing_pool_params(params_);
+        pools_.reserve(params_.hosts.size());
+        checkers_.reserve(params_.hosts.size());
+        for (std::size_t i = 0u; i < params_.hosts.size(); ++i)
+        {
+            pools_.emplace_back(ctx, make_host_pool_params(params_, i));
+            checkers_.push_back({co_connection(ctx)});
+        }
+        role_check_req_.add_query(role_check_query, {});
+    }
+
+    capy::io_task<> run()
+    {
+        // Check that we're not running and set the state adequately
+        BOOST_ASSERT(state_ == state_t::initial);
+        state_ = state_t::running;
+
+        const auto* env = co_await capy::this_coro::environment;
+
+        // Run the pools and the role checks
+        for (std::size_t i = 0u; i < pools_.size(); ++i)
+        {
+            launch(env, pools_[i].run());
+            launch(env, check_role(i));
+        }
+
+        // Wait until we're cancelled
+        auto [ec] = co_await stop_ev_.wait();
+        BOOST_ASSERT(ec == capy::cond::canceled);
+        static_cast<void>(ec);
+
+        // Set the state so further get_connection requests fail, and wake up any waiters
+        state_ = state_t::cancelled;
+        roles_checked_ev_.set();
+
+        // Deliver the cancel notification to the child tasks, and wait for them to exit.
+        // We need to replace the stop token so this has any effect.
+        cancel_ev_.set();
+        co_await capy::run(std::stop_token())([this]() -> capy::task<> {
+            auto [ec2] = co_await children_finished_ev_.wait();
+            BOOST_ASSERT(!ec2);
+            static_cast<void>(ec2);
+        }());
+
+        // Done
+        co_return {capy::error::canceled};
+    }
+
+    capy::io_task<routed_connection> get_connection(route_options opts)
+    {
+        // Routing decisions require knowing the roles
+        if (state_ != state_t::cancelled && num_checked_ < hosts_.size())
+        {
+            auto [ec] = co_await roles_checked_ev_.wait();
+            if (ec)
+                co_return {ec, {}};
+        }
+
+        // If the pool is cancelled, the operation must fail
+        if (state_ == state_t::cancelled)
+            co_return {capy::error::canceled, {}};
+
+        // Choose a host
+        const auto host_index = select_host(hosts_, opts, params_.balancing, params_.fallback_to_primary);
+        if (host_index == no_host)
+            co_return {client_errc::no_suitable_host, {}};
+
+        // Requests waiting for a connection also count as load
+        auto& in_use = hosts_[host_index].in_use;
+        ++in_use;
+        auto [ec, conn] = co_await pools_[host_index].get_connection();
+        if (ec)
+        {
+            --in_use;
+            co_return {ec, {}};
+        }
+        co_return {{}, routed_connection(std::move(conn), in_use, host_index)};
+    }
+
+    host_role role(std::size_t host_index) const { return hosts_.at(host_index).role; }
+};
+
+}  // namespace nativepg::detail
+
+co_routing_pool::co_routing_pool(capy::execution_context& ctx, routing_pool_params&& params, int)
+    : impl_(std::make_unique<detail::co_routing_pool_impl>(ctx, std::move(params)))
+{
+}
+
+co_routing_pool::co_routing_pool(co_routing_pool&&) noexcept = default;
+
+co_routing_pool& co_routing_pool::operator=(co_routing_pool&&) noexcept = default;
+
+co_routing_pool::~co_routing_pool() = default;
+
+capy::io_task<> co_routing_pool::run() { return impl_->run(); }
+
+capy::io_task<routed_connection> co_routing_pool::get_connection(route_options opts)
+{
+    return impl_->get_connection(opts);
+}
+
+host_role co_routing_pool::role(std::size_t host_index) const { return impl_->role(host_index); }
@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/capy/io_task.hpp>
+
+#include "nativepg/co_subscriber.hpp"
+#include "nativepg/notification_event.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response.hpp"
+
+using namespace nativepg;
+
+boost::capy::io_task<> co_subscriber::sync()
+{
+    request req;
+    if (!registry_.prepare_sync(req))
+        co_return {};
+
+    auto [ec] = co_await conn_->exec(req, check());
+    registry_.on_sync_finished(!ec);
+    co_return {ec};
+}
+
+boost::capy::io_task<> co_subscriber::run()
+{
+    // The connection may have been established before we started reading,
+    // in which case we won't see its connect event. Listen to the channels
+    // subscribed so far. If this fails, we will retry as described below
+    co_await sync();
+
+    while (true)
+    {
+        if (auto [ec] = co_await conn_->read_notifications(events_); ec)
+            co_return {ec};
+
+        for (auto evt : events_)
+        {
+            // A new physical connection isn't listening to any channel
+            if (evt.type == notification_event_type::connect)
+                registry_.on_connect();
+            else
+                registry_.dispatch(evt);
+        }
+
+        // Listen again after reconnecting, and apply any changes made by handlers.
+        // If this fails, the registry will retry on the next sync. If the connection
+        // was lost, we will listen again when it's re-established
+        if (registry_.needs_sync())
+            co_await sync();
+    }
+}
@@ -56,6 +56,8 @@ static const char* error_to_string(client_errc error)
             return "request_mixes_simple_advanced_protocols";
         case client_errc::step_skipped: return "step_skipped";
         case client_errc::unknown_openssl_error: return "unknown_openssl_error";
+        case client_errc::no_suitable_host: return "no_suitable_host";
+        case client_errc::invalid_transaction: return "invalid_transaction";
         default: return "<unknown nativepg client error>";
     }
 }
@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+
+#include "coroutine.hpp"
+#include "nativepg/client_errc.hpp"
+#include "nativepg/extended_error.hpp"
+#include "nativepg/protocol/connection_state.hpp"
+#include "nativepg/protocol/detail/exec_batch_fsm.hpp"
+#include "nativepg/protocol/parse_message.hpp"
+#include "nativepg/protocol/read_response_fsm.hpp"
+#include "nativepg_internal/check_request.hpp"
+#include "nativepg_internal/deliver_message.hpp"
+
+using namespace nativepg::protocol;
+using boost::system::error_code;
+using detail::exec_batch_fsm;
+using nativepg::client_errc;
+using nativepg::extended_error;
+
+// Sets the result of all the requests that haven't completed yet
+error_code exec_batch_fsm::fail_pending(error_code ec)
+{
+    for (std::size_t i = current_; i < items_.size(); ++i)
+    {
+        if (!items_[i].result.code)
+            items_[i].result = extended_error{ec, {}};
+    }
+    return ec;
+}
+
+exec_batch_fsm::result exec_batch_fsm::resume(
+    connection_state& st,
+    boost::system::error_code ec,
+    std::size_t bytes_transferred
+)
+{
+    read_response_fsm::result res{{}};
+    parse_message_result msg_res;
+    bool any_valid = false;
+
+    switch (resume_point_)
+    {
+        NATIVEPG_CORO_INITIAL
+
+        // Initial checkings. Invalid requests are not sent
+        for (auto& item : items_)
+        {
+            item.result = extended_error{setup_request(*item.req, item.handler), {}};
+            any_valid = any_valid || !item.result.code;
+        }
+        if (!any_valid)
+            return error_code();
+
+        // Write all the requests
+        NATIVEPG_YIELD(resume_point_, 1, result::write({}))
+        if (ec)
+            return fail_pending(ec);
+
+        // Read the responses, in order
+        for (current_ = 0u; current_ < items_.size(); ++current_)
+        {
+            if (items_[current_].result.code)
+                continue;
+            read_fsm_.emplace(items_[current_].req, items_[current_].handler);
+
+            while (true)
+            {
+                // Try to get a cached message
+                msg_res = parse_message(st.read_buffer.committed_area());
+                if (!msg_res.ec)
+                {
+                    // We have a message. Runs of rows are delivered in batches
+                    res = deliver_message(st, *read_fsm_, msg_res);
+                    if (res.type == read_response_fsm::result_type::done)
+                    {
+                        // An error here means that the connection is no longer usable
+                        if (res.ec)
+                            return fail_pending(res.ec);
+                        items_[current_].result = items_[current_].handler.result();
+                        break;
+                    }
+                }
+                else if (msg_res.ec == client_errc::needs_more)
+                {
+                    // Make space in the buffer, if required
+                    st.read_buffer.prepare(msg_res.size);
+
+                    // Read some data
+                    NATIVEPG_YIELD(resume_point_, 2, result::read(st.read_buffer.prepared_area()))
+
+                    // Check for errors
+                    if (ec)
+                        return fail_pending(ec);
+
+                    // Commit the data we were handed in
+                    st.read_buffer.commit(bytes_transferred);
+                }
+                else
+                {
+                    // An error occurred
+                    return fail_pending(msg_res.ec);
+                }
+            }
+        }
+
+        return error_code();
+    }
+
+    // We should never reach here
+    BOOST_ASSERT(false);
+    return boost::system::error_code();
+}
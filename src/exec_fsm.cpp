@@ -19,6 +19,7 @@
 #include "nativepg/protocol/startup_fsm.hpp"
 #include "nativepg/request.hpp"
 #include "nativepg_internal/check_request.hpp"
+#include "nativepg_internal/deliver_message.hpp"
 
 using namespace nativepg::protocol;
 using boost::system::error_code;
@@ -42,8 +43,8 @@ exec_fsm::result exec_fsm::resume(
         if (auto ec_req = setup_request(read_fsm_.get_request(), read_fsm_.get_handler()))
             return ec_req;
 
-        // Write the request
-        NATIVEPG_YIELD(resume_point_, 1, result::write(read_fsm_.get_request().payload()))
+        // Write the request. The caller gets the data to write using for_each_chunk
+        NATIVEPG_YIELD(resume_point_, 1, result::write({}))
         if (ec)
             return ec;
 
@@ -54,9 +55,8 @@ exec_fsm::result exec_fsm::resume(
             msg_res = parse_message(st.read_buffer.committed_area());
             if (!msg_res.ec)
             {
-                // We have a message
-                res = read_fsm_.resume(msg_res.message);
-                st.read_buffer.consume(msg_res.size);
+                // We have a message. Runs of rows are delivered in batches
+                res = deliver_message(st, read_fsm_, msg_res);
                 if (res.type == read_response_fsm::result_type::done)
                     return res.ec;
             }
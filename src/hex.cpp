@@ -0,0 +1,274 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/assert.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/detail/hex.hpp"
+
+// Vectorized paths are selected at compile time. SSE2 is part of the x86-64 baseline,
+// so it's always used there. AVX2 requires compiling with -mavx2 (or /arch:AVX2).
+#if defined(__AVX2__)
+#define NATIVEPG_HEX_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NATIVEPG_HEX_SSE2
+#endif
+
+#if defined(NATIVEPG_HEX_AVX2)
+#include <immintrin.h>
+#elif defined(NATIVEPG_HEX_SSE2)
+#include <emmintrin.h>
+#endif
+
+using namespace nativepg;
+
+namespace {
+
+// Forward table
+constexpr char alphabet[] = "0123456789abcdef";
+
+// Inverse table. -1 marks invalid characters
+constexpr signed char inverse_tab[] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //   0-15
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //  16-31
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //  32-47
+    0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  -1, -1, -1, -1, -1, -1,  //  48-63
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //  64-79
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //  80-95
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //  96-111
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 112-127
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 128-143
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 144-159
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 160-175
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 176-191
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 192-207
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 208-223
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 224-239
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1   // 240-255
+};
+
+// Scalar versions. Used when no SIMD is available and for the tails
+bool decode_scalar(const char* in, std::size_t num_pairs, unsigned char* out)
+{
+    for (std::size_t i = 0; i < num_pairs; ++i)
+    {
+        const int hi = inverse_tab[static_cast<unsigned char>(in[2 * i])];
+        const int lo = inverse_tab[static_cast<unsigned char>(in[2 * i + 1])];
+        if ((hi | lo) < 0)
+            return false;
+        out[i] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    return true;
+}
+
+void encode_scalar(const unsigned char* in, std::size_t size, char* out)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        out[2 * i] = alphabet[in[i] >> 4];
+        out[2 * i + 1] = alphabet[in[i] & 0x0f];
+    }
+}
+
+#if defined(NATIVEPG_HEX_SSE2)
+
+// Converts 16 hex characters into their nibble values (one per byte).
+// Bytes that are not valid hex characters are flagged with 0xff in invalid.
+// Characters >= 0x80 compare as negative, so they never fall within the valid ranges.
+inline __m128i decode_nibbles_sse2(__m128i c, __m128i& invalid)
+{
+    const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    const __m128i is_digit = _mm_and_si128(
+        _mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+        _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1))
+    );
+    const __m128i is_alpha = _mm_and_si128(
+        _mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+        _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1))
+    );
+    invalid = _mm_or_si128(invalid, _mm_andnot_si128(_mm_or_si128(is_digit, is_alpha), _mm_set1_epi8(-1)));
+    return _mm_or_si128(
+        _mm_and_si128(is_digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+        _mm_and_si128(is_alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)))
+    );
+}
+
+// Combines pairs of nibbles (hi, lo) stored in consecutive bytes into 8 bytes in the low half
+inline __m128i combine_nibbles_sse2(__m128i nib)
+{
+    // In each 16-bit lane, the first (high) nibble is in the low byte
+    const __m128i hi = _mm_and_si128(_mm_slli_epi16(nib, 4), _mm_set1_epi16(0x00f0));
+    const __m128i lo = _mm_srli_epi16(nib, 8);
+    return _mm_or_si128(hi, lo);
+}
+
+// Splits 16 bytes into 32 hex characters
+inline void encode_block_sse2(__m128i v, char* out)
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+    const __m128i lo = _mm_and_si128(v, mask);
+    const auto to_chars = [](__m128i nib) {
+        // '0' + nib for digits, 'a' + nib - 10 for letters
+        const __m128i letter_offset = _mm_and_si128(
+            _mm_cmpgt_epi8(nib, _mm_set1_epi8(9)),
+            _mm_set1_epi8('a' - '0' - 10)
+        );
+        return _mm_add_epi8(_mm_add_epi8(nib, _mm_set1_epi8('0')), letter_offset);
+    };
+    const __m128i hi_chars = to_chars(hi);
+    const __m128i lo_chars = to_chars(lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(hi_chars, lo_chars));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi_chars, lo_chars));
+}
+
+#endif
+
+#if defined(NATIVEPG_HEX_AVX2)
+
+// Same as the SSE2 versions, but operating on 32 characters at a time
+inline __m256i decode_nibbles_avx2(__m256i c, __m256i& invalid)
+{
+    const __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    const __m256i is_digit = _mm256_andnot_si256(
+        _mm256_cmpgt_epi8(c, _mm256_set1_epi8('9')),
+        _mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1))
+    );
+    const __m256i is_alpha = _mm256_andnot_si256(
+        _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('f')),
+        _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1))
+    );
+    invalid = _mm256_or_si256(
+        invalid,
+        _mm256_andnot_si256(_mm256_or_si256(is_digit, is_alpha), _mm256_set1_epi8(-1))
+    );
+    return _mm256_or_si256(
+        _mm256_and_si256(is_digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+        _mm256_and_si256(is_alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)))
+    );
+}
+
+inline __m256i combine_nibbles_avx2(__m256i nib)
+{
+    const __m256i hi = _mm256_and_si256(_mm256_slli_epi16(nib, 4), _mm256_set1_epi16(0x00f0));
+    const __m256i lo = _mm256_srli_epi16(nib, 8);
+    return _mm256_or_si256(hi, lo);
+}
+
+inline void encode_block_avx2(__m256i v, char* out)
+{
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), mask);
+    const __m256i lo = _mm256_and_si256(v, mask);
+    const auto to_chars = [](__m256i nib) {
+        const __m256i letter_offset = _mm256_and_si256(
+            _mm256_cmpgt_epi8(nib, _mm256_set1_epi8(9)),
+            _mm256_set1_epi8('a' - '0' - 10)
+        );
+        return _mm256_add_epi8(_mm256_add_epi8(nib, _mm256_set1_epi8('0')), letter_offset);
+    };
+    const __m256i hi_chars = to_chars(hi);
+    const __m256i lo_chars = to_chars(lo);
+
+    // Unpacking works within 128-bit lanes: fix the order afterwards
+    const __m256i first = _mm256_unpacklo_epi8(hi_chars, lo_chars);   // bytes 0-7, 16-23
+    const __m256i second = _mm256_unpackhi_epi8(hi_chars, lo_chars);  // bytes 8-15, 24-31
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(first, second, 0x20));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(out + 32),
+        _mm256_permute2x128_si256(first, second, 0x31)
+    );
+}
+
+#endif
+
+}  // namespace
+
+boost::system::error_code nativepg::detail::hex_decode(std::string_view input, unsigned char* output) noexcept
+{
+    BOOST_ASSERT(input.size() % 2u == 0u);
+
+    const char* in = input.data();
+    std::size_t remaining = input.size();
+
+#if defined(NATIVEPG_HEX_AVX2)
+    // 64 characters => 32 bytes per iteration
+    {
+        __m256i invalid = _mm256_setzero_si256();
+        for (; remaining >= 64u; remaining -= 64u, in += 64, output += 32)
+        {
+            const __m256i nib0 = decode_nibbles_avx2(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in)),
+                invalid
+            );
+            const __m256i nib1 = decode_nibbles_avx2(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 32)),
+                invalid
+            );
+            const __m256i packed = _mm256_packus_epi16(
+                combine_nibbles_avx2(nib0),
+                combine_nibbles_avx2(nib1)
+            );
+
+            // packus interleaves 64-bit chunks from both operands: restore the order
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), _mm256_permute4x64_epi64(packed, 0xd8));
+        }
+        if (!_mm256_testz_si256(invalid, invalid))
+            return client_errc::protocol_value_error;
+    }
+#endif
+
+#if defined(NATIVEPG_HEX_SSE2)
+    // 32 characters => 16 bytes per iteration
+    {
+        __m128i invalid = _mm_setzero_si128();
+        for (; remaining >= 32u; remaining -= 32u, in += 32, output += 16)
+        {
+            const __m128i nib0 = decode_nibbles_sse2(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)),
+                invalid
+            );
+            const __m128i nib1 = decode_nibbles_sse2(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)),
+                invalid
+            );
+            const __m128i packed = _mm_packus_epi16(combine_nibbles_sse2(nib0), combine_nibbles_sse2(nib1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), packed);
+        }
+        if (_mm_movemask_epi8(invalid) != 0)
+            return client_errc::protocol_value_error;
+    }
+#endif
+
+    if (!decode_scalar(in, remaining / 2u, output))
+        return client_errc::protocol_value_error;
+    return {};
+}
+
+void nativepg::detail::hex_encode(std::span<const unsigned char> input, char* output) noexcept
+{
+    const unsigned char* in = input.data();
+    std::size_t remaining = input.size();
+
+#if defined(NATIVEPG_HEX_AVX2)
+    for (; remaining >= 32u; remaining -= 32u, in += 32, output += 64)
+        encode_block_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in)), output);
+#endif
+
+#if defined(NATIVEPG_HEX_SSE2)
+    for (; remaining >= 16u; remaining -= 16u, in += 16, output += 32)
+        encode_block_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), output);
+#endif
+
+    encode_scalar(in, remaining, output);
+}
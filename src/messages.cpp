@@ -16,12 +16,14 @@
 
 #include <array>
 #include <charconv>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <optional>
 #include <span>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <system_error>
 #include <vector>
@@ -48,6 +50,7 @@
 #include "nativepg/protocol/parse_message.hpp"
 #include "nativepg/protocol/query.hpp"
 #include "nativepg/protocol/ready_for_query.hpp"
+#include "nativepg/protocol/replication.hpp"
 #include "nativepg/protocol/startup.hpp"
 #include "nativepg/protocol/sync.hpp"
 #include "nativepg/protocol/terminate.hpp"
@@ -942,6 +945,71 @@ boost::system::error_code nativepg::protocol::serialize(copy_done, std::vector<u
     return ctx.finalize_message();
 }
 
+std::string nativepg::protocol::format_lsn(lsn_t value)
+{
+    char buff[32];
+    auto res = std::to_chars(buff, buff + sizeof(buff), static_cast<std::uint32_t>(value >> 32u), 16);
+    *res.ptr++ = '/';
+    res = std::to_chars(res.ptr, buff + sizeof(buff), static_cast<std::uint32_t>(value), 16);
+    std::string out(buff, res.ptr);
+    for (char& c : out)
+    {
+        if (c >= 'a' && c <= 'f')
+            c = static_cast<char>(c - 'a' + 'A');
+    }
+    return out;
+}
+
+std::int64_t nativepg::protocol::to_replication_timestamp(std::chrono::system_clock::time_point tp)
+{
+    // Seconds between the UNIX epoch and 2000-01-01
+    constexpr std::int64_t pg_epoch_offset = 946684800;
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+    return static_cast<std::int64_t>(us) - pg_epoch_offset * 1000000;
+}
+
+boost::system::error_code nativepg::protocol::parse(boost::span<const unsigned char> data, xlog_data& to)
+{
+    detail::parse_context ctx(data);
+    if (ctx.get_byte() != xlog_data_message_type)
+        ctx.add_error(client_errc::unexpected_message);
+    to.wal_start = static_cast<lsn_t>(ctx.get_integral<std::int64_t>());
+    to.wal_end = static_cast<lsn_t>(ctx.get_integral<std::int64_t>());
+    to.send_time = ctx.get_integral<std::int64_t>();
+    to.data = ctx.get_bytes(ctx.error() ? 0u : ctx.size());
+    return ctx.check();
+}
+
+boost::system::error_code nativepg::protocol::parse(
+    boost::span<const unsigned char> data,
+    primary_keepalive& to
+)
+{
+    detail::parse_context ctx(data);
+    if (ctx.get_byte() != primary_keepalive_message_type)
+        ctx.add_error(client_errc::unexpected_message);
+    to.wal_end = static_cast<lsn_t>(ctx.get_integral<std::int64_t>());
+    to.send_time = ctx.get_integral<std::int64_t>();
+    to.reply_requested = ctx.get_byte() != 0u;
+    return ctx.check();
+}
+
+boost::system::error_code nativepg::protocol::serialize(
+    const standby_status_update& msg,
+    std::vector<unsigned char>& to
+)
+{
+    detail::serialization_context ctx(to);
+    ctx.add_header(static_cast<char>(copy_data_message_type));
+    ctx.add_byte('r');
+    ctx.add_integral(static_cast<std::int64_t>(msg.written_lsn));
+    ctx.add_integral(static_cast<std::int64_t>(msg.flushed_lsn));
+    ctx.add_integral(static_cast<std::int64_t>(msg.applied_lsn));
+    ctx.add_integral(msg.send_time);
+    ctx.add_byte(msg.reply_requested ? 1u : 0u);
+    return ctx.finalize_message();
+}
+
 boost::system::error_code nativepg::protocol::serialize(const execute& msg, std::vector<unsigned char>& to)
 {
     detail::serialization_context ctx(to);
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_CONNECT_RACE_TRACKER_HPP
+#define NATIVEPG_CONNECT_RACE_TRACKER_HPP
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+
+namespace nativepg::detail {
+
+// Decides when the attempts of a multi-host connect start and which one determines the outcome.
+// Attempts are identified by their index, and start in order. The first one starts immediately.
+// The next one starts once the stagger delay elapses or the previous one fails, whatever happens first.
+// The first attempt to succeed wins. If all of them fail, the last one to do so reports the error
+class connect_race_tracker
+{
+public:
+    static constexpr std::size_t no_attempt = static_cast<std::size_t>(-1);
+
+private:
+    std::size_t num_attempts_;
+    std::size_t num_started_{1u};
+    std::size_t num_failed_{};
+    std::size_t winner_{no_attempt};
+    std::size_t last_failed_{no_attempt};
+
+public:
+    explicit connect_race_tracker(std::size_t num_attempts) noexcept : num_attempts_(num_attempts)
+    {
+        BOOST_ASSERT(num_attempts > 0u);
+    }
+
+    // Whether there are attempts after idx
+    bool has_next(std::size_t idx) const noexcept { return idx + 1u < num_attempts_; }
+
+    // To be called when attempt idx fails or the stagger delay since it started elapses.
+    // Returns the attempt to start, or no_attempt if there are no attempts left,
+    // the race has been won or the next attempt has already been started
+    std::size_t start_next(std::size_t idx) noexcept
+    {
+        if (winner_ != no_attempt || !has_next(idx) || num_started_ != idx + 1u)
+            return no_attempt;
+        return num_started_++;
+    }
+
+    // Attempt idx succeeded. Returns whether it won the race
+    bool on_success(std::size_t idx) noexcept
+    {
+        if (winner_ != no_attempt)
+            return false;
+        winner_ = idx;
+        return true;
+    }
+
+    // Attempt idx failed. Returns whether all attempts have failed, which finishes the race
+    bool on_failure(std::size_t idx) noexcept
+    {
+        last_failed_ = idx;
+        return ++num_failed_ == num_attempts_;
+    }
+
+    bool succeeded() const noexcept { return winner_ != no_attempt; }
+
+    // The attempt that determines the race's outcome: the winner, or the last one to fail
+    std::size_t result() const noexcept { return succeeded() ? winner_ : last_failed_; }
+};
+
+}  // namespace nativepg::detail
+
+#endif
@@ -31,6 +31,8 @@ inline void check_pool_params(const pool_params& params)
         msg = "pool_params::ping_interval must not be negative";
     else if (params.ping_timeout.count() < 0)
         msg = "pool_params::ping_timeout must not be negative";
+    else if (params.on_connect.has_borrowed_values())
+        msg = "pool_params::on_connect must not contain borrowed values";
 
     if (msg != nullptr)
     {
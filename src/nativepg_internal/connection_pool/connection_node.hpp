@@ -25,6 +25,7 @@
 
 #include "nativepg/co_connection.hpp"
 #include "nativepg/co_connection_pool.hpp"
+#include "nativepg/co_resolve_cache.hpp"
 #include "nativepg/extended_error.hpp"
 #include "nativepg/protocol/notice_error.hpp"
 #include "nativepg/protocol/sync.hpp"
@@ -59,6 +60,9 @@ struct conn_shared_state
     // Condition variable to wait for all connections to exit
     boost::capy::async_event conns_finished_cv;
 
+    // Shared by all connections, if enabled
+    co_resolve_cache* resolve_cache{};
+
     void on_connection_start() { ++num_running_connections; }
 
     void on_connection_finish()
@@ -134,6 +138,26 @@ class connection_node : public boost::intrusive::list_base_hook<>,
         }
     }
 
+    // Connects and runs the warm-up request, if any
+    boost::capy::io_task<> connect_and_warm_up()
+    {
+        auto [ec] = co_await conn_.connect(params_->transport);
+        if (ec || params_->on_connect.messages().empty())
+            co_return {ec};
+
+        if (params_->on_connect_handler)
+        {
+            auto [ec2] = co_await conn_.exec(params_->on_connect, params_->on_connect_handler(conn_));
+            co_return {ec2};
+        }
+        else
+        {
+            check_handler handler;
+            auto [ec2] = co_await conn_.exec(params_->on_connect, handler);
+            co_return {ec2};
+        }
+    }
+
 public:
     connection_node(
         boost::capy::execution_context& ctx,
@@ -142,6 +166,8 @@ public:
     )
         : params_(params), shared_st_(&shared_st), conn_(ctx)
     {
+        conn_.set_resolve_cache(shared_st.resolve_cache);
+
         // There is no explicit PING command, but sending a sync will cause
         // the server to answer with ready_for_query
         ping_req_.add(protocol::sync{});
@@ -169,10 +195,8 @@ public:
             {
                 case next_connection_action::connect:
                 {
-                    auto [ec] = co_await run_with_timeout(
-                        conn_.connect(params_->transport),
-                        params_->connect_timeout
-                    );
+                    // Warm-up failures are handled like connect failures
+                    auto [ec] = co_await run_with_timeout(connect_and_warm_up(), params_->connect_timeout);
                     last_act_ = resume(ec, collection_state::none);
                     break;
                 }
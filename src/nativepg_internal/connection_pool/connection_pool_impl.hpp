@@ -27,6 +27,7 @@
 #include <stop_token>
 
 #include "nativepg/co_connection_pool.hpp"
+#include "nativepg/co_resolve_cache.hpp"
 #include "nativepg_internal/connection_pool/check_pool_params.hpp"
 #include "nativepg_internal/connection_pool/connection_node.hpp"
 #include "nativepg_internal/connection_pool/sansio_connection_node.hpp"
@@ -44,6 +45,7 @@ class co_connection_pool_impl
 
     pool_params params_;
     state_t state_{state_t::initial};
+    co_resolve_cache resolve_cache_;
     std::list<connection_node> all_conns_;
     conn_shared_state<connection_node> shared_st_;
     boost::capy::async_event cancel_ev_;
@@ -61,6 +63,13 @@ class co_connection_pool_impl
         );
     }
 
+    // Refreshes the resolve cache. Tracked like connections, so run() waits for it to exit
+    boost::capy::task<> run_resolve_cache()
+    {
+        [[maybe_unused]] auto res = co_await boost::capy::when_any(resolve_cache_.run(), cancel_ev_.wait());
+        shared_st_.on_connection_finish();
+    }
+
     // Create and run connections as required by the current config and state
     void create_connections(const boost::capy::io_env* env)
     {
@@ -113,9 +122,11 @@ class co_connection_pool_impl
 
 public:
     co_connection_pool_impl(boost::capy::execution_context& ctx, pool_params&& params)
-        : params_(std::move(params)), shared_st_(ctx)
+        : params_(std::move(params)), resolve_cache_(ctx, params_.resolve_cache), shared_st_(ctx)
     {
         check_pool_params(params_);
+        if (params_.cache_resolutions)
+            shared_st_.resolve_cache = &resolve_cache_;
     }
 
     boost::capy::io_task<> run()
@@ -126,6 +137,13 @@ public:
 
         const auto* env = co_await boost::capy::this_coro::environment;
 
+        // Start refreshing resolutions
+        if (params_.cache_resolutions)
+        {
+            shared_st_.on_connection_start();
+            boost::capy::run_async(env->executor, env->frame_allocator)(run_resolve_cache());
+        }
+
         // Create the initial connections
         create_connections(env);
 
@@ -155,8 +173,8 @@ public:
         shared_st_.idle_connections_cv.expires_at((std::chrono::steady_clock::time_point::min)());
 
         // Wait for all connection tasks to exit. We need to replace the stop token so this has any effect.
-        // Skip this if there is no connection to wait for
-        if (!all_conns_.empty())
+        // Skip this if there is no task to wait for
+        if (!all_conns_.empty() || params_.cache_resolutions)
         {
             co_await boost::capy::run(std::stop_token())([this]() -> boost::capy::task<> {
                 auto [ec2] = co_await shared_st_.conns_finished_cv.wait();
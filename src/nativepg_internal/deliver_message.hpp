@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_SRC_NATIVEPG_INTERNAL_DELIVER_MESSAGE_HPP
+#define NATIVEPG_SRC_NATIVEPG_INTERNAL_DELIVER_MESSAGE_HPP
+
+#include <cstddef>
+
+#include "nativepg/protocol/any_backend_message.hpp"
+#include "nativepg/protocol/connection_state.hpp"
+#include "nativepg/protocol/parse_message.hpp"
+#include "nativepg/protocol/read_response_fsm.hpp"
+
+namespace nativepg::protocol::detail {
+
+// Delivers a message that has been parsed from the start of the read buffer to the FSM,
+// consuming it. If it's a DataRow and the FSM is expecting rows, all the consecutive DataRows
+// that are already in the buffer are delivered in a single batch
+inline read_response_fsm::result deliver_message(
+    connection_state& st,
+    read_response_fsm& fsm,
+    const parse_message_result& msg
+)
+{
+    // Regular messages
+    if (msg.message.type() != any_backend_message::kind::data_row || !fsm.accepts_rows())
+    {
+        auto res = fsm.resume(msg.message);
+        st.read_buffer.consume(msg.size);
+        return res;
+    }
+
+    // Collect all the rows we have. Anything that is not a row will be parsed again by the caller
+    const auto data = st.read_buffer.committed_area();
+    std::size_t consumed = msg.size;
+    st.row_batch.clear();
+    st.row_batch.push_back(msg.message.get_data_row());
+    while (true)
+    {
+        auto next = parse_message(data.subspan(consumed));
+        if (next.ec || next.message.type() != any_backend_message::kind::data_row)
+            break;
+        st.row_batch.push_back(next.message.get_data_row());
+        consumed += next.size;
+    }
+
+    // Deliver them. Rows point into the read buffer, so they must be consumed afterwards
+    auto res = fsm.resume_rows(st.row_batch);
+    st.read_buffer.consume(consumed);
+    return res;
+}
+
+}  // namespace nativepg::protocol::detail
+
+#endif
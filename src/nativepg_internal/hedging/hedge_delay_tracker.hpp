@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_HEDGE_DELAY_TRACKER_HPP
+#define NATIVEPG_HEDGE_DELAY_TRACKER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "nativepg/hedging_params.hpp"
+
+namespace nativepg::detail {
+
+// Keeps the latencies of recent requests and computes the delay after which
+// a request should be hedged. Also keeps the hedging counters
+class hedge_delay_tracker
+{
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+
+    hedging_params params_;
+    std::vector<rep> samples_;  // ring buffer with the last params_.window latencies
+    std::size_t next_{};        // where the next sample goes, once samples_ is full
+    std::size_t since_recompute_{};
+    std::vector<rep> scratch_;  // quantile computation reorders elements
+    duration delay_;
+    hedging_stats stats_;
+
+    // Sorting the window on every request is wasteful, and the quantile changes slowly
+    std::size_t recompute_interval() const { return (std::max)(params_.window / 16u, std::size_t(1)); }
+
+    void recompute()
+    {
+        scratch_.assign(samples_.begin(), samples_.end());
+        const auto rank = static_cast<std::size_t>(std::ceil(params_.quantile * scratch_.size()));
+        const auto idx = (std::min)((std::max)(rank, std::size_t(1)), scratch_.size()) - 1u;
+        std::nth_element(scratch_.begin(), scratch_.begin() + idx, scratch_.end());
+        delay_ = std::clamp(duration(scratch_[idx]), params_.min_delay, params_.max_delay);
+        since_recompute_ = 0u;
+    }
+
+public:
+    explicit hedge_delay_tracker(const hedging_params& params)
+        : params_(params), delay_(params.initial_delay)
+    {
+        samples_.reserve(params_.window);
+        scratch_.reserve(params_.window);
+    }
+
+    // How long to wait for the first attempt before sending the hedge
+    duration delay() const { return delay_; }
+
+    const hedging_stats& stats() const { return stats_; }
+
+    void on_request_started() { ++stats_.num_requests; }
+
+    // The delay elapsed without a response. Returns whether the hedge may be sent,
+    // according to the hedging budget. If it may, it's accounted for
+    bool on_hedge_timer()
+    {
+        if (static_cast<double>(stats_.num_hedged) >= params_.max_hedge_ratio * stats_.num_requests)
+            return false;
+        ++stats_.num_hedged;
+        return true;
+    }
+
+    // A request got a successful response. latency is measured from the start of the request.
+    // If the hedge won, it's a lower bound of the first attempt's latency. Recording the hedge's
+    // own latency instead would hide slow first attempts, lowering the delay with every hedge win
+    void on_response(duration latency, bool hedge_won)
+    {
+        if (hedge_won)
+            ++stats_.num_hedge_wins;
+
+        if (samples_.size() < params_.window)
+        {
+            samples_.push_back(latency.count());
+        }
+        else
+        {
+            samples_[next_] = latency.count();
+            next_ = (next_ + 1u) % params_.window;
+        }
+
+        if (samples_.size() >= params_.min_samples &&
+            (samples_.size() == params_.min_samples || ++since_recompute_ >= recompute_interval()))
+        {
+            recompute();
+        }
+    }
+};
+
+}  // namespace nativepg::detail
+
+#endif
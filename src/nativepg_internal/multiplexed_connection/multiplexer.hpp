@@ -14,17 +14,22 @@
 #include <boost/compat/function_ref.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
-#include <deque>
+#include <list>
 #include <optional>
 #include <span>
+#include <string_view>
 #include <system_error>
+#include <unordered_map>
 #include <vector>
 
 #include "nativepg/client_errc.hpp"
+#include "nativepg/extended_error.hpp"
 #include "nativepg/protocol/any_backend_message.hpp"
 #include "nativepg/protocol/read_response_fsm.hpp"
 #include "nativepg/request.hpp"
+#include "nativepg/request_priority.hpp"
 #include "nativepg/response.hpp"
 #include "nativepg/response_handler.hpp"
 
@@ -49,6 +54,9 @@ struct multiplexer_elem
     boost::compat::function_ref<void(std::error_code)> on_done;  // TODO: do we have any alternative?
     multiplexer_elem_status status{multiplexer_elem_status::pending};
     std::size_t num_rfq{};  // Expected number of ready-for-query messages. Populated lazily
+    request_priority priority{request_priority::normal};
+    std::size_t enqueued_at{};  // The number of writes performed when the request was added
+    std::size_t written_at{};   // The number of writes performed before the one that included the request
 };
 
 inline std::size_t get_expected_rfqs(std::span<const request_message_type> msgs)
@@ -58,6 +66,71 @@ inline std::size_t get_expected_rfqs(std::span<const request_message_type> msgs)
     });
 }
 
+class multiplexer;
+
+// An execution shared by several identical requests (see multiplexed_config::deduplicate_reads).
+// Acts as the response handler and completion callback of its multiplexer_elem,
+// fanning out messages to the participants. Owns a copy of the request, since
+// the participant that created it may be cancelled while others wait
+class shared_request
+{
+    struct participant
+    {
+        response_handler_ref res;
+        boost::compat::function_ref<void(std::error_code)> on_done;
+        bool active;
+    };
+
+    request req_;
+    std::vector<participant> participants_;
+    std::size_t num_active_{};
+    multiplexer_elem* elem_{};
+    multiplexer* owner_;
+    std::list<shared_request>::iterator self_{};
+    extended_error result_;  // unused, since each participant's result is checked
+
+    friend class multiplexer;
+
+public:
+    shared_request(const request& req, multiplexer& owner) : req_(req), owner_(&owner) {}
+
+    // The handler interface. setup is never called, since the request is set up by each participant
+    handler_setup_result setup(const request& req, std::size_t offset)
+    {
+        return offset + req.messages().size();
+    }
+
+    void on_message(const any_request_message& msg, std::size_t offset)
+    {
+        for (auto& p : participants_)
+        {
+            if (p.active)
+                p.res.on_message(msg, offset);
+        }
+    }
+
+    void on_rows(std::span<const protocol::data_row> rows, std::size_t offset)
+    {
+        for (auto& p : participants_)
+        {
+            if (p.active)
+                p.res.on_rows(rows, offset);
+        }
+    }
+
+    const extended_error& result() const { return result_; }
+
+    // The completion callback. Defined after multiplexer
+    void operator()(std::error_code ec);
+};
+
+// Identifies a participant in a shared_request
+struct shared_ticket
+{
+    shared_request* shared;
+    std::size_t index;
+};
+
 class read_response_stream_fsm
 {
     enum class status
@@ -79,7 +152,7 @@ public:
     bool is_reading() const { return status_ == status::reading; }
 
     [[nodiscard]]
-    std::error_code on_message(std::deque<multiplexer_elem>& elms, const protocol::any_backend_message& msg)
+    std::error_code on_message(std::list<multiplexer_elem>& elms, const protocol::any_backend_message& msg)
     {
         using protocol::read_response_fsm;
 
@@ -158,29 +231,105 @@ class multiplexer
 public:
     multiplexer() = default;
 
+    // Shared requests point to their multiplexer
+    multiplexer(const multiplexer&) = delete;
+    multiplexer& operator=(const multiplexer&) = delete;
+
+    // See multiplexed_config::max_write_size and max_deferred_writes
+    void set_write_limits(std::size_t max_write_size, std::size_t max_deferred_writes)
+    {
+        max_write_size_ = max_write_size;
+        max_deferred_writes_ = max_deferred_writes;
+    }
+
     // Adds a request. To be called by execute
     multiplexer_elem* add(
         const request* req,
         response_handler_ref res,
-        boost::compat::function_ref<void(std::error_code)> on_done
+        boost::compat::function_ref<void(std::error_code)> on_done,
+        request_priority priority = request_priority::normal
     )
     {
-        elems_.push_back({req, res, on_done});
-        ++num_pending_;
-        return &elems_.back();
+        auto& lane = lane_for(priority);
+        lane.push_back({req, res, on_done, multiplexer_elem_status::pending, 0u, priority, num_writes_});
+        return &lane.back();
+    }
+
+    // Adds a request that may share its execution with an identical one, added before
+    // and whose response hasn't started arriving yet. To be called by execute
+    shared_ticket add_shared(
+        const request* req,
+        response_handler_ref res,
+        boost::compat::function_ref<void(std::error_code)> on_done,
+        request_priority priority = request_priority::normal
+    )
+    {
+        BOOST_ASSERT(!req->has_borrowed_values());
+
+        // Look for a request we can join
+        const auto payload = req->payload();
+        const std::string_view key(reinterpret_cast<const char*>(payload.data()), payload.size());
+        shared_request* shared = nullptr;
+        auto it = shared_index_.find(key);
+        if (it != shared_index_.end() && is_joinable(*it->second))
+        {
+            // If the execution hasn't been written yet, it gets the highest priority of its participants
+            shared = it->second;
+            auto* elem = shared->elem_;
+            if (elem->status == multiplexer_elem_status::pending && elem->priority < priority)
+                raise_priority(*elem, priority);
+        }
+        else
+        {
+            // Create a new one. It replaces any entry that can no longer be joined in the index.
+            // The entry is erased rather than reassigned, since its key points into the old request
+            if (it != shared_index_.end())
+                shared_index_.erase(it);
+            shared = &shared_.emplace_front(*req, *this);
+            shared->self_ = shared_.begin();
+            const auto shared_payload = shared->req_.payload();
+            const std::string_view shared_key(
+                reinterpret_cast<const char*>(shared_payload.data()),
+                shared_payload.size()
+            );
+            shared_index_.emplace(shared_key, shared);
+            shared->elem_ = add(&shared->req_, shared, *shared, priority);
+        }
+
+        // Add the participant
+        shared->participants_.push_back({res, on_done, true});
+        ++shared->num_active_;
+        return {shared, shared->participants_.size() - 1u};
+    }
+
+    void cancel(shared_ticket ticket)
+    {
+        // Stop delivering messages to the participant
+        auto& shared = *ticket.shared;
+        auto& p = shared.participants_[ticket.index];
+        BOOST_ASSERT(p.active);
+        p.active = false;
+        p.res = &null_handler_;
+        p.on_done = &ignore;
+
+        // If nobody is interested in the response anymore, cancel the request
+        if (--shared.num_active_ == 0u)
+        {
+            cancel(shared.elem_);
+            remove_shared(shared);
+        }
     }
 
     void cancel(multiplexer_elem* elem)
     {
         BOOST_ASSERT(elem != nullptr);
-        BOOST_ASSERT(!elems_.empty());
 
         switch (elem->status)
         {
             case multiplexer_elem_status::pending:
             {
                 // The request hasn't been written yet.
-                // Mark it as abandoned and it will be ignored and removed when possible
+                // Mark it as abandoned and it will be removed by the next write
                 elem->status = multiplexer_elem_status::abandoned_pending;
                 break;
             }
@@ -189,6 +338,7 @@ public:
                 // We've sent this request. We need to keep enough info to identify
                 // the responses for this request and discard them.
                 // The process differs if we've already read part of the response
+                BOOST_ASSERT(!elems_.empty());
                 elem->status = multiplexer_elem_status::abandoned_in_flight;
                 if (elem == &elems_.front() && fsm_.is_reading())
                     fsm_.abandon_current();
@@ -205,38 +355,75 @@ public:
         elem->on_done = &ignore;
     }
 
-    std::span<const unsigned char> prepare_write()
+    // Returns the chunks of data to write, to be used as a gather list
+    std::span<const std::span<const unsigned char>> prepare_write()
     {
         write_buffer_.clear();
-
-        // Go over all pending elements, add them to the write buffer, and mark them as in-progress
-        // TODO: ideally, we shouldn't need to copy the payload, but cancellations get much trickier
-        for (auto& elm : pending_requests())
+        write_borrowed_.clear();
+        write_chunks_.clear();
+
+        // Take pending elements in priority order until the size limit is reached,
+        // add them to the write buffer, and mark them as in-progress.
+        // TODO: ideally, we shouldn't need to copy the payload, but cancellations get much trickier.
+        // Borrowed parameter values are not copied, since avoiding that copy is their point.
+        std::size_t write_size = 0u;
+        while (auto* lane = next_lane())
         {
-            switch (elm.status)
+            // The request was cancelled before being written, remove it
+            auto& elm = lane->front();
+            if (elm.status == multiplexer_elem_status::abandoned_pending)
             {
-                case multiplexer_elem_status::pending:
-                {
-                    // Healthy request
-                    BOOST_ASSERT(elm.req);
-                    auto payload = elm.req->payload();
-                    write_buffer_.insert(write_buffer_.end(), payload.begin(), payload.end());
-                    elm.status = multiplexer_elem_status::in_flight;
-                    break;
-                }
-                case multiplexer_elem_status::abandoned_pending:
-                {
-                    // The request was cancelled before being written, ignore it
-                    break;
-                }
-                default: BOOST_ASSERT(false); break;
+                lane->pop_front();
+                continue;
             }
+
+            // Healthy request. At least one request is always written
+            BOOST_ASSERT(elm.status == multiplexer_elem_status::pending);
+            BOOST_ASSERT(elm.req);
+            const auto payload = elm.req->payload();
+            const auto borrowed = request_access::borrowed(*elm.req);
+            std::size_t size = payload.size();
+            for (const auto& value : borrowed)
+                size += value.data.size();
+            if (write_size > 0u && max_write_size_ > 0u && write_size + size > max_write_size_)
+                break;
+
+            const std::size_t offset = write_buffer_.size();
+            write_buffer_.insert(write_buffer_.end(), payload.begin(), payload.end());
+            for (const auto& value : borrowed)
+                write_borrowed_.push_back({offset + value.offset, value.data});
+            write_size += size;
+
+            // Responses arrive in the order requests are written
+            elm.status = multiplexer_elem_status::in_flight;
+            elm.written_at = num_writes_;
+            elems_.splice(elems_.end(), *lane, lane->begin());
         }
 
-        // All the elements are now in-progress
-        num_pending_ = 0u;
+        // Requests that are still pending have been deferred by this write
+        if (write_size > 0u)
+        {
+            ++num_writes_;
+            writing_ = true;
+        }
 
-        return write_buffer_;
+        // Compose the gather list
+        for_each_chunk(write_buffer_, write_borrowed_, [this](std::span<const unsigned char> chunk) {
+            write_chunks_.push_back(chunk);
+        });
+        return write_chunks_;
+    }
+
+    // To be called when the write of the chunks returned by prepare_write finishes, successfully or not
+    void on_write_finished() { writing_ = false; }
+
+    // Whether the write in progress references the request's borrowed parameter values.
+    // If it does, the request can't complete its cancellation until the write finishes,
+    // or the values could be freed while being written. To be called before cancel
+    bool borrowed_values_in_use(const multiplexer_elem* elem) const
+    {
+        return writing_ && elem->status == multiplexer_elem_status::in_flight &&
+               elem->written_at + 1u == num_writes_ && elem->req->has_borrowed_values();
     }
 
     [[nodiscard]]
@@ -262,42 +449,119 @@ public:
     void cleanup()
     {
         // Cancel all the requests
-        for (auto& elm : in_flight_requests())
+        for (auto& elm : elems_)
             elm.on_done(std::make_error_code(std::errc::operation_canceled));
 
         // Remove them
-        elems_.erase(elems_.begin(), elems_.begin() + pending_offset());
+        elems_.clear();
 
-        // Clean up state
+        // Clean up state. The writer has finished by now
         fsm_.reset();
+        writing_ = false;
     }
 
 private:
+    static constexpr std::size_t num_priorities = 3u;
+
     std::vector<unsigned char> write_buffer_;
-    std::deque<multiplexer_elem> elems_;
+    std::vector<borrowed_value> write_borrowed_;
+    std::vector<std::span<const unsigned char>> write_chunks_;
+
+    // Requests that have been written, in order. Lists keep element addresses
+    // stable while elements are moved between them
+    std::list<multiplexer_elem> elems_;
+
+    // Requests that haven't been written yet, by priority, in the order they were added
+    std::array<std::list<multiplexer_elem>, num_priorities> pending_;
+
+    // Overridden by multiplexed_config
+    std::size_t max_write_size_{};
+    std::size_t max_deferred_writes_{8u};
+    std::size_t num_writes_{};
+    bool writing_{};
+
     check null_handler_;
-    std::size_t num_pending_{};
     read_response_stream_fsm fsm_;
+    std::list<shared_request> shared_;
+    std::unordered_map<std::string_view, shared_request*> shared_index_;  // keyed by payload
+
+    friend class shared_request;
 
     inline static void ignore(std::error_code) {}
 
-    // Gets the offset in the deque where the pending requests start
-    std::size_t pending_offset() const { return elems_.size() - num_pending_; }
+    std::list<multiplexer_elem>& lane_for(request_priority priority)
+    {
+        return pending_[static_cast<std::size_t>(priority)];
+    }
 
-    // Gets a view containing all the pending requests. They are at the end
-    // of the queue.
-    std::ranges::subrange<std::deque<multiplexer_elem>::iterator> pending_requests()
+    // Gets the lane holding the next request to write, or nullptr if there are no pending requests.
+    // Requests deferred by too many writes go first, oldest first, so low priority requests
+    // make progress under sustained load. Otherwise, the highest priority request goes first
+    std::list<multiplexer_elem>* next_lane()
     {
-        return std::ranges::subrange(elems_.begin() + pending_offset(), elems_.end());
+        std::list<multiplexer_elem>* highest = nullptr;
+        std::list<multiplexer_elem>* oldest_deferred = nullptr;
+        for (auto it = pending_.rbegin(); it != pending_.rend(); ++it)
+        {
+            if (it->empty())
+                continue;
+            if (!highest)
+                highest = &*it;
+            const auto enqueued_at = it->front().enqueued_at;
+            if (num_writes_ - enqueued_at >= max_deferred_writes_ &&
+                (!oldest_deferred || enqueued_at < oldest_deferred->front().enqueued_at))
+            {
+                oldest_deferred = &*it;
+            }
+        }
+        return oldest_deferred ? oldest_deferred : highest;
     }
 
-    // Same, for in-flight requests
-    std::ranges::subrange<std::deque<multiplexer_elem>::iterator> in_flight_requests()
+    // Moves a pending request to a higher priority lane, keeping lanes ordered by age
+    void raise_priority(multiplexer_elem& elem, request_priority priority)
     {
-        return std::ranges::subrange(elems_.begin(), elems_.begin() + pending_offset());
+        auto& from = lane_for(elem.priority);
+        auto& to = lane_for(priority);
+        auto elem_it = std::ranges::find_if(from, [&elem](const multiplexer_elem& e) { return &e == &elem; });
+        BOOST_ASSERT(elem_it != from.end());
+        auto pos = std::ranges::find_if(to, [&elem](const multiplexer_elem& e) {
+            return e.enqueued_at > elem.enqueued_at;
+        });
+        elem.priority = priority;
+        to.splice(pos, from, elem_it);
+    }
+
+    // Participants can't join once the response has started arriving, or they would miss messages
+    bool is_joinable(const shared_request& shared) const
+    {
+        const auto* elem = shared.elem_;
+        return elem->status == multiplexer_elem_status::pending ||
+               (elem->status == multiplexer_elem_status::in_flight &&
+                !(elem == &elems_.front() && fsm_.is_reading()));
+    }
+
+    void remove_shared(shared_request& shared)
+    {
+        // Don't remove the index entry if it belongs to a newer request
+        const auto payload = shared.req_.payload();
+        const std::string_view key(reinterpret_cast<const char*>(payload.data()), payload.size());
+        if (auto it = shared_index_.find(key); it != shared_index_.end() && it->second == &shared)
+            shared_index_.erase(it);
+        shared_.erase(shared.self_);
     }
 };
 
+inline void shared_request::operator()(std::error_code ec)
+{
+    // Notify participants, then destroy ourselves. No members may be used after this
+    for (auto& p : participants_)
+    {
+        if (p.active)
+            p.on_done(ec);
+    }
+    owner_->remove_shared(*this);
+}
+
 }  // namespace detail
 }  // namespace nativepg
 
@@ -12,7 +12,10 @@
 #include <boost/capy/ex/async_event.hpp>
 #include <boost/capy/io_task.hpp>
 
+#include <algorithm>
 #include <cstddef>
+#include <functional>
+#include <string_view>
 #include <vector>
 
 #include "nativepg/notification_event.hpp"
@@ -20,33 +23,163 @@
 
 namespace nativepg::detail {
 
-// Handles notify events and backpressure in multiplexed connections
+// Handles notify events and backpressure in multiplexed connections.
+// Pending events are stored in a notification_batch, which is swapped with the consumer's
+// when reading. Memory is recycled, so the steady state doesn't allocate.
+// When the queue is full, notifications are handled according to the overflow policy.
+// Only the block policy makes the producer wait
 class notification_queue
 {
     std::size_t max_pending_;
-    std::vector<notification_event> pending_;
+    notification_overflow_policy policy_{notification_overflow_policy::block};
+    std::size_t max_spilled_{};
+    notification_batch pending_;
+    notification_batch spilled_;  // events received after pending_ got full (spill policy)
+    std::size_t num_dropped_{};
+    std::vector<std::size_t> dedup_table_;  // open addressing, index in pending_ + 1 (coalesce policy)
     boost::capy::async_event events_available_;
     boost::capy::async_event space_available_;
     // TODO: we could avoid copies if the consumer task is waiting
 
     bool has_space() const { return pending_.size() < max_pending_; }
 
-    void add_event(notification_event&& evt)
+    // Events must be appended to the spill buffer while it's not empty, to preserve ordering
+    notification_batch& tail() { return spilled_.empty() ? pending_ : spilled_; }
+
+    void on_event_added()
     {
-        pending_.push_back(std::move(evt));
         if (!has_space())
             space_available_.clear();
         events_available_.set();
     }
 
-    void do_add_notification(const protocol::notification_response& msg)
+    static std::size_t hash_notification(std::string_view channel, std::string_view payload)
+    {
+        std::hash<std::string_view> h;
+        return h(channel) * 31u + h(payload);
+    }
+
+    // Looks for a pending notification with the same channel and payload.
+    // Returns the table slot where it was found, or where it should be inserted
+    std::size_t find_duplicate(std::string_view channel, std::string_view payload, bool& found) const
     {
-        add_event({
+        const std::size_t mask = dedup_table_.size() - 1u;
+        for (std::size_t slot = hash_notification(channel, payload) & mask;; slot = (slot + 1u) & mask)
+        {
+            const std::size_t idx = dedup_table_[slot];
+            if (idx == 0u)
+            {
+                found = false;
+                return slot;
+            }
+            auto evt = pending_[idx - 1u];
+            if (evt.channel == channel && evt.payload == payload)
+            {
+                found = true;
+                return slot;
+            }
+        }
+    }
+
+    // Indexes the pending notifications. While the policy is coalesce, notifications are only added
+    // while there is space, so the table never holds more than (std::max)(max_pending_, pending_.size())
+    void reset_dedup_table()
+    {
+        if (policy_ != notification_overflow_policy::coalesce)
+            return;
+
+        // Load factor <= 0.5
+        const std::size_t max_entries = (std::max)(max_pending_, pending_.size());
+        std::size_t size = 1u;
+        while (size < 2u * max_entries)
+            size *= 2u;
+        dedup_table_.assign(size, 0u);
+
+        for (std::size_t i = 0u; i < pending_.size(); ++i)
+        {
+            auto evt = pending_[i];
+            if (evt.type != notification_event_type::notify)
+                continue;
+            bool found = false;
+            const auto slot = find_duplicate(evt.channel, evt.payload, found);
+            if (!found)
+                dedup_table_[slot] = i + 1u;
+        }
+    }
+
+    void do_add_notification(notification_batch& target, const protocol::notification_response& msg)
+    {
+        target.push_back({
             .type = notification_event_type::notify,
             .backend_pid = msg.process_id,
-            .channel = std::string(msg.channel_name),
-            .payload = std::string(msg.payload),
+            .channel = msg.channel_name,
+            .payload = msg.payload,
         });
+        on_event_added();
+    }
+
+    void drop_oldest_notification()
+    {
+        for (std::size_t i = 0u; i < pending_.size(); ++i)
+        {
+            if (pending_[i].type == notification_event_type::notify)
+            {
+                pending_.erase(i);
+                ++num_dropped_;
+                return;
+            }
+        }
+    }
+
+    // Adds a notification without waiting, as mandated by the policy
+    void add_notify_overflow(const protocol::notification_response& msg)
+    {
+        switch (policy_)
+        {
+            case notification_overflow_policy::drop_oldest:
+                if (!has_space())
+                    drop_oldest_notification();
+                if (has_space())
+                    do_add_notification(pending_, msg);
+                else
+                    ++num_dropped_;  // everything pending is a connect or disconnect
+                break;
+
+            case notification_overflow_policy::coalesce:
+            {
+                // Duplicates are only discarded when there is no space
+                bool found = false;
+                const auto slot = find_duplicate(msg.channel_name, msg.payload, found);
+                if (has_space())
+                {
+                    do_add_notification(pending_, msg);
+                    if (!found)
+                        dedup_table_[slot] = pending_.size();
+                }
+                else if (!found)
+                {
+                    ++num_dropped_;
+                }
+                break;
+            }
+
+            case notification_overflow_policy::spill:
+                if (spilled_.empty() && has_space())
+                    do_add_notification(pending_, msg);
+                else if (spilled_.size() < max_spilled_)
+                    do_add_notification(spilled_, msg);
+                else
+                    ++num_dropped_;
+                break;
+
+            case notification_overflow_policy::drop_newest:
+            default:
+                if (has_space())
+                    do_add_notification(pending_, msg);
+                else
+                    ++num_dropped_;
+                break;
+        }
     }
 
 public:
@@ -56,8 +189,26 @@ public:
         space_available_.set();
     }
 
+    // Takes effect for the next added notification
+    void set_config(std::size_t max_pending, notification_overflow_policy policy, std::size_t max_spilled)
+    {
+        BOOST_ASSERT(max_pending > 0u);
+        max_pending_ = max_pending;
+        policy_ = policy;
+        max_spilled_ = max_spilled;
+        reset_dedup_table();
+        if (has_space())
+            space_available_.set();
+        else
+            space_available_.clear();
+    }
+
     // Producer side. Connects and disconnects are not subject to backpressure
-    void add_connect() { add_event({notification_event_type::connect}); }
+    void add_connect()
+    {
+        tail().push_back({notification_event_type::connect});
+        on_event_added();
+    }
     void add_disconnect()
     {
         // If the last element is a connect, instead of adding a disconnect,
@@ -67,9 +218,10 @@ public:
         // TODO: I think we could avoid losing information by storing connects/disconnects
         // in a 'compressed' format (e.g. store the int 5 if 5 connect/disconnect cycles happen)
         // But this would require having != formats in pending_ and the output buffer
-        if (!pending_.empty() && pending_.back().type == notification_event_type::connect)
+        auto& target = tail();
+        if (!target.empty() && target.back().type == notification_event_type::connect)
         {
-            pending_.pop_back();
+            target.pop_back();
             if (has_space())
                 space_available_.set();
             if (pending_.empty())
@@ -77,33 +229,38 @@ public:
         }
         else
         {
-            add_event({notification_event_type::disconnect});
+            target.push_back({notification_event_type::disconnect});
+            on_event_added();
         }
     }
 
-    // Notifications are subject to backpressure
+    // Notifications are subject to backpressure. Returns false if
+    // the policy is block and there is no space
     bool try_add_notify(const protocol::notification_response& msg)
     {
+        if (policy_ != notification_overflow_policy::block)
+        {
+            add_notify_overflow(msg);
+            return true;
+        }
         if (!has_space())
             return false;
-        do_add_notification(msg);
+        do_add_notification(pending_, msg);
         return true;
     }
 
     boost::capy::io_task<> add_notify(const protocol::notification_response& msg)
     {
-        while (!has_space())
+        while (!try_add_notify(msg))
         {
             if (auto [ec] = co_await space_available_.wait(); ec)
                 co_return ec;
         }
-
-        do_add_notification(msg);
         co_return {};
     }
 
-    // Consumer side
-    boost::capy::io_task<> read_events(std::vector<notification_event>& output)
+    // Consumer side. The output's previous contents are discarded and its memory reused
+    boost::capy::io_task<> read_events(notification_batch& output)
     {
         // Wait for messages, if required
         while (pending_.empty())
@@ -114,9 +271,17 @@ public:
 
         // Take the messages
         output.swap(pending_);
+        output.set_num_dropped(num_dropped_);
+        num_dropped_ = 0u;
         pending_.clear();
-        events_available_.clear();
-        space_available_.set();
+
+        // Spilled events become pending
+        pending_.swap(spilled_);
+        reset_dedup_table();
+        if (pending_.empty())
+            events_available_.clear();
+        if (has_space())
+            space_available_.set();
 
         // Done
         co_return {};
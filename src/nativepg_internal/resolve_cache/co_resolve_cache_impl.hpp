@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_CO_RESOLVE_CACHE_IMPL_HPP
+#define NATIVEPG_CO_RESOLVE_CACHE_IMPL_HPP
+
+#include <boost/capy/cond.hpp>
+#include <boost/capy/ex/async_event.hpp>
+#include <boost/capy/ex/execution_context.hpp>
+#include <boost/capy/io_task.hpp>
+#include <boost/corosio/resolver.hpp>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "nativepg/connect_params.hpp"
+#include "nativepg/resolve_cache_params.hpp"
+#include "nativepg_internal/resolve_cache/resolve_cache_table.hpp"
+
+namespace nativepg::detail {
+
+struct co_resolve_cache_impl
+{
+    using results_type = boost::corosio::resolver_results;
+    using clock = std::chrono::steady_clock;
+
+    resolve_cache_params params;
+    resolve_cache_table<results_type> table;
+    boost::corosio::resolver refresh_resolv;  // used by run()
+
+    // Resolutions in progress. Other connections to the same host wait for them
+    std::map<host_address, std::shared_ptr<boost::capy::async_event>, host_address_less> in_flight;
+
+    co_resolve_cache_impl(boost::capy::execution_context& ctx, const resolve_cache_params& params)
+        : params(params), table(params), refresh_resolv(ctx)
+    {
+    }
+
+    // Records the outcome of a resolution. Cancellations say nothing about the host
+    void on_resolved(
+        std::string_view hostname,
+        unsigned short port,
+        std::error_code ec,
+        const results_type& results
+    )
+    {
+        if (!ec)
+            table.store(hostname, port, results, clock::now());
+        else if (ec != boost::capy::cond::canceled)
+            table.store_error(hostname, port, ec, clock::now());
+    }
+
+    // Resolves using the cache. Uses the connection's resolver on a cache miss
+    boost::capy::io_task<results_type> resolve(
+        boost::corosio::resolver& resolv,
+        const std::string& hostname,
+        unsigned short port
+    )
+    {
+        while (true)
+        {
+            // Cache hit
+            if (const auto* e = table.lookup(hostname, port, clock::now()))
+            {
+                if (e->results)
+                    co_return {{}, *e->results};
+                else
+                    co_return {e->ec, {}};
+            }
+
+            // Another connection is resolving this host. Wait for it and try again.
+            // If it was cancelled, we will be the ones resolving it
+            auto it = in_flight.find(host_address_view{hostname, port});
+            if (it == in_flight.end())
+                break;
+            auto ev = it->second;
+            auto [ec] = co_await ev->wait();
+            if (ec)
+                co_return {ec, {}};
+        }
+
+        // Resolve and wake up any waiters
+        auto ev = std::make_shared<boost::capy::async_event>();
+        in_flight.emplace(host_address{hostname, port}, ev);
+        auto [ec, results] = co_await resolv.resolve(hostname, std::to_string(port));
+        on_resolved(hostname, port, ec, results);
+        in_flight.erase(in_flight.find(host_address_view{hostname, port}));
+        ev->set();
+        co_return {ec, std::move(results)};
+    }
+};
+
+}  // namespace nativepg::detail
+
+#endif
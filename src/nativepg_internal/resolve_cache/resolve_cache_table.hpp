@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_RESOLVE_CACHE_TABLE_HPP
+#define NATIVEPG_RESOLVE_CACHE_TABLE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "nativepg/connect_params.hpp"
+#include "nativepg/resolve_cache_params.hpp"
+
+namespace nativepg::detail {
+
+// Orders host_address objects, allowing lookups by string_view
+struct host_address_less
+{
+    using is_transparent = void;
+
+    template <class Lhs, class Rhs>
+    bool operator()(const Lhs& lhs, const Rhs& rhs) const
+    {
+        return std::tuple<std::string_view, unsigned short>(lhs.hostname, lhs.port) <
+               std::tuple<std::string_view, unsigned short>(rhs.hostname, rhs.port);
+    }
+};
+
+struct host_address_view
+{
+    std::string_view hostname;
+    unsigned short port;
+};
+
+// The timing logic of the resolve cache. Templated on the resolver's result type so it can be tested
+template <class Results>
+class resolve_cache_table
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct entry
+    {
+        std::optional<Results> results;  // empty if the resolution failed
+        std::error_code ec;
+        clock::time_point expires;
+        bool used{};  // looked up since it was stored. Only used entries are refreshed
+    };
+
+private:
+    resolve_cache_params params_;
+    std::map<host_address, entry, host_address_less> entries_;
+
+    void store_impl(std::string_view hostname, unsigned short port, entry&& e)
+    {
+        auto it = entries_.find(host_address_view{hostname, port});
+        if (it == entries_.end())
+            entries_.emplace(host_address{std::string(hostname), port}, std::move(e));
+        else
+            it->second = std::move(e);
+    }
+
+public:
+    explicit resolve_cache_table(const resolve_cache_params& params) : params_(params) {}
+
+    // Returns the entry for hostname:port, or nullptr if there is none or it has expired
+    const entry* lookup(std::string_view hostname, unsigned short port, clock::time_point now)
+    {
+        auto it = entries_.find(host_address_view{hostname, port});
+        if (it == entries_.end() || it->second.expires <= now)
+            return nullptr;
+        it->second.used = true;
+        return &it->second;
+    }
+
+    void store(std::string_view hostname, unsigned short port, Results results, clock::time_point now)
+    {
+        store_impl(hostname, port, entry{std::move(results), {}, now + params_.ttl});
+    }
+
+    // Failed resolutions are only stored if negative caching is enabled
+    void store_error(
+        std::string_view hostname,
+        unsigned short port,
+        std::error_code ec,
+        clock::time_point now
+    )
+    {
+        if (params_.negative_ttl.count() > 0)
+            store_impl(hostname, port, entry{std::nullopt, ec, now + params_.negative_ttl});
+    }
+
+    // Stores in output the successful entries that have been used and expire within
+    // refresh_ahead, replacing its contents. Removes expired entries
+    void collect_refreshes(clock::time_point now, std::vector<host_address>& output)
+    {
+        output.clear();
+        for (auto it = entries_.begin(); it != entries_.end();)
+        {
+            const auto& e = it->second;
+            if (e.expires <= now)
+            {
+                it = entries_.erase(it);
+                continue;
+            }
+            if (e.results.has_value() && e.used && e.expires - now <= params_.refresh_ahead)
+                output.push_back(it->first);
+            ++it;
+        }
+    }
+
+    std::size_t size() const { return entries_.size(); }
+};
+
+}  // namespace nativepg::detail
+
+#endif
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_RETRY_TRACKER_HPP
+#define NATIVEPG_RETRY_TRACKER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <system_error>
+
+#include "nativepg/retry_params.hpp"
+#include "nativepg/sqlstate_cond.hpp"
+
+namespace nativepg::detail {
+
+// Decides whether failed executions should be retried and for how long to back off.
+// Keeps the retry budget and counters
+class retry_tracker
+{
+    using duration = std::chrono::steady_clock::duration;
+
+    retry_params params_;
+    double tokens_;
+    retry_stats stats_;
+
+public:
+    explicit retry_tracker(const retry_params& params) : params_(params), tokens_(params.max_retry_tokens) {}
+
+    const retry_stats& stats() const { return stats_; }
+
+    // Errors caused by concurrent transactions, which may succeed if executed again
+    static bool is_retryable(std::error_code ec)
+    {
+        return ec == sqlstate_cond::serialization_failure || ec == sqlstate_cond::deadlock_detected;
+    }
+
+    void on_request_started()
+    {
+        ++stats_.num_requests;
+        tokens_ = (std::min)(tokens_ + params_.retry_ratio, params_.max_retry_tokens);
+    }
+
+    // An execution failed with ec, after num_attempts executions. Returns whether the request
+    // should be executed again. If it should, the retry is accounted for
+    bool on_failure(std::size_t num_attempts, std::error_code ec)
+    {
+        if (!is_retryable(ec) || num_attempts >= params_.max_attempts)
+            return false;
+        if (tokens_ < 1.0)
+        {
+            ++stats_.num_budget_exhausted;
+            return false;
+        }
+        tokens_ -= 1.0;
+        ++stats_.num_retries;
+        return true;
+    }
+
+    // How long to wait before executing the request again, after num_attempts executions.
+    // random must be in [0, 1), and selects the jitter
+    duration backoff(std::size_t num_attempts, double random) const
+    {
+        const double exp = std::pow(params_.backoff_multiplier, static_cast<double>(num_attempts - 1u));
+        const double base = (std::min)(
+            static_cast<double>(params_.initial_backoff.count()) * exp,
+            static_cast<double>(params_.max_backoff.count())
+        );
+        return duration(static_cast<duration::rep>(base * (0.5 + 0.5 * random)));
+    }
+};
+
+}  // namespace nativepg::detail
+
+#endif
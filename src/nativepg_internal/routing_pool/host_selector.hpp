@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NATIVEPG_HOST_SELECTOR_HPP
+#define NATIVEPG_HOST_SELECTOR_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <span>
+
+#include "nativepg/protocol/replication.hpp"
+#include "nativepg/routing_params.hpp"
+
+namespace nativepg::detail {
+
+// What the routing pool knows about a host
+struct host_status
+{
+    host_role role{host_role::unknown};
+
+    // Connections handed out to users, or being waited for
+    std::size_t in_use{};
+
+    // Smoothed round-trip time of the role check query
+    std::chrono::steady_clock::duration latency{};
+
+    // The WAL position written (primary) or replayed (replica) when last checked
+    protocol::lsn_t lsn{};
+
+    // Whether the role has been checked at least once
+    bool checked{};
+};
+
+inline constexpr std::size_t no_host = static_cast<std::size_t>(-1);
+
+// Records the outcome of a successful role check
+inline void on_role_checked(
+    host_status& st,
+    bool in_recovery,
+    protocol::lsn_t lsn,
+    std::chrono::steady_clock::duration latency
+)
+{
+    st.role = in_recovery ? host_role::replica : host_role::primary;
+    st.lsn = lsn;
+
+    // Exponentially weighted moving average, with a 1/4 weight for new samples
+    st.latency = st.checked ? st.latency + (latency - st.latency) / 4 : latency;
+    st.checked = true;
+}
+
+// A role check failed. The host is not considered until it succeeds again
+inline void on_role_check_failed(host_status& st)
+{
+    st.role = host_role::unknown;
+    st.checked = true;
+}
+
+// Whether a is a better choice than b for read-only requests
+inline bool is_better_replica(const host_status& a, const host_status& b, load_balancing balancing)
+{
+    if (balancing == load_balancing::latency_weighted)
+    {
+        // Connections waiting or in use, including the one being requested, times the latency.
+        // A minimum latency of one tick avoids zero scores for unmeasured hosts
+        using rep = std::chrono::steady_clock::rep;
+        const auto score_a = static_cast<rep>(a.in_use + 1u) * (std::max)(a.latency.count(), rep(1));
+        const auto score_b = static_cast<rep>(b.in_use + 1u) * (std::max)(b.latency.count(), rep(1));
+        return score_a < score_b;
+    }
+    else
+    {
+        return a.in_use < b.in_use || (a.in_use == b.in_use && a.latency < b.latency);
+    }
+}
+
+// Returns the index of the host where a request should be routed, or no_host
+inline std::size_t select_host(
+    std::span<const host_status> hosts,
+    const route_options& opts,
+    load_balancing balancing,
+    bool fallback_to_primary
+)
+{
+    std::size_t primary = no_host;
+    std::size_t best_replica = no_host;
+    for (std::size_t i = 0u; i < hosts.size(); ++i)
+    {
+        const auto& host = hosts[i];
+        if (host.role == host_role::primary)
+        {
+            if (primary == no_host)
+                primary = i;
+        }
+        else if (host.role == host_role::replica && host.lsn >= opts.min_lsn)
+        {
+            if (best_replica == no_host || is_better_replica(host, hosts[best_replica], balancing))
+                best_replica = i;
+        }
+    }
+
+    if (opts.mode == access_mode::read_write)
+        return primary;
+    else if (best_replica != no_host)
+        return best_replica;
+    else
+        return fallback_to_primary ? primary : no_host;
+}
+
+}  // namespace nativepg::detail
+
+#endif
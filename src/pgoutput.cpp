@@ -0,0 +1,306 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/span.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/field_view.hpp"
+#include "nativepg/protocol/pgoutput.hpp"
+#include "nativepg/protocol/replication.hpp"
+#include "parse_context.hpp"
+
+using namespace nativepg::protocol;
+using nativepg::client_errc;
+using boost::system::error_code;
+
+namespace {
+
+// Message type bytes
+constexpr unsigned char begin_type = 'B';
+constexpr unsigned char commit_type = 'C';
+constexpr unsigned char origin_type = 'O';
+constexpr unsigned char relation_type = 'R';
+constexpr unsigned char type_type = 'Y';
+constexpr unsigned char insert_type = 'I';
+constexpr unsigned char update_type = 'U';
+constexpr unsigned char delete_type = 'D';
+constexpr unsigned char truncate_type = 'T';
+constexpr unsigned char logical_message_type = 'M';
+
+constexpr unsigned char new_tuple_marker = 'N';
+
+void check_message_type(detail::parse_context& ctx, unsigned char expected)
+{
+    if (ctx.get_byte() != expected)
+        ctx.add_error(client_errc::unexpected_message);
+}
+
+bool is_valued(pgoutput::tuple_column_kind kind)
+{
+    return kind == pgoutput::tuple_column_kind::text || kind == pgoutput::tuple_column_kind::binary;
+}
+
+// TupleData: Int16 number of columns, then, for each column, a Byte1 kind and,
+// for text and binary values, Int32 length + Byte<n>
+void parse_tuple_data(detail::parse_context& ctx, pgoutput::tuple_data& to)
+{
+    auto num_columns = static_cast<std::size_t>(ctx.get_nonnegative_integral<std::int16_t>());
+
+    // The values start here, record it
+    const auto* values_begin = ctx.first();
+
+    // Iterate over all columns to check if there's any error
+    for (std::size_t i = 0u; i < num_columns && !ctx.error(); ++i)
+    {
+        const auto kind = static_cast<pgoutput::tuple_column_kind>(ctx.get_byte());
+        if (is_valued(kind))
+        {
+            auto value_size = ctx.get_integral<std::int32_t>();
+            if (value_size >= 0)
+                ctx.check_size_and_advance(value_size);
+            else
+                ctx.add_error(client_errc::protocol_value_error);
+        }
+        else if (kind != pgoutput::tuple_column_kind::null &&
+                 kind != pgoutput::tuple_column_kind::unchanged_toast)
+        {
+            ctx.add_error(client_errc::protocol_value_error);
+        }
+    }
+
+    if (!ctx.error())
+        to.columns = forward_parsing_view<pgoutput::tuple_column>(num_columns, {values_begin, ctx.first()});
+}
+
+// Updates and deletes may contain an old tuple, identified by a 'K' or 'O' marker
+bool is_old_tuple_marker(unsigned char marker)
+{
+    return marker == static_cast<unsigned char>(pgoutput::old_tuple_kind::key) ||
+           marker == static_cast<unsigned char>(pgoutput::old_tuple_kind::old);
+}
+
+template <class T>
+error_code parse_any_impl(boost::span<const unsigned char> data, pgoutput::any_message& to)
+{
+    auto& msg = to.emplace<T>();
+    return pgoutput::parse(data, msg);
+}
+
+}  // namespace
+
+// Each column is: Byte1 kind, and then Int32 size + Byte<n> for text and binary values
+pgoutput::tuple_column nativepg::protocol::detail::forward_traits<pgoutput::tuple_column>::dereference(
+    const unsigned char* data
+)
+{
+    const auto kind = static_cast<pgoutput::tuple_column_kind>(*data);
+    if (!is_valued(kind))
+        return {kind, {}};
+    auto size = boost::endian::load_big_s32(data + 1u);
+    return {kind, std::span<const unsigned char>(data + 5u, static_cast<std::size_t>(size))};
+}
+
+const unsigned char* nativepg::protocol::detail::forward_traits<pgoutput::tuple_column>::advance(
+    const unsigned char* data
+)
+{
+    const auto kind = static_cast<pgoutput::tuple_column_kind>(*data);
+    if (!is_valued(kind))
+        return data + 1u;
+    return data + 5u + boost::endian::load_big_s32(data + 1u);
+}
+
+// Each column is: Int8 flags, String name, Int32 type OID, Int32 type modifier
+pgoutput::relation_column nativepg::protocol::detail::forward_traits<pgoutput::relation_column>::dereference(
+    const unsigned char* data
+)
+{
+    // Evaluation order of initializers is well defined
+    return {
+        detail::unchecked_get_integral<std::int8_t>(data),   // flags
+        detail::unchecked_get_string(data),                  // name
+        detail::unchecked_get_integral<std::int32_t>(data),  // type_oid
+        detail::unchecked_get_integral<std::int32_t>(data),  // type_modifier
+    };
+}
+
+const unsigned char* nativepg::protocol::detail::forward_traits<pgoutput::relation_column>::advance(
+    const unsigned char* data
+)
+{
+    // Skip the flags and the name, which is the only variable-size item
+    ++data;
+    detail::unchecked_get_string(data);
+    return data + 8u;
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, begin_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, begin_type);
+    to.final_lsn = static_cast<lsn_t>(ctx.get_integral<std::int64_t>());
+    to.commit_time = ctx.get_integral<std::int64_t>();
+    to.xid = ctx.get_integral<std::int32_t>();
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, commit_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, commit_type);
+    to.flags = ctx.get_integral<std::int8_t>();
+    to.commit_lsn = static_cast<lsn_t>(ctx.get_integral<std::int64_t>());
+    to.end_lsn = static_cast<lsn_t>(ctx.get_integral<std::int64_t>());
+    to.commit_time = ctx.get_integral<std::int64_t>();
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, origin_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, origin_type);
+    to.commit_lsn = static_cast<lsn_t>(ctx.get_integral<std::int64_t>());
+    to.name = ctx.get_string();
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, relation_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, relation_type);
+    to.oid = ctx.get_integral<std::int32_t>();
+    to.namespace_name = ctx.get_string();
+    to.relation_name = ctx.get_string();
+    to.replica_identity = ctx.get_integral<std::int8_t>();
+    auto num_columns = static_cast<std::size_t>(ctx.get_nonnegative_integral<std::int16_t>());
+
+    // Check that all columns are well-formed
+    const auto* columns_begin = ctx.first();
+    for (std::size_t i = 0u; i < num_columns && !ctx.error(); ++i)
+    {
+        ctx.get_integral<std::int8_t>();
+        ctx.get_string();
+        ctx.get_integral<std::int32_t>();
+        ctx.get_integral<std::int32_t>();
+    }
+
+    if (!ctx.error())
+        to.columns = forward_parsing_view<relation_column>(num_columns, {columns_begin, ctx.first()});
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, type_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, type_type);
+    to.oid = ctx.get_integral<std::int32_t>();
+    to.namespace_name = ctx.get_string();
+    to.name = ctx.get_string();
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, insert_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, insert_type);
+    to.relation_oid = ctx.get_integral<std::int32_t>();
+    if (ctx.get_byte() != new_tuple_marker)
+        ctx.add_error(client_errc::protocol_value_error);
+    parse_tuple_data(ctx, to.new_tuple);
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, update_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, update_type);
+    to.relation_oid = ctx.get_integral<std::int32_t>();
+
+    // The old tuple is optional
+    auto marker = ctx.get_byte();
+    if (is_old_tuple_marker(marker))
+    {
+        to.old_kind = static_cast<old_tuple_kind>(marker);
+        parse_tuple_data(ctx, to.old_tuple);
+        marker = ctx.get_byte();
+    }
+    else
+    {
+        to.old_kind = old_tuple_kind::none;
+        to.old_tuple = {};
+    }
+
+    if (marker != new_tuple_marker)
+        ctx.add_error(client_errc::protocol_value_error);
+    parse_tuple_data(ctx, to.new_tuple);
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, delete_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, delete_type);
+    to.relation_oid = ctx.get_integral<std::int32_t>();
+    const auto marker = ctx.get_byte();
+    if (!is_old_tuple_marker(marker))
+        ctx.add_error(client_errc::protocol_value_error);
+    to.old_kind = static_cast<old_tuple_kind>(marker);
+    parse_tuple_data(ctx, to.old_tuple);
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, truncate_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, truncate_type);
+    auto num_relations = static_cast<std::size_t>(ctx.get_nonnegative_integral<std::int32_t>());
+    to.options = ctx.get_integral<std::int8_t>();
+
+    // An Int32 OID per relation
+    const auto* oids_begin = ctx.first();
+    if (!ctx.error())
+        ctx.check_size_and_advance(num_relations * 4u);
+    if (!ctx.error())
+        to.relation_oids = random_access_parsing_view<std::int32_t>(oids_begin, num_relations);
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, logical_message& to)
+{
+    detail::parse_context ctx(data);
+    check_message_type(ctx, logical_message_type);
+    to.flags = ctx.get_integral<std::int8_t>();
+    to.lsn = static_cast<lsn_t>(ctx.get_integral<std::int64_t>());
+    to.prefix = ctx.get_string();
+    auto size = static_cast<std::size_t>(ctx.get_nonnegative_integral<std::int32_t>());
+    to.content = ctx.get_bytes(size);
+    return ctx.check();
+}
+
+error_code nativepg::protocol::pgoutput::parse(boost::span<const unsigned char> data, any_message& to)
+{
+    switch (replication_message_type(data))
+    {
+        case begin_type: return parse_any_impl<begin_message>(data, to);
+        case commit_type: return parse_any_impl<commit_message>(data, to);
+        case origin_type: return parse_any_impl<origin_message>(data, to);
+        case relation_type: return parse_any_impl<relation_message>(data, to);
+        case type_type: return parse_any_impl<type_message>(data, to);
+        case insert_type: return parse_any_impl<insert_message>(data, to);
+        case update_type: return parse_any_impl<update_message>(data, to);
+        case delete_type: return parse_any_impl<delete_message>(data, to);
+        case truncate_type: return parse_any_impl<truncate_message>(data, to);
+        case logical_message_type: return parse_any_impl<logical_message>(data, to);
+        default: return client_errc::unexpected_message;
+    }
+}
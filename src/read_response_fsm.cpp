@@ -5,10 +5,14 @@
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 //
 
+#include <boost/assert.hpp>
 #include <boost/system/error_code.hpp>
 
+#include <span>
+
 #include "nativepg/client_errc.hpp"
 #include "nativepg/protocol/any_backend_message.hpp"
+#include "nativepg/protocol/data_row.hpp"
 #include "nativepg/protocol/describe.hpp"
 #include "nativepg/protocol/read_response_fsm.hpp"
 #include "nativepg/request.hpp"
@@ -396,3 +400,24 @@ read_response_fsm::result read_response_fsm::resume(const any_backend_message& m
         }
     }
 }
+
+bool read_response_fsm::accepts_rows() const
+{
+    // Rows may appear after an execute, or in the middle of a resultset in a query
+    if (current_ >= req_->messages().size())
+        return false;
+    switch (req_->messages()[current_])
+    {
+        case request_message_type::execute: return state_ == state_t::msg_first;
+        case request_message_type::query: return state_ == state_t::query_rows;
+        default: return false;
+    }
+}
+
+read_response_fsm::result read_response_fsm::resume_rows(std::span<const data_row> rows)
+{
+    // Rows don't change state
+    BOOST_ASSERT(accepts_rows());
+    handler_.on_rows(rows, current_);
+    return result_type::read;
+}
@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/assert.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/variant2/variant.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/protocol/common.hpp"
+#include "nativepg/protocol/pgoutput.hpp"
+#include "nativepg/relation_cache.hpp"
+#include "nativepg/response.hpp"
+
+using namespace nativepg;
+
+const relation_info& relation_cache::store(const protocol::pgoutput::relation_message& msg)
+{
+    // If the relation was already defined, reuse its storage
+    auto& rel = relations_[msg.oid];
+    rel.oid = msg.oid;
+    rel.namespace_name.assign(msg.namespace_name);
+    rel.relation_name.assign(msg.relation_name);
+    rel.replica_identity = msg.replica_identity;
+    rel.columns.resize(msg.columns.size());
+    std::size_t i = 0u;
+    for (const auto& col : msg.columns)
+    {
+        auto& to = rel.columns[i++];
+        to.name.assign(col.name);
+        to.type_oid = col.type_oid;
+        to.type_modifier = col.type_modifier;
+        to.is_key = col.is_key();
+    }
+    rel.version = next_version_++;
+    return rel;
+}
+
+void relation_cache::on_message(const protocol::pgoutput::any_message& msg)
+{
+    if (const auto* rel = boost::variant2::get_if<protocol::pgoutput::relation_message>(&msg))
+        store(*rel);
+}
+
+const relation_info* relation_cache::find(std::int32_t oid) const
+{
+    auto it = relations_.find(oid);
+    return it == relations_.end() ? nullptr : &it->second;
+}
+
+boost::system::error_code nativepg::detail::compute_relation_pos_map(
+    const relation_info& rel,
+    std::span<const std::string_view> name_table,
+    std::span<pos_map_entry> output
+)
+{
+    // Name table should be the same size as the pos map
+    BOOST_ASSERT(name_table.size() == output.size());
+
+    // Set all positions to "invalid"
+    for (auto& elm : output)
+        elm = {invalid_pos, {}};
+
+    // Look up every column in the name table
+    for (std::size_t db_index = 0u; db_index < rel.columns.size(); ++db_index)
+    {
+        const auto& col = rel.columns[db_index];
+        auto it = std::find(name_table.begin(), name_table.end(), col.name);
+        if (it != name_table.end())
+        {
+            // pgoutput doesn't send attribute numbers or type lengths.
+            // The format is adjusted for each value, since it may vary between tuples
+            protocol::field_description descr{
+                .name = col.name,
+                .table_oid = rel.oid,
+                .column_attribute = 0,
+                .type_oid = col.type_oid,
+                .type_length = -1,
+                .type_modifier = col.type_modifier,
+                .fmt_code = protocol::format_code::text,
+            };
+            auto cpp_index = static_cast<std::size_t>(it - name_table.begin());
+            output[cpp_index] = {db_index, descr};
+        }
+    }
+
+    // If there is any unmapped field, it is an error
+    if (std::find_if(output.begin(), output.end(), [](const pos_map_entry& ent) {
+            return ent.db_index == invalid_pos;
+        }) != output.end())
+    {
+        return client_errc::field_not_found;
+    }
+
+    return {};
+}
@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/system/error_code.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "coroutine.hpp"
+#include "nativepg/client_errc.hpp"
+#include "nativepg/protocol/any_backend_message.hpp"
+#include "nativepg/protocol/connection_state.hpp"
+#include "nativepg/protocol/copy.hpp"
+#include "nativepg/protocol/detail/replication_fsm.hpp"
+#include "nativepg/protocol/parse_message.hpp"
+#include "nativepg/protocol/query.hpp"
+#include "nativepg/protocol/replication.hpp"
+#include "nativepg/replication_params.hpp"
+#include "nativepg/sqlstate.hpp"
+
+using namespace nativepg::protocol;
+using boost::system::error_code;
+using detail::replication_fsm;
+using nativepg::client_errc;
+using kind = any_backend_message::kind;
+
+namespace {
+
+// Appends value surrounded by quote, doubling any quote in value
+void append_quoted(std::string& to, std::string_view value, char quote)
+{
+    to += quote;
+    for (char c : value)
+    {
+        if (c == quote)
+            to += quote;
+        to += c;
+    }
+    to += quote;
+}
+
+}  // namespace
+
+std::string detail::compose_start_replication(const nativepg::logical_replication_params& params)
+{
+    std::string res = "START_REPLICATION SLOT ";
+    append_quoted(res, params.slot_name, '"');
+    res += " LOGICAL ";
+    res += format_lsn(params.start_lsn);
+    if (!params.plugin_options.empty())
+    {
+        res += " (";
+        bool first = true;
+        for (const auto& opt : params.plugin_options)
+        {
+            if (!first)
+                res += ", ";
+            first = false;
+            append_quoted(res, opt.first, '"');
+            res += ' ';
+            append_quoted(res, opt.second, '\'');
+        }
+        res += ')';
+    }
+    return res;
+}
+
+error_code replication_fsm::on_message(connection_state& st, const any_backend_message& msg)
+{
+    switch (msg.type())
+    {
+        case kind::copy_both_response:
+            if (copy_both_)
+                return client_errc::unexpected_message;
+            copy_both_ = true;
+            return {};
+        case kind::copy_data:
+        {
+            if (!copy_both_)
+                return client_errc::unexpected_message;
+            const auto data = msg.get_copy_data().data;
+            switch (replication_message_type(data))
+            {
+                case xlog_data_message_type:
+                {
+                    xlog_data xlog{};
+                    if (auto ec = parse(data, xlog))
+                        return ec;
+                    received_lsn_ = (std::max)(received_lsn_, xlog.wal_start + xlog.data.size());
+                    batch_.push_back(xlog);
+                    return {};
+                }
+                case primary_keepalive_message_type:
+                {
+                    primary_keepalive keepalive{};
+                    if (auto ec = parse(data, keepalive))
+                        return ec;
+                    received_lsn_ = (std::max)(received_lsn_, keepalive.wal_end);
+                    if (keepalive.reply_requested)
+                        reply_requested_ = true;
+                    return {};
+                }
+                default: return client_errc::unexpected_message;
+            }
+        }
+        case kind::copy_done:
+            if (!copy_both_)
+                return client_errc::unexpected_message;
+            server_copy_done_ = true;
+            return {};
+        case kind::error_response:
+        {
+            // The operation ends after the server sends ReadyForQuery
+            const auto& err = msg.get_error_response();
+            st.shared_diag.assign(err);
+            err_ = parse_sqlstate(err.sqlstate.value_or(std::string_view{}));
+            return {};
+        }
+        case kind::ready_for_query: finished_ = true; return {};
+        case kind::command_complete:
+        case kind::notice_response:
+        case kind::parameter_status: return {};
+        default: return client_errc::unexpected_message;
+    }
+}
+
+bool replication_fsm::status_due(std::chrono::steady_clock::time_point now) const noexcept
+{
+    return copy_both_ && !client_copy_done_ && (reply_requested_ || now >= next_status_);
+}
+
+error_code replication_fsm::compose_status(connection_state& st, std::chrono::steady_clock::time_point now)
+{
+    reply_requested_ = false;
+    next_status_ = now + status_interval_;
+    return serialize(
+        standby_status_update{
+            .written_lsn = received_lsn_,
+            .flushed_lsn = flushed_lsn_,
+            .applied_lsn = flushed_lsn_,
+            .send_time = to_replication_timestamp(std::chrono::system_clock::now()),
+            .reply_requested = false,
+        },
+        st.write_buffer
+    );
+}
+
+replication_fsm::result replication_fsm::resume(
+    connection_state& st,
+    error_code ec,
+    std::size_t bytes_transferred,
+    std::chrono::steady_clock::time_point now
+)
+{
+    parse_message_result msg_res;
+    bool was_started = false;
+
+    switch (resume_point_)
+    {
+        NATIVEPG_CORO_INITIAL
+
+        // Send START_REPLICATION
+        st.write_buffer.clear();
+        if (auto ec_ser = serialize(query{start_query_}, st.write_buffer))
+            return ec_ser;
+        NATIVEPG_YIELD(resume_point_, 1, result::write(st.write_buffer))
+        if (ec)
+            return ec;
+        next_status_ = now + status_interval_;
+
+        while (true)
+        {
+            // Process all the messages we have. XLogData messages point into the read buffer,
+            // so nothing is consumed until they have been delivered
+            was_started = copy_both_;
+            while (true)
+            {
+                msg_res = parse_message(st.read_buffer.committed_area().subspan(consumed_));
+                if (msg_res.ec == client_errc::needs_more)
+                {
+                    needed_bytes_ = msg_res.size;
+                    break;
+                }
+                else if (msg_res.ec)
+                {
+                    return msg_res.ec;
+                }
+                consumed_ += msg_res.size;
+                if (auto ec_msg = on_message(st, msg_res.message))
+                    return ec_msg;
+                if (finished_)
+                    break;
+            }
+
+            // Notify that streaming started
+            if (!was_started && copy_both_)
+                NATIVEPG_YIELD(resume_point_, 2, result_type::started)
+
+            // Deliver the data
+            if (!batch_.empty())
+                NATIVEPG_YIELD(resume_point_, 3, result::data(batch_))
+            st.read_buffer.consume(consumed_);
+            consumed_ = 0u;
+            batch_.clear();
+
+            // Done
+            if (finished_)
+                return err_;
+
+            // Send the status and CopyDone, if required.
+            // Status updates are not sent after an error, since the server will end the stream
+            if (!err_ && (status_due(now) || (copy_both_ && !client_copy_done_ &&
+                                              (stop_requested_ || server_copy_done_))))
+            {
+                st.write_buffer.clear();
+                if (auto ec_ser = compose_status(st, now))
+                    return ec_ser;
+                if (stop_requested_ || server_copy_done_)
+                {
+                    client_copy_done_ = true;
+                    if (auto ec_ser = serialize(copy_done{}, st.write_buffer))
+                        return ec_ser;
+                }
+                NATIVEPG_YIELD(resume_point_, 4, result::write(st.write_buffer))
+                if (ec)
+                    return ec;
+            }
+
+            // Read more data. A read without bytes or errors means that a status update may be due
+            st.read_buffer.prepare(needed_bytes_);
+            NATIVEPG_YIELD(resume_point_, 5, result::read(st.read_buffer.prepared_area()))
+            if (ec)
+                return ec;
+            st.read_buffer.commit(bytes_transferred);
+        }
+    }
+
+    // We should never reach here
+    BOOST_ASSERT(false);
+    return error_code();
+}
@@ -10,7 +10,10 @@
 #include <boost/system/error_code.hpp>
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <optional>
 #include <span>
 
 #include "nativepg/client_errc.hpp"
@@ -161,6 +164,113 @@ handler_setup_result check_close::setup(const request& req, std::size_t offset)
     return check_setup_impl(req, offset, request_message_type::close);
 }
 
+handler_setup_result check_execute_batch::setup(const request& req, std::size_t offset)
+{
+    if (info_)
+        *info_ = {};
+    err_ = {};
+    current_ = 0u;
+
+    const auto msgs = req.messages().subspan(offset);
+    auto it = msgs.begin();
+
+    // Skip any leading syncs
+    while (it != msgs.end() && (*it == request_message_type::sync || *it == request_message_type::flush))
+        ++it;
+
+    // Any number of bind + execute pairs, until the sync that ends the batch.
+    // There may be flush messages in between
+    bool bind_found = false;
+    for (; it != msgs.end() && *it != request_message_type::sync; ++it)
+    {
+        switch (*it)
+        {
+            case request_message_type::flush: continue;
+            case request_message_type::bind:
+                if (bind_found)
+                    return handler_setup_result(client_errc::incompatible_response_type);
+                bind_found = true;
+                break;
+            case request_message_type::execute:
+                if (!bind_found)
+                    return handler_setup_result(client_errc::incompatible_response_type);
+                bind_found = false;
+                break;
+            default: return handler_setup_result(client_errc::incompatible_response_type);
+        }
+    }
+    if (bind_found)
+        return handler_setup_result(client_errc::incompatible_response_type);
+
+    // Skip any further sync messages
+    while (it != msgs.end() && (*it == request_message_type::sync || *it == request_message_type::flush))
+        ++it;
+
+    return handler_setup_result{static_cast<std::size_t>(it - req.messages().begin())};
+}
+
+// Whether msgs contains, at pos, the messages that request::add_query adds for a statement
+// without autosync, as used for BEGIN, COMMIT and ROLLBACK by request::add_transaction
+static bool is_transaction_control(std::span<const request_message_type> msgs, std::size_t pos)
+{
+    constexpr request_message_type expected[] = {
+        request_message_type::parse,
+        request_message_type::bind,
+        request_message_type::describe,
+        request_message_type::execute,
+    };
+    return pos <= msgs.size() && msgs.size() - pos >= 4u &&
+           std::ranges::equal(msgs.subspan(pos, 4u), expected);
+}
+
+handler_setup_result check_transaction::setup(const request& req, std::size_t offset)
+{
+    if (info_)
+        *info_ = {};
+    err_ = {};
+
+    const auto msgs = req.messages();
+    const auto is_sync = [](request_message_type type) {
+        return type == request_message_type::sync || type == request_message_type::flush;
+    };
+    std::size_t pos = offset;
+
+    // Skip any leading syncs
+    while (pos < msgs.size() && is_sync(msgs[pos]))
+        ++pos;
+
+    // BEGIN
+    if (!is_transaction_control(msgs, pos))
+        return handler_setup_result(client_errc::incompatible_response_type);
+    statements_offset_ = pos + 4u;
+
+    // The statements and COMMIT end with the first sync, and can't contain simple queries
+    const auto first = msgs.begin() + statements_offset_;
+    const auto sync_it = std::find(first, msgs.end(), request_message_type::sync);
+    const auto sync_pos = static_cast<std::size_t>(sync_it - msgs.begin());
+    if (sync_pos < statements_offset_ + 4u || !is_transaction_control(msgs, sync_pos - 4u) ||
+        std::find(first, sync_it, request_message_type::query) != sync_it)
+    {
+        return handler_setup_result(client_errc::incompatible_response_type);
+    }
+    commit_offset_ = sync_pos - 4u;
+
+    // ROLLBACK, followed by a sync
+    rollback_offset_ = sync_pos + 1u;
+    pos = rollback_offset_ + 4u;
+    if (!is_transaction_control(msgs, rollback_offset_) || pos == msgs.size() ||
+        msgs[pos] != request_message_type::sync)
+    {
+        return handler_setup_result(client_errc::incompatible_response_type);
+    }
+
+    // Skip any further sync messages
+    while (pos < msgs.size() && is_sync(msgs[pos]))
+        ++pos;
+
+    return handler_setup_result{pos};
+}
+
 handler_setup_result describe_into::setup(const request& req, std::size_t offset)
 {
     obj_->clear();
@@ -214,6 +324,130 @@ void check_execute::on_message(const any_request_message& msg, std::size_t)
     boost::variant2::visit(visitor{*this}, msg);
 }
 
+void check_execute_batch::on_message(const any_request_message& msg, std::size_t)
+{
+    struct visitor
+    {
+        check_execute_batch& self;
+
+        void on_executed() const
+        {
+            ++self.current_;
+            if (self.info_)
+                self.info_->num_executed = self.current_;
+        }
+
+        // Bind results
+        void operator()(protocol::bind_complete) const {}
+
+        // Rows may be sent by statements like INSERT ... RETURNING. Ignore them.
+        // COPY OUT sends an empty row description
+        void operator()(const protocol::row_description&) const {}
+        void operator()(const protocol::data_row&) const {}
+
+        // EOF for each execution
+        void operator()(protocol::command_complete msg) const
+        {
+            if (self.info_)
+            {
+                std::optional<std::uint64_t> affected_rows;
+                auto ec = protocol::parse_command_complete_tag(msg.tag, affected_rows);
+                if (!ec && affected_rows)
+                    self.info_->affected_rows += *affected_rows;
+            }
+            on_executed();
+        }
+
+        void operator()(protocol::portal_suspended) const { on_executed(); }
+        void operator()(const protocol::empty_query_response&) const { on_executed(); }
+
+        // An error in either the bind or the execute causes the server to skip the rest of the batch
+        void operator()(const protocol::error_response& msg) const
+        {
+            detail::maybe_store_error(msg, self.err_);
+            if (self.info_ && !self.info_->failed_index)
+                self.info_->failed_index = self.current_;
+        }
+
+        // Messages skipped because of a previous error
+        void operator()(message_skipped) const {}
+
+        // The rest of the messages shouldn't arrive
+        void operator()(protocol::parse_complete) const { BOOST_ASSERT(false); }
+        void operator()(const protocol::close_complete&) const { BOOST_ASSERT(false); }
+        void operator()(const protocol::parameter_description&) const { BOOST_ASSERT(false); }
+    };
+
+    boost::variant2::visit(visitor{*this}, msg);
+}
+
+void check_transaction::on_message(const any_request_message& msg, std::size_t offset)
+{
+    struct visitor
+    {
+        check_transaction& self;
+        std::size_t offset;
+
+        bool is_statement() const
+        {
+            return offset >= self.statements_offset_ && offset < self.commit_offset_;
+        }
+
+        bool is_commit() const { return offset >= self.commit_offset_ && offset < self.rollback_offset_; }
+
+        void on_executed() const
+        {
+            if (self.info_ && is_statement())
+                ++self.info_->num_executed;
+        }
+
+        // EOF for each statement
+        void operator()(protocol::command_complete msg) const
+        {
+            if (!self.info_)
+                return;
+            if (is_statement())
+            {
+                std::optional<std::uint64_t> affected_rows;
+                auto ec = protocol::parse_command_complete_tag(msg.tag, affected_rows);
+                if (!ec && affected_rows)
+                    self.info_->affected_rows += *affected_rows;
+            }
+            else if (is_commit())
+            {
+                // COMMIT reports ROLLBACK if the transaction had failed
+                self.info_->committed = msg.tag == "COMMIT";
+            }
+            on_executed();
+        }
+
+        void operator()(protocol::portal_suspended) const { on_executed(); }
+        void operator()(const protocol::empty_query_response&) const { on_executed(); }
+
+        // An error causes the server to skip the rest of the statements and COMMIT.
+        // ROLLBACK is in its own pipeline segment, so it's always executed
+        void operator()(const protocol::error_response& msg) const
+        {
+            detail::maybe_store_error(msg, self.err_);
+            if (self.info_ && is_statement() && !self.info_->failed_index)
+                self.info_->failed_index = self.info_->num_executed;
+        }
+
+        // Rows and their metadata are ignored, as are messages skipped because of a previous error
+        void operator()(const protocol::row_description&) const {}
+        void operator()(const protocol::data_row&) const {}
+        void operator()(message_skipped) const {}
+
+        // Other messages carry no information we need
+        void operator()(protocol::parse_complete) const {}
+        void operator()(protocol::bind_complete) const {}
+        void operator()(const protocol::close_complete&) const {}
+        void operator()(const protocol::parameter_description&) const {}
+    };
+
+    boost::variant2::visit(visitor{*this, offset}, msg);
+}
+
 void resultsets_handler::on_message(const any_request_message& msg, std::size_t)
 {
     struct visitor
@@ -0,0 +1,350 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/span.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/mp11/algorithm.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/variant2/variant.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/notification_event.hpp"
+#include "nativepg/protocol/bind.hpp"
+#include "nativepg/protocol/close.hpp"
+#include "nativepg/protocol/command_complete.hpp"
+#include "nativepg/protocol/data_row.hpp"
+#include "nativepg/protocol/describe.hpp"
+#include "nativepg/protocol/empty_query_response.hpp"
+#include "nativepg/protocol/execute.hpp"
+#include "nativepg/protocol/parse.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+#include "nativepg/result_cache.hpp"
+#include "nativepg_internal/check_request.hpp"
+
+using namespace nativepg;
+using boost::system::error_code;
+
+namespace {
+
+// Each recorded message is stored as its type (the index in any_request_message), the offset
+// passed to the handler and the message body, in the same format as in the wire.
+// Integers use the native byte order, since the data never leaves the process
+struct record_header
+{
+    std::uint8_t type;
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+constexpr std::size_t record_header_size = 9u;
+
+// Overhead of each entry, in addition to its variable-size data
+constexpr std::size_t entry_overhead = 128u;
+
+template <class T>
+constexpr std::size_t type_index = boost::mp11::mp_find<any_request_message, T>::value;
+
+void append_header(std::vector<unsigned char>& to, std::size_t type, std::size_t offset, std::size_t size)
+{
+    const auto type8 = static_cast<std::uint8_t>(type);
+    const auto offset32 = static_cast<std::uint32_t>(offset);
+    const auto size32 = static_cast<std::uint32_t>(size);
+    const auto pos = to.size();
+    to.resize(pos + record_header_size);
+    std::memcpy(to.data() + pos, &type8, 1u);
+    std::memcpy(to.data() + pos + 1u, &offset32, 4u);
+    std::memcpy(to.data() + pos + 5u, &size32, 4u);
+}
+
+// Bodies made of an int16 count followed by the serialized items
+void append_counted(std::vector<unsigned char>& to, std::size_t count, boost::span<const unsigned char> items)
+{
+    unsigned char count_buff[2];
+    boost::endian::store_big_s16(count_buff, static_cast<std::int16_t>(count));
+    to.insert(to.end(), count_buff, count_buff + 2);
+    to.insert(to.end(), items.begin(), items.end());
+}
+
+record_header read_header(const unsigned char* data)
+{
+    record_header res{};
+    std::memcpy(&res.type, data, 1u);
+    std::memcpy(&res.offset, data + 1u, 4u);
+    std::memcpy(&res.size, data + 5u, 4u);
+    return res;
+}
+
+// Parses a recorded message
+template <class T>
+error_code parse_recorded(boost::span<const unsigned char> body, any_request_message& to)
+{
+    T msg{};
+    auto ec = protocol::parse(body, msg);
+    to = msg;
+    return ec;
+}
+
+error_code parse_recorded(std::uint8_t type, boost::span<const unsigned char> body, any_request_message& to)
+{
+    using namespace protocol;
+    switch (type)
+    {
+        case type_index<bind_complete>: return parse_recorded<bind_complete>(body, to);
+        case type_index<close_complete>: return parse_recorded<close_complete>(body, to);
+        case type_index<command_complete>: return parse_recorded<command_complete>(body, to);
+        case type_index<data_row>: return parse_recorded<data_row>(body, to);
+        case type_index<parameter_description>: return parse_recorded<parameter_description>(body, to);
+        case type_index<row_description>: return parse_recorded<row_description>(body, to);
+        case type_index<empty_query_response>: return parse_recorded<empty_query_response>(body, to);
+        case type_index<portal_suspended>: return parse_recorded<portal_suspended>(body, to);
+        case type_index<parse_complete>: return parse_recorded<parse_complete>(body, to);
+        default: return client_errc::protocol_value_error;
+    }
+}
+
+}  // namespace
+
+void detail::recording_handler::record(const any_request_message& msg, std::size_t offset)
+{
+    if (!cacheable_)
+        return;
+
+    const auto pos = messages_.size();
+    append_header(messages_, msg.index(), offset, 0u);
+    boost::variant2::visit(
+        [this](const auto& m) {
+            using T = std::decay_t<decltype(m)>;
+            if constexpr (std::is_same_v<T, protocol::data_row>)
+            {
+                append_counted(messages_, m.columns.size(), m.columns.serialized());
+            }
+            else if constexpr (std::is_same_v<T, protocol::row_description>)
+            {
+                append_counted(messages_, m.field_descriptions.size(), m.field_descriptions.serialized());
+            }
+            else if constexpr (std::is_same_v<T, protocol::parameter_description>)
+            {
+                append_counted(messages_, m.parameter_type_oids.size(), m.parameter_type_oids.serialized());
+            }
+            else if constexpr (std::is_same_v<T, protocol::command_complete>)
+            {
+                messages_.insert(messages_.end(), m.tag.begin(), m.tag.end());
+                messages_.push_back(0u);
+            }
+            else if constexpr (
+                std::is_same_v<T, protocol::error_response> || std::is_same_v<T, message_skipped>
+            )
+            {
+                // Errors are never cached
+                cacheable_ = false;
+            }
+        },
+        msg
+    );
+
+    // Fill in the body size, and stop recording if we exceeded the maximum size
+    const auto body_size = static_cast<std::uint32_t>(messages_.size() - pos - record_header_size);
+    std::memcpy(messages_.data() + pos + 5u, &body_size, 4u);
+    if (messages_.size() > max_size_)
+        cacheable_ = false;
+    if (!cacheable_)
+    {
+        messages_.clear();
+        messages_.shrink_to_fit();
+    }
+}
+
+result_cache::result_cache(result_cache_params params) : params_(std::move(params)) {}
+
+const std::string& result_cache::compute_key(const request& req)
+{
+    // Borrowed parameter values are part of the key
+    key_scratch_.clear();
+    req.for_each_chunk([this](std::span<const unsigned char> chunk) {
+        key_scratch_.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    });
+    return key_scratch_;
+}
+
+void result_cache::erase(std::list<entry>::iterator it)
+{
+    memory_usage_ -= it->cost;
+    index_.erase(it->key);
+    lru_.erase(it);
+}
+
+std::optional<error_code> result_cache::replay(
+    const request& req,
+    response_handler_ref handler,
+    clock::time_point now
+)
+{
+    // Lookup
+    auto it = index_.find(compute_key(req));
+    if (it == index_.end() || it->second->expires <= now)
+    {
+        if (it != index_.end())
+            erase(it->second);
+        ++stats_.misses;
+        return std::nullopt;
+    }
+    ++stats_.hits;
+
+    // Mark as most recently used
+    lru_.splice(lru_.begin(), lru_, it->second);
+    const auto& messages = it->second->messages;
+
+    // Deliver the messages as the connection would
+    if (auto ec = protocol::detail::setup_request(req, handler))
+        return ec;
+    const unsigned char* first = messages.data();
+    const unsigned char* last = first + messages.size();
+    while (first != last)
+    {
+        const auto header = read_header(first);
+        const boost::span<const unsigned char> body(first + record_header_size, header.size);
+        first += record_header_size + header.size;
+
+        // Deliver consecutive rows in a batch
+        if (header.type == type_index<protocol::data_row>)
+        {
+            row_batch_.clear();
+            auto& row = row_batch_.emplace_back();
+            if (auto ec = protocol::parse(body, row))
+                return ec;
+            while (first != last)
+            {
+                const auto next = read_header(first);
+                if (next.type != header.type || next.offset != header.offset)
+                    break;
+                const boost::span<const unsigned char> next_body(first + record_header_size, next.size);
+                if (auto ec = protocol::parse(next_body, row_batch_.emplace_back()))
+                    return ec;
+                first += record_header_size + next.size;
+            }
+            handler.on_rows(row_batch_, header.offset);
+        }
+        else
+        {
+            any_request_message msg;
+            if (auto ec = parse_recorded(header.type, body, msg))
+                return ec;
+            handler.on_message(msg, header.offset);
+        }
+    }
+
+    return handler.result().code;
+}
+
+void result_cache::store(
+    const request& req,
+    const detail::recording_handler& recorder,
+    const cache_options& opts,
+    clock::time_point now
+)
+{
+    if (!recorder.cacheable() || recorder.generation() != generation_)
+        return;
+
+    // Compute the entry's cost, and check that it fits
+    const auto& key = compute_key(req);
+    const auto messages = recorder.messages();
+    std::size_t cost = entry_overhead + key.size() + messages.size();
+    for (auto tag : opts.tags)
+        cost += tag.size();
+    if (cost > params_.max_bytes)
+        return;
+
+    // Replace any previous entry
+    if (auto it = index_.find(key); it != index_.end())
+        erase(it->second);
+
+    // Evict least recently used entries until the new one fits
+    while (memory_usage_ + cost > params_.max_bytes)
+    {
+        erase(std::prev(lru_.end()));
+        ++stats_.evictions;
+    }
+
+    // Insert
+    const auto ttl = opts.ttl.count() > 0 ? opts.ttl : params_.default_ttl;
+    auto& ent = lru_.emplace_front();
+    ent.key = key;
+    ent.messages.assign(messages.begin(), messages.end());
+    ent.tags.assign(opts.tags.begin(), opts.tags.end());
+    ent.expires = now + ttl;
+    ent.cost = cost;
+    index_.emplace(ent.key, lru_.begin());
+    memory_usage_ += cost;
+}
+
+std::size_t result_cache::invalidate(std::string_view tag)
+{
+    // Invalidations are infrequent compared to lookups, so we don't index tags
+    ++generation_;
+    std::size_t res = 0u;
+    for (auto it = lru_.begin(); it != lru_.end();)
+    {
+        auto next = std::next(it);
+        if (std::ranges::find(it->tags, tag) != it->tags.end())
+        {
+            erase(it);
+            ++res;
+        }
+        it = next;
+    }
+    stats_.invalidations += res;
+    return res;
+}
+
+void result_cache::on_notification(const notification_view& notif)
+{
+    if (notif.type == notification_event_type::connect)
+    {
+        clear();
+    }
+    else if (notif.type == notification_event_type::notify && notif.channel == params_.invalidation_channel)
+    {
+        if (notif.payload.empty())
+        {
+            stats_.invalidations += size();
+            clear();
+        }
+        else
+        {
+            invalidate(notif.payload);
+        }
+    }
+}
+
+void result_cache::on_notifications(const notification_batch& batch)
+{
+    if (batch.num_dropped() > 0u)
+        clear();
+    for (auto notif : batch)
+        on_notification(notif);
+}
+
+void result_cache::clear()
+{
+    ++generation_;
+    index_.clear();
+    lru_.clear();
+    memory_usage_ = 0u;
+}
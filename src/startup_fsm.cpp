@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <string_view>
+#include <utility>
 
 #include "coroutine.hpp"
 #include "nativepg/client_errc.hpp"
@@ -60,13 +61,20 @@ error_code handle_auth_response(const any_backend_message& msg, nativepg::diagno
     }
 }
 
+// Startup parameters for logical replication connections
+constexpr std::pair<std::string_view, std::string_view> replication_params[] = {
+    {"replication", "database"}
+};
+
 startup_message make_startup_message(const nativepg::connect_params& params)
 {
     return {
         .user = params.username,
         .database = params.database.empty() ? std::optional<std::string_view>()
                                             : std::string_view(params.database),
-        .params = {},
+        .params = params.replication
+                      ? boost::span<const std::pair<std::string_view, std::string_view>>(replication_params)
+                      : boost::span<const std::pair<std::string_view, std::string_view>>(),
     };
 }
 
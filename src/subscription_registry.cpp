@@ -0,0 +1,173 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "nativepg/notification_event.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/subscription_registry.hpp"
+
+using namespace nativepg;
+
+namespace {
+
+// LISTEN and UNLISTEN take an identifier. Quoting it makes channel names case-sensitive,
+// which matches the channel names reported in notifications
+void add_channel_query(request& req, std::string_view command, std::string_view channel)
+{
+    std::string query{command};
+    query += " \"";
+    for (char c : channel)
+    {
+        if (c == '"')
+            query += '"';
+        query += c;
+    }
+    query += '"';
+    req.add_simple_query(query);
+}
+
+}  // namespace
+
+void subscription_registry::remove_unsubscribed(channel_state& ch)
+{
+    std::erase_if(ch.subscribers, [](const subscriber& sub) { return !sub.active; });
+}
+
+subscription_id subscription_registry::subscribe(std::string_view channel, notification_handler handler)
+{
+    auto it = channels_.find(channel);
+    if (it == channels_.end())
+        it = channels_.emplace(std::string(channel), channel_state{}).first;
+
+    const auto id = next_id_++;
+    it->second.subscribers.push_back({id, std::move(handler), true});
+    ++it->second.num_active;
+    id_to_channel_.emplace(id, it->first);
+    return {id};
+}
+
+void subscription_registry::unsubscribe(subscription_id id)
+{
+    auto id_it = id_to_channel_.find(id.value);
+    if (id_it == id_to_channel_.end())
+        return;
+
+    auto& ch = channels_.find(id_it->second)->second;
+    auto sub_it = std::ranges::find(ch.subscribers, id.value, &subscriber::id);
+    if (dispatching_)
+    {
+        // The handler may be running, so remove it later. Handlers may unsubscribe
+        // from any channel, not only the one being dispatched
+        sub_it->active = false;
+        unsubscribed_while_dispatching_.push_back(&ch);
+    }
+    else
+        ch.subscribers.erase(sub_it);
+    --ch.num_active;
+    id_to_channel_.erase(id_it);
+}
+
+bool subscription_registry::needs_sync() const noexcept
+{
+    return resync_all_ || std::ranges::any_of(channels_, [](const auto& ch) {
+               return (ch.second.num_active > 0u) != ch.second.listening;
+           });
+}
+
+bool subscription_registry::prepare_sync(request& req)
+{
+    bool added = false;
+    for (auto it = channels_.begin(); it != channels_.end();)
+    {
+        auto& ch = it->second;
+        const bool should_listen = ch.num_active > 0u;
+        if (resync_all_ || should_listen != ch.listening)
+        {
+            add_channel_query(req, should_listen ? "LISTEN" : "UNLISTEN", it->first);
+            ch.listening = should_listen;
+            added = true;
+        }
+
+        // Channels without subscribers are no longer required
+        if (!should_listen && !dispatching_)
+            it = channels_.erase(it);
+        else
+            ++it;
+    }
+    resync_all_ = false;
+    return added;
+}
+
+void subscription_registry::on_sync_finished(bool success) noexcept
+{
+    if (!success)
+        resync_all_ = true;
+}
+
+void subscription_registry::on_connect()
+{
+    for (auto it = channels_.begin(); it != channels_.end();)
+    {
+        it->second.listening = false;
+        if (it->second.num_active == 0u && !dispatching_)
+            it = channels_.erase(it);
+        else
+            ++it;
+    }
+    resync_all_ = false;
+}
+
+std::size_t subscription_registry::dispatch(const notification_view& evt)
+{
+    if (evt.type != notification_event_type::notify)
+        return 0u;
+
+    auto it = channels_.find(evt.channel);
+    if (it == channels_.end())
+        return 0u;
+
+    // Handlers may subscribe and unsubscribe, so iterate by index,
+    // and don't remove subscribers from the deque until we're done
+    struct dispatch_guard
+    {
+        subscription_registry& self;
+
+        ~dispatch_guard()
+        {
+            self.dispatching_ = false;
+            for (auto* ch : self.unsubscribed_while_dispatching_)
+                remove_unsubscribed(*ch);
+            self.unsubscribed_while_dispatching_.clear();
+        }
+    } guard{*this};
+    dispatching_ = true;
+
+    auto& subs = it->second.subscribers;
+    const std::size_t size = subs.size();
+    std::size_t num_invoked = 0u;
+    for (std::size_t i = 0u; i < size; ++i)
+    {
+        if (subs[i].active)
+        {
+            subs[i].handler(evt);
+            ++num_invoked;
+        }
+    }
+    return num_invoked;
+}
+
+std::size_t subscription_registry::num_channels() const noexcept
+{
+    return static_cast<std::size_t>(std::ranges::count_if(channels_, [](const auto& ch) {
+        return ch.second.num_active > 0u;
+    }));
+}
@@ -10,18 +10,30 @@
 #include <boost/capy/ex/this_coro.hpp>
 #include <boost/capy/io_result.hpp>
 #include <boost/capy/task.hpp>
+#include <boost/capy/timeout.hpp>
+#include <boost/capy/when_any.hpp>
 #include <boost/core/lightweight_test.hpp>
 #include <boost/corosio/io_context.hpp>
 #include <boost/describe/class.hpp>
 #include <boost/describe/operators.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 #include "nativepg/co_connection.hpp"
+#include "nativepg/co_connection_pool.hpp"
+#include "nativepg/co_replication_stream.hpp"
+#include "nativepg/command_info.hpp"
 #include "nativepg/extended_error.hpp"
+#include "nativepg/replication_params.hpp"
 #include "nativepg/request.hpp"
 #include "nativepg/response.hpp"
+#include "nativepg/response_handler.hpp"
 #include "test_utils/ci_server.hpp"
 #include "test_utils/corosio_utils.hpp"
 #include "test_utils/printing.hpp"
@@ -44,6 +56,13 @@ struct row_string
 };
 BOOST_DESCRIBE_STRUCT(row_string, (), (value))
 
+// Doesn't match the fields returned by the queries, so parsing fails
+struct row_missing
+{
+    int missing;
+};
+BOOST_DESCRIBE_STRUCT(row_missing, (), (missing))
+
 using boost::describe::operators::operator==;
 using boost::describe::operators::operator<<;
 
@@ -74,11 +93,246 @@ capy::task<> test_exec_success()
     BOOST_TEST_ALL_EQ(strings.begin(), strings.end(), strings_expected.begin(), strings_expected.end());
 }
 
+// If the first server is down, the connection fails over to the next one
+capy::task<> test_connect_fallback_hosts()
+{
+    // Setup. Nothing listens on port 1
+    diagnostics diag;
+    co_connection conn{co_await capy::this_coro::executor};
+    auto params = default_connect_params();
+    params.port = 1;
+    params.fallback_hosts.push_back({.hostname = get_host(), .port = 5432});
+
+    // Connect
+    if (!check_success(co_await conn.connect(std::move(params), &diag), diag))
+        co_return;
+
+    // The connection is usable
+    request req;
+    req.add_query("SELECT 42 AS value", {});
+    std::vector<row_int> ints;
+    if (!check_success(co_await conn.exec(req, response{into(ints)}, &diag), diag))
+        co_return;
+    std::vector<row_int> ints_expected{{.value = 42}};
+    BOOST_TEST_ALL_EQ(ints.begin(), ints.end(), ints_expected.begin(), ints_expected.end());
+}
+
+// Requests bigger than full_duplex_threshold are written while reading the response
+capy::task<> test_exec_full_duplex()
+{
+    // Setup
+    diagnostics diag;
+    co_connection conn{co_await capy::this_coro::executor};
+    if (!check_success(co_await conn.connect(default_connect_params(), &diag), diag))
+        co_return;
+    const std::string big_value(256u * 1024u, 'a');
+
+    // Success
+    request req;
+    req.add_query("SELECT length($1)::INT AS value", {big_value});
+    req.add_query("SELECT length($1)::INT AS value", {big_value});
+    std::vector<row_int> ints;
+    if (!check_success(co_await conn.exec(req, response{into(ints), into(ints)}, &diag), diag))
+        co_return;
+    std::vector<row_int> ints_expected{{.value = 262144}, {.value = 262144}};
+    BOOST_TEST_ALL_EQ(ints.begin(), ints.end(), ints_expected.begin(), ints_expected.end());
+
+    // The server reports an error for the first statement while the rest of the request is being written
+    req.clear();
+    req.add_query("SELECT 1/0 AS value", {});
+    req.add_query("SELECT length($1)::INT AS value", {big_value});
+    ints.clear();
+    auto [ec] = co_await conn.exec(req, response{into(ints), into(ints)}, &diag);
+    BOOST_TEST(ec);
+
+    // The connection is still in sync
+    request check_req;
+    check_req.add_query("SELECT 42 AS value", {});
+    ints.clear();
+    if (!check_success(co_await conn.exec(check_req, response{into(ints)}, &diag), diag))
+        co_return;
+    ints_expected = {{.value = 42}};
+    BOOST_TEST_ALL_EQ(ints.begin(), ints.end(), ints_expected.begin(), ints_expected.end());
+}
+
+// Transactions are all-or-nothing, and leave the connection usable
+capy::task<> test_transaction()
+{
+    // Setup
+    diagnostics diag;
+    co_connection conn{co_await capy::this_coro::executor};
+    if (!check_success(co_await conn.connect(default_connect_params(), &diag), diag))
+        co_return;
+    request setup_req;
+    setup_req.add_query("CREATE TEMPORARY TABLE tx_test (value INT NOT NULL)", {});
+    if (!check_success(co_await conn.exec(setup_req, check(), &diag), diag))
+        co_return;
+
+    // A statement fails. Nothing is committed
+    transaction_info info;
+    request req;
+    req.add_transaction([](request& r) {
+        r.add_query("INSERT INTO tx_test VALUES ($1)", {1});
+        r.add_query("INSERT INTO tx_test VALUES (NULL)", {});
+        r.add_query("INSERT INTO tx_test VALUES ($1)", {3});
+    });
+    auto [ec] = co_await conn.exec(req, check_transaction(info), &diag);
+    BOOST_TEST(ec);
+    BOOST_TEST_EQ(info.num_executed, 1u);
+    BOOST_TEST(info.failed_index == std::optional<std::size_t>(1u));
+    BOOST_TEST(!info.committed);
+
+    // Success
+    req.clear();
+    req.add_transaction([](request& r) {
+        r.add_query("INSERT INTO tx_test VALUES ($1)", {1});
+        r.add_query("INSERT INTO tx_test VALUES ($1), ($2)", {2, 3});
+    });
+    if (!check_success(co_await conn.exec(req, check_transaction(info), &diag), diag))
+        co_return;
+    BOOST_TEST_EQ(info.num_executed, 2u);
+    BOOST_TEST_EQ(info.affected_rows, 3u);
+    BOOST_TEST(info.committed);
+
+    // Only the committed rows are there, and the connection is not left in a transaction
+    request check_req;
+    check_req.add_query("SELECT COUNT(*)::INT AS value FROM tx_test", {});
+    std::vector<row_int> ints;
+    if (!check_success(co_await conn.exec(check_req, response{into(ints)}, &diag), diag))
+        co_return;
+    std::vector<row_int> ints_expected{{.value = 3}};
+    BOOST_TEST_ALL_EQ(ints.begin(), ints.end(), ints_expected.begin(), ints_expected.end());
+}
+
+// Changes that arrive together with the server's CopyBothResponse are not lost.
+// Requires wal_level=logical, and is skipped otherwise
+capy::task<> test_replication_first_batch()
+{
+    // Setup
+    diagnostics diag;
+    co_connection conn{co_await capy::this_coro::executor};
+    if (!check_success(co_await conn.connect(default_connect_params(), &diag), diag))
+        co_return;
+    request wal_req;
+    wal_req.add_query("SELECT current_setting('wal_level') AS value", {});
+    std::vector<row_string> wal_level;
+    if (!check_success(co_await conn.exec(wal_req, response{into(wal_level)}, &diag), diag))
+        co_return;
+    if (wal_level.size() != 1u || wal_level[0].value != "logical")
+        co_return;
+
+    // Create the slot, and some changes before streaming starts, so they're already
+    // available when the server sends CopyBothResponse
+    request setup_req;
+    setup_req.add_simple_query(
+        "SELECT pg_drop_replication_slot(slot_name) FROM pg_replication_slots "
+        "WHERE slot_name = 'nativepg_first_batch';"
+        "CREATE TABLE IF NOT EXISTS repl_test (value INT NOT NULL);"
+        "DROP PUBLICATION IF EXISTS nativepg_first_batch;"
+        "CREATE PUBLICATION nativepg_first_batch FOR TABLE repl_test;"
+        "SELECT pg_create_logical_replication_slot('nativepg_first_batch', 'pgoutput');"
+        "INSERT INTO repl_test VALUES (1), (2), (3)"
+    );
+    if (!check_success(co_await conn.exec(setup_req, check(), &diag), diag))
+        co_return;
+
+    // Start streaming
+    auto repl_params = default_connect_params();
+    repl_params.replication = true;
+    co_connection repl_conn{co_await capy::this_coro::executor};
+    if (!check_success(co_await repl_conn.connect(std::move(repl_params), &diag), diag))
+        co_return;
+    co_replication_stream stream(repl_conn);
+    auto [ec] = co_await stream.start({
+        .slot_name = "nativepg_first_batch",
+        .plugin_options = {{"proto_version", "1"}, {"publication_names", "nativepg_first_batch"}},
+    });
+    BOOST_TEST_EQ(ec, std::error_code());
+
+    // The first read returns the changes. If they were lost, this would wait forever
+    auto [ec2, batch] = co_await capy::timeout(stream.read(), std::chrono::seconds(10));
+    BOOST_TEST_EQ(ec2, std::error_code());
+    BOOST_TEST(!batch.empty());
+
+    // Cleanup
+    stream.stop();
+    while (true)
+    {
+        auto [ec3, remaining] = co_await stream.read();
+        if (ec3 || remaining.empty())
+            break;
+    }
+    request cleanup_req;
+    cleanup_req.add_simple_query(
+        "SELECT pg_drop_replication_slot('nativepg_first_batch');"
+        "DROP PUBLICATION nativepg_first_batch"
+    );
+    check_success(co_await conn.exec(cleanup_req, check(), &diag), diag);
+}
+
+capy::io_task<> get_pooled_connection(co_connection_pool& pool)
+{
+    auto [ec, conn] = co_await pool.get_connection();
+    co_return {ec};
+}
+
+// Gets a connection from the pool, storing the result in ec.
+// Doesn't return an error code, so when_any finishes when this returns
+capy::io_task<> get_pooled_connection_with_timeout(co_connection_pool& pool, std::error_code& ec)
+{
+    auto [ec2] = co_await capy::timeout(get_pooled_connection(pool), std::chrono::seconds(20));
+    ec = ec2;
+    co_return {};
+}
+
+// A failing warm-up is retried like a connect failure. The handler is requested once per warm-up
+capy::task<> test_pool_on_connect()
+{
+    // Setup. The first warm-up fails because the handler doesn't match the query's fields
+    std::vector<row_missing> missing;
+    std::vector<row_int> ints;
+    response bad_handler{into(missing)};
+    response ok_handler{into(ints)};
+    std::size_t num_warm_ups = 0u;
+
+    pool_params params;
+    params.transport = default_connect_params();
+    params.initial_size = 1u;
+    params.max_size = 1u;
+    params.connect_timeout = std::chrono::seconds(10);
+    params.retry_interval = std::chrono::milliseconds(10);
+    params.on_connect.add_query("SELECT 42 AS value", {});
+    params.on_connect_handler = [&](co_connection&) -> response_handler_ref {
+        if (num_warm_ups++ == 0u)
+            return bad_handler;
+        return ok_handler;
+    };
+    co_connection_pool pool{co_await capy::this_coro::executor, std::move(params)};
+
+    // Get a connection while the pool runs
+    std::error_code ec;
+    [[maybe_unused]] auto res = co_await capy::when_any(
+        pool.run(),
+        get_pooled_connection_with_timeout(pool, ec)
+    );
+    BOOST_TEST_EQ(ec, std::error_code());
+
+    // The first connection was discarded, and the second one warmed up successfully
+    BOOST_TEST_EQ(num_warm_ups, 2u);
+    std::vector<row_int> ints_expected{{.value = 42}};
+    BOOST_TEST_ALL_EQ(ints.begin(), ints.end(), ints_expected.begin(), ints_expected.end());
+}
+
 }  // namespace
 
 int main()
 {
     run_coroutine_test(test_exec_success());
+    run_coroutine_test(test_connect_fallback_hosts());
+    run_coroutine_test(test_exec_full_duplex());
+    run_coroutine_test(test_transaction());
+    run_coroutine_test(test_replication_first_batch());
+    run_coroutine_test(test_pool_on_connect());
 
     return boost::report_errors();
 }
\ No newline at end of file
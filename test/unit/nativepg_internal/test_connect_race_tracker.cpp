@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstddef>
+
+#include "nativepg_internal/connect_race/connect_race_tracker.hpp"
+
+using nativepg::detail::connect_race_tracker;
+
+namespace {
+
+constexpr std::size_t no_attempt = connect_race_tracker::no_attempt;
+
+// Attempts start when the stagger delay elapses. The first one to succeed wins
+void test_first_success_wins()
+{
+    connect_race_tracker tracker(3u);
+    BOOST_TEST_EQ(tracker.start_next(0u), 1u);
+    BOOST_TEST(tracker.on_success(1u));
+    BOOST_TEST(tracker.succeeded());
+    BOOST_TEST_EQ(tracker.result(), 1u);
+
+    // No more attempts are started
+    BOOST_TEST_EQ(tracker.start_next(1u), no_attempt);
+
+    // The attempts that lost are cancelled. This doesn't change the outcome
+    BOOST_TEST(!tracker.on_failure(0u));
+    BOOST_TEST(tracker.succeeded());
+    BOOST_TEST_EQ(tracker.result(), 1u);
+}
+
+// If all attempts fail, the last one to do so determines the outcome
+void test_all_fail()
+{
+    connect_race_tracker tracker(3u);
+    BOOST_TEST_EQ(tracker.start_next(0u), 1u);
+    BOOST_TEST_EQ(tracker.start_next(1u), 2u);
+    BOOST_TEST_EQ(tracker.start_next(2u), no_attempt);
+    BOOST_TEST(!tracker.on_failure(1u));
+    BOOST_TEST(!tracker.on_failure(2u));
+    BOOST_TEST(tracker.on_failure(0u));
+    BOOST_TEST(!tracker.succeeded());
+    BOOST_TEST_EQ(tracker.result(), 0u);
+}
+
+// A single attempt
+void test_single_attempt()
+{
+    connect_race_tracker tracker(1u);
+    BOOST_TEST(!tracker.has_next(0u));
+    BOOST_TEST_EQ(tracker.start_next(0u), no_attempt);
+    BOOST_TEST(tracker.on_failure(0u));
+    BOOST_TEST_EQ(tracker.result(), 0u);
+}
+
+// An attempt failing before the stagger delay elapses starts the next one.
+// The delay elapsing afterwards doesn't start it again
+void test_fail_fast_starts_next()
+{
+    connect_race_tracker tracker(3u);
+    BOOST_TEST(!tracker.on_failure(0u));
+    BOOST_TEST_EQ(tracker.start_next(0u), 1u);
+    BOOST_TEST_EQ(tracker.start_next(0u), no_attempt);
+
+    // The last attempt starts once its predecessor fails, too
+    BOOST_TEST(!tracker.on_failure(1u));
+    BOOST_TEST_EQ(tracker.start_next(1u), 2u);
+    BOOST_TEST(tracker.on_success(2u));
+    BOOST_TEST_EQ(tracker.result(), 2u);
+}
+
+// Attempts that succeed after the race has been won don't replace the winner
+void test_late_success()
+{
+    connect_race_tracker tracker(2u);
+    BOOST_TEST_EQ(tracker.start_next(0u), 1u);
+    BOOST_TEST(tracker.on_success(1u));
+    BOOST_TEST(!tracker.on_success(0u));
+    BOOST_TEST_EQ(tracker.result(), 1u);
+}
+
+// A success after other attempts failed wins the race
+void test_success_after_failures()
+{
+    connect_race_tracker tracker(3u);
+    BOOST_TEST_EQ(tracker.start_next(0u), 1u);
+    BOOST_TEST(!tracker.on_failure(1u));
+    BOOST_TEST_EQ(tracker.start_next(1u), 2u);
+    BOOST_TEST(!tracker.on_failure(2u));
+    BOOST_TEST(tracker.on_success(0u));
+    BOOST_TEST(tracker.succeeded());
+    BOOST_TEST_EQ(tracker.result(), 0u);
+}
+
+}  // namespace
+
+int main()
+{
+    test_first_success_wins();
+    test_all_fail();
+    test_single_attempt();
+    test_fail_fast_starts_next();
+    test_late_success();
+    test_success_after_failures();
+
+    return boost::report_errors();
+}
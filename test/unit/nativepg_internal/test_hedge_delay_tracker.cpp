@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <chrono>
+
+#include "nativepg/hedging_params.hpp"
+#include "nativepg_internal/hedging/hedge_delay_tracker.hpp"
+
+using namespace nativepg;
+using namespace std::chrono_literals;
+using detail::hedge_delay_tracker;
+
+namespace {
+
+hedging_params make_params()
+{
+    hedging_params res;
+    res.quantile = 0.9;
+    res.window = 10u;
+    res.min_samples = 5u;
+    res.initial_delay = 50ms;
+    res.min_delay = 1ms;
+    res.max_delay = 1s;
+    res.max_hedge_ratio = 1.0;
+    return res;
+}
+
+// Records a response for the request with the given latency
+void add_sample(hedge_delay_tracker& tracker, std::chrono::milliseconds latency)
+{
+    tracker.on_request_started();
+    tracker.on_response(latency, false);
+}
+
+// Until enough samples are available, the initial delay is used
+void test_initial_delay()
+{
+    hedge_delay_tracker tracker(make_params());
+    BOOST_TEST(tracker.delay() == 50ms);
+
+    for (int i = 1; i <= 4; ++i)
+        add_sample(tracker, std::chrono::milliseconds(i));
+    BOOST_TEST(tracker.delay() == 50ms);
+
+    // The fifth sample triggers the computation: 90% of 5 samples is the 5th one
+    add_sample(tracker, 5ms);
+    BOOST_TEST(tracker.delay() == 5ms);
+}
+
+void test_quantile()
+{
+    hedge_delay_tracker tracker(make_params());
+
+    // The window is full. 90% of 10 samples is the 9th one
+    for (int i : {10, 1, 9, 2, 8, 3, 7, 4, 6, 100})
+        add_sample(tracker, std::chrono::milliseconds(i));
+    BOOST_TEST(tracker.delay() == 10ms);
+
+    // Old samples are replaced
+    for (int i = 0; i < 10; ++i)
+        add_sample(tracker, 20ms);
+    BOOST_TEST(tracker.delay() == 20ms);
+}
+
+void test_bounds()
+{
+    auto params = make_params();
+    params.min_delay = 5ms;
+    params.max_delay = 30ms;
+
+    hedge_delay_tracker tracker(params);
+    for (int i = 0; i < 5; ++i)
+        add_sample(tracker, 1ms);
+    BOOST_TEST(tracker.delay() == 5ms);
+
+    for (int i = 0; i < 10; ++i)
+        add_sample(tracker, 100ms);
+    BOOST_TEST(tracker.delay() == 30ms);
+}
+
+// Hedge wins record the request latency, which includes the hedge delay,
+// so slow first attempts keep the delay high
+void test_hedge_wins()
+{
+    hedge_delay_tracker tracker(make_params());
+    for (int i = 0; i < 8; ++i)
+        add_sample(tracker, 5ms);
+    for (int i = 0; i < 2; ++i)
+        add_sample(tracker, 100ms);
+    BOOST_TEST(tracker.delay() == 100ms);
+
+    // The same load, where slow first attempts are hedged and the hedge takes 5ms
+    for (int i = 0; i < 8; ++i)
+        add_sample(tracker, 5ms);
+    for (int i = 0; i < 2; ++i)
+    {
+        tracker.on_request_started();
+        BOOST_TEST(tracker.on_hedge_timer());
+        tracker.on_response(tracker.delay() + 5ms, true);
+    }
+    BOOST_TEST(tracker.delay() == 105ms);
+    BOOST_TEST_EQ(tracker.stats().num_hedge_wins, 2u);
+}
+
+// The fraction of hedged requests is limited
+void test_budget()
+{
+    auto params = make_params();
+    params.max_hedge_ratio = 0.25;
+    hedge_delay_tracker tracker(params);
+
+    tracker.on_request_started();
+    BOOST_TEST(tracker.on_hedge_timer());
+    tracker.on_request_started();
+    BOOST_TEST(!tracker.on_hedge_timer());
+    tracker.on_request_started();
+    tracker.on_request_started();
+    BOOST_TEST(!tracker.on_hedge_timer());
+    tracker.on_request_started();
+    BOOST_TEST(tracker.on_hedge_timer());
+
+    BOOST_TEST_EQ(tracker.stats().num_requests, 5u);
+    BOOST_TEST_EQ(tracker.stats().num_hedged, 2u);
+}
+
+// A zero ratio disables hedging
+void test_budget_zero()
+{
+    auto params = make_params();
+    params.max_hedge_ratio = 0.0;
+    hedge_delay_tracker tracker(params);
+    tracker.on_request_started();
+    BOOST_TEST(!tracker.on_hedge_timer());
+    BOOST_TEST_EQ(tracker.stats().num_hedged, 0u);
+}
+
+void test_stats()
+{
+    hedge_delay_tracker tracker(make_params());
+
+    tracker.on_request_started();
+    tracker.on_response(2ms, false);
+
+    tracker.on_request_started();
+    BOOST_TEST(tracker.on_hedge_timer());
+    tracker.on_response(3ms, true);
+
+    tracker.on_request_started();
+    BOOST_TEST(tracker.on_hedge_timer());
+    tracker.on_response(4ms, false);
+
+    const auto& st = tracker.stats();
+    BOOST_TEST_EQ(st.num_requests, 3u);
+    BOOST_TEST_EQ(st.num_hedged, 2u);
+    BOOST_TEST_EQ(st.num_hedge_wins, 1u);
+}
+
+}  // namespace
+
+int main()
+{
+    test_initial_delay();
+    test_quantile();
+    test_bounds();
+    test_hedge_wins();
+    test_budget();
+    test_budget_zero();
+    test_stats();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,172 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nativepg/routing_params.hpp"
+#include "nativepg_internal/routing_pool/host_selector.hpp"
+
+using namespace nativepg;
+using namespace std::chrono_literals;
+using detail::host_status;
+using detail::no_host;
+using detail::select_host;
+
+namespace {
+
+host_status make_host(
+    host_role role,
+    std::size_t in_use,
+    std::chrono::milliseconds latency,
+    std::uint64_t lsn = 0u
+)
+{
+    host_status res;
+    res.role = role;
+    res.in_use = in_use;
+    res.latency = latency;
+    res.lsn = lsn;
+    res.checked = true;
+    return res;
+}
+
+constexpr route_options read_write{access_mode::read_write};
+constexpr route_options read_only{access_mode::read_only};
+
+// Writes always go to the primary, wherever it is
+void test_read_write()
+{
+    std::vector<host_status> hosts{
+        make_host(host_role::replica, 0u, 1ms),
+        make_host(host_role::primary, 10u, 50ms),
+        make_host(host_role::replica, 0u, 1ms),
+    };
+    BOOST_TEST_EQ(select_host(hosts, read_write, load_balancing::least_loaded, true), 1u);
+
+    // No primary
+    hosts[1] = make_host(host_role::unknown, 0u, 1ms);
+    BOOST_TEST_EQ(select_host(hosts, read_write, load_balancing::least_loaded, true), no_host);
+}
+
+void test_read_only_least_loaded()
+{
+    std::vector<host_status> hosts{
+        make_host(host_role::primary, 0u, 1ms),
+        make_host(host_role::replica, 3u, 1ms),
+        make_host(host_role::replica, 1u, 20ms),
+        make_host(host_role::replica, 2u, 5ms),
+    };
+    BOOST_TEST_EQ(select_host(hosts, read_only, load_balancing::least_loaded, true), 2u);
+
+    // Ties are broken by latency
+    hosts[3].in_use = 1u;
+    BOOST_TEST_EQ(select_host(hosts, read_only, load_balancing::least_loaded, true), 3u);
+}
+
+void test_read_only_latency_weighted()
+{
+    // Scores: 4 * 1ms, 2 * 20ms, 3 * 5ms
+    std::vector<host_status> hosts{
+        make_host(host_role::primary, 0u, 1ms),
+        make_host(host_role::replica, 3u, 1ms),
+        make_host(host_role::replica, 1u, 20ms),
+        make_host(host_role::replica, 2u, 5ms),
+    };
+    BOOST_TEST_EQ(select_host(hosts, read_only, load_balancing::latency_weighted, true), 1u);
+
+    // Load eventually overcomes latency. Scores: 21 * 1ms, 2 * 20ms, 3 * 5ms
+    hosts[1].in_use = 20u;
+    BOOST_TEST_EQ(select_host(hosts, read_only, load_balancing::latency_weighted, true), 3u);
+}
+
+// Unknown hosts (unreachable or not checked yet) are never selected
+void test_unknown_hosts()
+{
+    std::vector<host_status> hosts{
+        make_host(host_role::unknown, 0u, 0ms),
+        make_host(host_role::primary, 5u, 1ms),
+        make_host(host_role::unknown, 0u, 0ms),
+        make_host(host_role::replica, 5u, 1ms),
+    };
+    BOOST_TEST_EQ(select_host(hosts, read_only, load_balancing::least_loaded, true), 3u);
+    BOOST_TEST_EQ(select_host(hosts, read_only, load_balancing::latency_weighted, true), 3u);
+}
+
+void test_fallback_to_primary()
+{
+    std::vector<host_status> hosts{
+        make_host(host_role::replica, 0u, 1ms),
+        make_host(host_role::unknown, 0u, 1ms),
+    };
+
+    // No primary and no replica: nothing to do
+    hosts[0].role = host_role::unknown;
+    BOOST_TEST_EQ(select_host(hosts, read_only, load_balancing::least_loaded, true), no_host);
+
+    // Only a primary
+    hosts[1].role = host_role::primary;
+    BOOST_TEST_EQ(select_host(hosts, read_only, load_balancing::least_loaded, true), 1u);
+    BOOST_TEST_EQ(select_host(hosts, read_only, load_balancing::least_loaded, false), no_host);
+}
+
+// Replicas behind the requested position are not considered
+void test_min_lsn()
+{
+    std::vector<host_status> hosts{
+        make_host(host_role::primary, 0u, 1ms, 500u),
+        make_host(host_role::replica, 0u, 1ms, 100u),
+        make_host(host_role::replica, 9u, 1ms, 300u),
+    };
+    BOOST_TEST_EQ(select_host(hosts, {access_mode::read_only, 200u}, load_balancing::least_loaded, true), 2u);
+    BOOST_TEST_EQ(select_host(hosts, {access_mode::read_only, 400u}, load_balancing::least_loaded, true), 0u);
+    BOOST_TEST_EQ(
+        select_host(hosts, {access_mode::read_only, 400u}, load_balancing::least_loaded, false),
+        no_host
+    );
+    BOOST_TEST_EQ(select_host(hosts, {access_mode::read_only, 100u}, load_balancing::least_loaded, true), 1u);
+}
+
+void test_role_checks()
+{
+    host_status st;
+    detail::on_role_checked(st, true, 100u, 40ms);
+    BOOST_TEST(st.role == host_role::replica);
+    BOOST_TEST_EQ(st.lsn, 100u);
+    BOOST_TEST(st.latency == 40ms);
+    BOOST_TEST(st.checked);
+
+    // Latency is smoothed
+    detail::on_role_checked(st, false, 200u, 80ms);
+    BOOST_TEST(st.role == host_role::primary);
+    BOOST_TEST_EQ(st.lsn, 200u);
+    BOOST_TEST(st.latency == 50ms);
+
+    // Failures make the host unknown
+    detail::on_role_check_failed(st);
+    BOOST_TEST(st.role == host_role::unknown);
+    BOOST_TEST(st.checked);
+}
+
+}  // namespace
+
+int main()
+{
+    test_read_write();
+    test_read_only_least_loaded();
+    test_read_only_latency_weighted();
+    test_unknown_hosts();
+    test_fallback_to_primary();
+    test_min_lsn();
+    test_role_checks();
+
+    return boost::report_errors();
+}
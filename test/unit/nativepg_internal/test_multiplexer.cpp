@@ -0,0 +1,401 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/endian/conversion.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "nativepg/extended_error.hpp"
+#include "nativepg/protocol/any_backend_message.hpp"
+#include "nativepg/protocol/parse_message.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/request_priority.hpp"
+#include "nativepg/response_handler.hpp"
+#include "nativepg_internal/multiplexed_connection/multiplexer.hpp"
+
+using namespace nativepg;
+using detail::multiplexer;
+
+namespace {
+
+// Counts the messages it receives
+struct counting_handler
+{
+    std::size_t num_messages{};
+    extended_error err;
+
+    handler_setup_result setup(const request& req, std::size_t offset)
+    {
+        return offset + req.messages().size();
+    }
+    void on_message(const any_request_message&, std::size_t) { ++num_messages; }
+    const extended_error& result() const { return err; }
+};
+
+// Records the completion of a request
+struct completion
+{
+    std::optional<std::error_code> ec;
+
+    void operator()(std::error_code value) { ec = value; }
+
+    bool succeeded() const { return ec.has_value() && !*ec; }
+};
+
+// Serializes a backend message
+std::vector<unsigned char> make_message(char type, std::string_view body)
+{
+    std::vector<unsigned char> res(5u);
+    res[0] = static_cast<unsigned char>(type);
+    boost::endian::store_big_s32(res.data() + 1, static_cast<std::int32_t>(body.size() + 4u));
+    res.insert(res.end(), body.begin(), body.end());
+    return res;
+}
+
+// Delivers the response to a simple query that doesn't return rows
+std::error_code deliver_response(multiplexer& mpx)
+{
+    for (const auto& msg : {make_message('C', std::string_view("SET\0", 4)), make_message('Z', "I")})
+    {
+        auto res = protocol::parse_message(msg);
+        BOOST_TEST_EQ(res.ec, boost::system::error_code());
+        if (auto ec = mpx.on_message(res.message))
+            return ec;
+    }
+    return {};
+}
+
+request make_request(std::string_view query = "SET search_path TO public")
+{
+    request req;
+    req.add_simple_query(query);
+    req.set_idempotent_read(true);
+    return req;
+}
+
+// Concatenates the chunks returned by prepare_write
+std::vector<unsigned char> write(multiplexer& mpx)
+{
+    std::vector<unsigned char> res;
+    for (auto chunk : mpx.prepare_write())
+        res.insert(res.end(), chunk.begin(), chunk.end());
+    return res;
+}
+
+// Concatenates the payloads of the given requests
+std::vector<unsigned char> payloads(std::initializer_list<const request*> reqs)
+{
+    std::vector<unsigned char> res;
+    for (const auto* req : reqs)
+        res.insert(res.end(), req->payload().begin(), req->payload().end());
+    return res;
+}
+
+// Concurrent identical requests are written once, and all handlers get the response
+void test_shared()
+{
+    multiplexer mpx;
+    const auto req1 = make_request(), req2 = make_request(), req3 = make_request("SET x TO 1");
+    counting_handler h1, h2, h3;
+    completion c1, c2, c3;
+
+    mpx.add_shared(&req1, &h1, c1);
+    mpx.add_shared(&req2, &h2, c2);
+    mpx.add_shared(&req3, &h3, c3);
+
+    // Only two requests are written
+    std::size_t size = 0u;
+    for (auto chunk : mpx.prepare_write())
+        size += chunk.size();
+    BOOST_TEST_EQ(size, req1.payload().size() + req3.payload().size());
+
+    // The first response goes to the first two handlers
+    BOOST_TEST(!deliver_response(mpx));
+    BOOST_TEST(c1.succeeded());
+    BOOST_TEST(c2.succeeded());
+    BOOST_TEST(!c3.ec.has_value());
+    BOOST_TEST(h1.num_messages > 0u);
+    BOOST_TEST_EQ(h1.num_messages, h2.num_messages);
+    BOOST_TEST_EQ(h3.num_messages, 0u);
+
+    BOOST_TEST(!deliver_response(mpx));
+    BOOST_TEST(c3.succeeded());
+    BOOST_TEST_EQ(h3.num_messages, h1.num_messages);
+}
+
+// Requests can join in-flight executions until their response starts arriving
+void test_join_in_flight()
+{
+    multiplexer mpx;
+    const auto req = make_request();
+    counting_handler h1, h2, h3;
+    completion c1, c2, c3;
+
+    mpx.add_shared(&req, &h1, c1);
+    mpx.prepare_write();
+    mpx.add_shared(&req, &h2, c2);
+    BOOST_TEST(mpx.prepare_write().empty());
+
+    // Once the response starts arriving, a new execution is required
+    auto msg = make_message('C', std::string_view("SET\0", 4));
+    BOOST_TEST(!mpx.on_message(protocol::parse_message(msg).message));
+    mpx.add_shared(&req, &h3, c3);
+    BOOST_TEST(!mpx.prepare_write().empty());
+
+    auto rfq = make_message('Z', "I");
+    BOOST_TEST(!mpx.on_message(protocol::parse_message(rfq).message));
+    BOOST_TEST(c1.ec.has_value());
+    BOOST_TEST(c2.ec.has_value());
+    BOOST_TEST(!c3.ec.has_value());
+    BOOST_TEST(!deliver_response(mpx));
+    BOOST_TEST(c3.ec.has_value());
+}
+
+// Executions that replaced a non-joinable one in the index can be joined,
+// even after the replaced execution has finished
+void test_join_replaced()
+{
+    multiplexer mpx;
+    const auto req = make_request();
+    counting_handler h1, h2, h3;
+    completion c1, c2, c3;
+
+    mpx.add_shared(&req, &h1, c1);
+    BOOST_TEST(!mpx.prepare_write().empty());
+    auto msg = make_message('C', std::string_view("SET\0", 4));
+    BOOST_TEST(!mpx.on_message(protocol::parse_message(msg).message));
+    mpx.add_shared(&req, &h2, c2);
+    BOOST_TEST(!mpx.prepare_write().empty());
+    auto rfq = make_message('Z', "I");
+    BOOST_TEST(!mpx.on_message(protocol::parse_message(rfq).message));
+    BOOST_TEST(c1.succeeded());
+
+    // The first execution is gone. This joins the second one
+    mpx.add_shared(&req, &h3, c3);
+    BOOST_TEST(mpx.prepare_write().empty());
+    BOOST_TEST(!deliver_response(mpx));
+    BOOST_TEST(c2.succeeded());
+    BOOST_TEST(c3.succeeded());
+    BOOST_TEST_EQ(h2.num_messages, h3.num_messages);
+}
+
+// Cancelling a participant doesn't affect the others.
+// The request is cancelled once all participants are
+void test_cancel()
+{
+    multiplexer mpx;
+    counting_handler h1, h2;
+    completion c1, c2;
+
+    // The request that created the execution may be destroyed
+    std::optional<request> req1 = make_request();
+    const auto t1 = mpx.add_shared(&*req1, &h1, c1);
+    const auto req2 = make_request();
+    const auto t2 = mpx.add_shared(&req2, &h2, c2);
+    mpx.cancel(t1);
+    req1.reset();
+    BOOST_TEST(!mpx.prepare_write().empty());
+    BOOST_TEST(!deliver_response(mpx));
+    BOOST_TEST(!c1.ec.has_value());
+    BOOST_TEST_EQ(h1.num_messages, 0u);
+    BOOST_TEST(c2.succeeded());
+
+    // Cancelling all participants of a pending request means it's never written
+    const auto t3 = mpx.add_shared(&req2, &h1, c1);
+    mpx.cancel(t3);
+    BOOST_TEST(mpx.prepare_write().empty());
+    static_cast<void>(t2);
+}
+
+// Requests not marked as idempotent reads are not affected
+void test_regular_requests()
+{
+    multiplexer mpx;
+    auto req = make_request();
+    counting_handler h1, h2;
+    completion c1, c2;
+    mpx.add(&req, &h1, c1);
+    mpx.add(&req, &h2, c2);
+    std::size_t size = 0u;
+    for (auto chunk : mpx.prepare_write())
+        size += chunk.size();
+    BOOST_TEST_EQ(size, 2u * req.payload().size());
+}
+
+// Pending requests are written in priority order, and responses are matched accordingly
+void test_priorities()
+{
+    multiplexer mpx;
+    const auto req1 = make_request("SET x TO 1"), req2 = make_request("SET x TO 2"),
+               req3 = make_request("SET x TO 3");
+    counting_handler h1, h2, h3;
+    completion c1, c2, c3;
+    mpx.add(&req1, &h1, c1, request_priority::low);
+    mpx.add(&req2, &h2, c2);
+    mpx.add(&req3, &h3, c3, request_priority::high);
+    BOOST_TEST(write(mpx) == payloads({&req3, &req2, &req1}));
+
+    BOOST_TEST(!deliver_response(mpx));
+    BOOST_TEST(c3.succeeded());
+    BOOST_TEST(!c2.ec.has_value());
+    BOOST_TEST(!deliver_response(mpx));
+    BOOST_TEST(c2.succeeded());
+    BOOST_TEST(!c1.ec.has_value());
+    BOOST_TEST(!deliver_response(mpx));
+    BOOST_TEST(c1.succeeded());
+}
+
+// By default, writes are not limited: all pending requests are written at once
+void test_default_write_limits()
+{
+    multiplexer mpx;
+    const auto req1 = make_request("SET x TO 1"), req2 = make_request("SET x TO 2"),
+               req3 = make_request("SET x TO 3");
+    counting_handler h1, h2, h3;
+    completion c1, c2, c3;
+    mpx.add(&req1, &h1, c1, request_priority::low);
+    mpx.add(&req2, &h2, c2);
+    mpx.add(&req3, &h3, c3, request_priority::high);
+    BOOST_TEST(write(mpx) == payloads({&req3, &req2, &req1}));
+    BOOST_TEST(write(mpx).empty());
+}
+
+// Limiting write sizes lets high priority requests overtake the ones added before them
+void test_max_write_size()
+{
+    multiplexer mpx;
+    const auto req1 = make_request("SET x TO 1"), req2 = make_request("SET x TO 2"),
+               req3 = make_request("SET x TO 3");
+    mpx.set_write_limits(req1.payload().size() + 1u, 8u);
+    counting_handler h1, h2, h3;
+    completion c1, c2, c3;
+    mpx.add(&req1, &h1, c1, request_priority::low);
+    mpx.add(&req2, &h2, c2, request_priority::low);
+    BOOST_TEST(write(mpx) == payloads({&req1}));
+    mpx.add(&req3, &h3, c3, request_priority::high);
+    BOOST_TEST(write(mpx) == payloads({&req3}));
+    BOOST_TEST(write(mpx) == payloads({&req2}));
+    BOOST_TEST(write(mpx).empty());
+
+    // Requests bigger than the limit are written on their own
+    mpx.set_write_limits(1u, 8u);
+    mpx.add(&req1, &h1, c1);
+    mpx.add(&req2, &h2, c2);
+    BOOST_TEST(write(mpx) == payloads({&req1}));
+    BOOST_TEST(write(mpx) == payloads({&req2}));
+
+    // Zero means no limit
+    mpx.set_write_limits(0u, 8u);
+    mpx.add(&req1, &h1, c1);
+    mpx.add(&req2, &h2, c2);
+    BOOST_TEST(write(mpx) == payloads({&req1, &req2}));
+}
+
+// Low priority requests are eventually written, even if higher priority ones keep arriving
+void test_starvation()
+{
+    multiplexer mpx;
+    const auto low_req = make_request("SET x TO 1"), high_req = make_request("SET x TO 2");
+    mpx.set_write_limits(1u, 2u);
+    counting_handler h;
+    completion c;
+    mpx.add(&low_req, &h, c, request_priority::low);
+    for (int i = 0; i < 2; ++i)
+    {
+        mpx.add(&high_req, &h, c, request_priority::high);
+        BOOST_TEST(write(mpx) == payloads({&high_req}));
+    }
+    mpx.add(&high_req, &h, c, request_priority::high);
+    BOOST_TEST(write(mpx) == payloads({&low_req}));
+    BOOST_TEST(write(mpx) == payloads({&high_req}));
+
+    // Cancelled requests don't count
+    mpx.add(&low_req, &h, c, request_priority::low);
+    mpx.cancel(mpx.add(&low_req, &h, c, request_priority::low));
+    BOOST_TEST(write(mpx) == payloads({&low_req}));
+    BOOST_TEST(write(mpx).empty());
+}
+
+// Joining a pending shared execution with a higher priority raises the execution's priority
+void test_shared_priority()
+{
+    multiplexer mpx;
+    const auto req1 = make_request("SET x TO 1"), req2 = make_request("SET x TO 2");
+    counting_handler h1, h2, h3;
+    completion c1, c2, c3;
+    mpx.add_shared(&req1, &h1, c1, request_priority::low);
+    mpx.add_shared(&req2, &h2, c2);
+    mpx.add_shared(&req1, &h3, c3, request_priority::high);
+    BOOST_TEST(write(mpx) == payloads({&req1, &req2}));
+    BOOST_TEST(!deliver_response(mpx));
+    BOOST_TEST(c1.succeeded());
+    BOOST_TEST(c3.succeeded());
+    BOOST_TEST(!c2.ec.has_value());
+}
+
+// Cancelled requests must wait for the write in progress if it references their borrowed values
+void test_borrowed_values_in_use()
+{
+    multiplexer mpx;
+    const std::vector<std::byte> blob{std::byte{1}, std::byte{2}, std::byte{3}};
+    statement<borrowed_bytes> stmt{"myname"};
+    request req1, req2;
+    req1.add_execute(stmt, borrowed_bytes{blob});
+    req2.add_execute(stmt, borrowed_bytes{blob});
+    const auto req3 = make_request();
+    counting_handler h;
+    completion c1, c2, c3;
+    auto* e1 = mpx.add(&req1, &h, c1);
+    auto* e3 = mpx.add(&req3, &h, c3);
+
+    // Pending requests are not being written
+    BOOST_TEST(!mpx.borrowed_values_in_use(e1));
+
+    // Requests without borrowed values never need to wait
+    BOOST_TEST(!write(mpx).empty());
+    BOOST_TEST(mpx.borrowed_values_in_use(e1));
+    BOOST_TEST(!mpx.borrowed_values_in_use(e3));
+
+    // Once the write finishes, the values are not used anymore
+    mpx.on_write_finished();
+    BOOST_TEST(!mpx.borrowed_values_in_use(e1));
+
+    // Requests written by a previous write don't wait for the current one
+    auto* e2 = mpx.add(&req2, &h, c2);
+    BOOST_TEST(!write(mpx).empty());
+    BOOST_TEST(!mpx.borrowed_values_in_use(e1));
+    BOOST_TEST(mpx.borrowed_values_in_use(e2));
+    mpx.cancel(e1);
+    mpx.on_write_finished();
+    BOOST_TEST(!mpx.borrowed_values_in_use(e2));
+}
+
+}  // namespace
+
+int main()
+{
+    test_shared();
+    test_join_in_flight();
+    test_join_replaced();
+    test_cancel();
+    test_regular_requests();
+    test_priorities();
+    test_default_write_limits();
+    test_max_write_size();
+    test_starvation();
+    test_shared_priority();
+    test_borrowed_values_in_use();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <chrono>
+#include <system_error>
+#include <vector>
+
+#include "nativepg/connect_params.hpp"
+#include "nativepg/resolve_cache_params.hpp"
+#include "nativepg_internal/resolve_cache/resolve_cache_table.hpp"
+
+using namespace nativepg;
+using namespace std::chrono_literals;
+using table_t = detail::resolve_cache_table<int>;
+
+namespace {
+
+const auto t0 = table_t::clock::time_point() + 1h;
+
+resolve_cache_params make_params()
+{
+    resolve_cache_params res;
+    res.ttl = 30s;
+    res.negative_ttl = 5s;
+    res.refresh_ahead = 10s;
+    return res;
+}
+
+void test_lookup()
+{
+    table_t table(make_params());
+
+    // Empty
+    BOOST_TEST(table.lookup("host", 5432, t0) == nullptr);
+
+    // Hit
+    table.store("host", 5432, 42, t0);
+    const auto* e = table.lookup("host", 5432, t0 + 29s);
+    BOOST_TEST_NE(e, nullptr);
+    BOOST_TEST(*e->results == 42);
+    BOOST_TEST(!e->ec);
+
+    // The port is part of the key
+    BOOST_TEST(table.lookup("host", 5433, t0) == nullptr);
+    BOOST_TEST(table.lookup("other", 5432, t0) == nullptr);
+
+    // Expiry
+    BOOST_TEST(table.lookup("host", 5432, t0 + 30s) == nullptr);
+
+    // Storing again replaces the entry
+    table.store("host", 5432, 43, t0 + 30s);
+    e = table.lookup("host", 5432, t0 + 31s);
+    BOOST_TEST_NE(e, nullptr);
+    BOOST_TEST(*e->results == 43);
+    BOOST_TEST_EQ(table.size(), 1u);
+}
+
+void test_negative()
+{
+    table_t table(make_params());
+    const auto ec = std::make_error_code(std::errc::host_unreachable);
+
+    table.store_error("bad", 5432, ec, t0);
+    const auto* e = table.lookup("bad", 5432, t0 + 4s);
+    BOOST_TEST_NE(e, nullptr);
+    BOOST_TEST(!e->results.has_value());
+    BOOST_TEST(e->ec == ec);
+
+    // Errors expire sooner
+    BOOST_TEST(table.lookup("bad", 5432, t0 + 5s) == nullptr);
+}
+
+// A zero negative_ttl disables negative caching
+void test_negative_disabled()
+{
+    auto params = make_params();
+    params.negative_ttl = 0s;
+    table_t table(params);
+
+    table.store_error("bad", 5432, std::make_error_code(std::errc::host_unreachable), t0);
+    BOOST_TEST(table.lookup("bad", 5432, t0) == nullptr);
+    BOOST_TEST_EQ(table.size(), 0u);
+}
+
+void test_collect_refreshes()
+{
+    table_t table(make_params());
+    std::vector<host_address> output{{"garbage", 1}};
+
+    table.store("used", 5432, 1, t0);
+    table.store("unused", 5432, 2, t0);
+    table.store("fresh", 5432, 3, t0 + 15s);
+    table.store_error("failed", 5432, std::make_error_code(std::errc::host_unreachable), t0 + 20s);
+    BOOST_TEST_NE(table.lookup("used", 5432, t0), nullptr);
+    BOOST_TEST_NE(table.lookup("fresh", 5432, t0 + 15s), nullptr);
+    BOOST_TEST_NE(table.lookup("failed", 5432, t0 + 20s), nullptr);
+
+    // Nothing expires soon
+    table.collect_refreshes(t0 + 19s, output);
+    BOOST_TEST(output.empty());
+
+    // Only used, successful entries that expire within 10s are refreshed
+    table.collect_refreshes(t0 + 21s, output);
+    BOOST_TEST_EQ(output.size(), 1u);
+    BOOST_TEST_EQ(output.at(0).hostname, "used");
+    BOOST_TEST_EQ(output.at(0).port, 5432u);
+
+    // Refreshing makes the entry unused until it's looked up again.
+    // Expired entries are removed
+    table.store("used", 5432, 4, t0 + 21s);
+    table.collect_refreshes(t0 + 41s, output);
+    BOOST_TEST_EQ(output.size(), 1u);
+    BOOST_TEST_EQ(output.at(0).hostname, "fresh");
+    BOOST_TEST_EQ(table.size(), 2u);
+
+    table.collect_refreshes(t0 + 46s, output);
+    BOOST_TEST_EQ(table.size(), 1u);
+    BOOST_TEST(output.empty());
+}
+
+}  // namespace
+
+int main()
+{
+    test_lookup();
+    test_negative();
+    test_negative_disabled();
+    test_collect_refreshes();
+
+    return boost::report_errors();
+}
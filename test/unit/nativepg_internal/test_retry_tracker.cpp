@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <system_error>
+
+#include "nativepg/retry_params.hpp"
+#include "nativepg/sqlstate.hpp"
+#include "nativepg_internal/retry/retry_tracker.hpp"
+
+using namespace nativepg;
+using namespace std::chrono_literals;
+using detail::retry_tracker;
+
+namespace {
+
+const std::error_code serialization_failure = parse_sqlstate("40001");
+const std::error_code deadlock = parse_sqlstate("40P01");
+
+void test_is_retryable()
+{
+    BOOST_TEST(retry_tracker::is_retryable(serialization_failure));
+    BOOST_TEST(retry_tracker::is_retryable(deadlock));
+    BOOST_TEST(!retry_tracker::is_retryable(parse_sqlstate("23505")));  // unique violation
+    BOOST_TEST(!retry_tracker::is_retryable(std::make_error_code(std::errc::connection_reset)));
+    BOOST_TEST(!retry_tracker::is_retryable(std::error_code()));
+}
+
+void test_max_attempts()
+{
+    retry_params params;
+    params.max_attempts = 3u;
+    retry_tracker tracker(params);
+
+    tracker.on_request_started();
+    BOOST_TEST(tracker.on_failure(1u, serialization_failure));
+    BOOST_TEST(tracker.on_failure(2u, deadlock));
+    BOOST_TEST(!tracker.on_failure(3u, serialization_failure));
+    BOOST_TEST_EQ(tracker.stats().num_requests, 1u);
+    BOOST_TEST_EQ(tracker.stats().num_retries, 2u);
+    BOOST_TEST_EQ(tracker.stats().num_budget_exhausted, 0u);
+
+    // Other errors are never retried
+    BOOST_TEST(!tracker.on_failure(1u, parse_sqlstate("23505")));
+    BOOST_TEST_EQ(tracker.stats().num_retries, 2u);
+}
+
+// Retries are limited to a fraction of the requests
+void test_budget()
+{
+    retry_params params;
+    params.max_attempts = 100u;
+    params.retry_ratio = 0.5;
+    params.max_retry_tokens = 2.0;
+    retry_tracker tracker(params);
+
+    // The initial tokens can be spent right away
+    tracker.on_request_started();
+    BOOST_TEST(tracker.on_failure(1u, serialization_failure));
+    BOOST_TEST(tracker.on_failure(2u, serialization_failure));
+    BOOST_TEST(!tracker.on_failure(3u, serialization_failure));
+    BOOST_TEST_EQ(tracker.stats().num_budget_exhausted, 1u);
+
+    // Each request earns half a retry
+    tracker.on_request_started();
+    BOOST_TEST(!tracker.on_failure(1u, serialization_failure));
+    tracker.on_request_started();
+    BOOST_TEST(tracker.on_failure(1u, serialization_failure));
+    BOOST_TEST_EQ(tracker.stats().num_retries, 3u);
+    BOOST_TEST_EQ(tracker.stats().num_budget_exhausted, 2u);
+
+    // Tokens don't accumulate beyond the maximum
+    for (int i = 0; i < 100; ++i)
+        tracker.on_request_started();
+    BOOST_TEST(tracker.on_failure(1u, deadlock));
+    BOOST_TEST(tracker.on_failure(1u, deadlock));
+    BOOST_TEST(!tracker.on_failure(1u, deadlock));
+}
+
+void test_backoff()
+{
+    retry_params params;
+    params.initial_backoff = 10ms;
+    params.max_backoff = 100ms;
+    params.backoff_multiplier = 2.0;
+    retry_tracker tracker(params);
+
+    // Exponential growth. The maximum value is chosen when random is close to one
+    BOOST_TEST(tracker.backoff(1u, 1.0) == 10ms);
+    BOOST_TEST(tracker.backoff(2u, 1.0) == 20ms);
+    BOOST_TEST(tracker.backoff(3u, 1.0) == 40ms);
+    BOOST_TEST(tracker.backoff(4u, 1.0) == 80ms);
+    BOOST_TEST(tracker.backoff(5u, 1.0) == 100ms);
+    BOOST_TEST(tracker.backoff(50u, 1.0) == 100ms);
+
+    // Jitter
+    BOOST_TEST(tracker.backoff(1u, 0.0) == 5ms);
+    BOOST_TEST(tracker.backoff(3u, 0.5) == 30ms);
+    BOOST_TEST(tracker.backoff(5u, 0.0) == 50ms);
+}
+
+}  // namespace
+
+int main()
+{
+    test_is_retryable();
+    test_max_attempts();
+    test_budget();
+    test_backoff();
+
+    return boost::report_errors();
+}
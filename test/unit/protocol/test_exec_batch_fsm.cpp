@@ -0,0 +1,386 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/variant2/variant.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/exec_item.hpp"
+#include "nativepg/extended_error.hpp"
+#include "nativepg/protocol/connection_state.hpp"
+#include "nativepg/protocol/data_row.hpp"
+#include "nativepg/protocol/detail/exec_batch_fsm.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+#include "test_utils/response_msg_type.hpp"
+
+using namespace nativepg;
+using namespace nativepg::test;
+using boost::system::error_code;
+using protocol::detail::exec_batch_fsm;
+using result_type = exec_batch_fsm::result_type;
+
+namespace {
+
+const error_code server_error = boost::system::errc::make_error_code(boost::system::errc::io_error);
+
+// A handler that stores the messages it gets, and fails if it sees an error
+struct mock_handler
+{
+    std::vector<on_msg_args> msgs;
+    extended_error err;
+
+    handler_setup_result setup(const request& req, std::size_t offset)
+    {
+        return {offset + req.messages().size()};
+    }
+    void on_message(const any_request_message& msg, std::size_t offset)
+    {
+        msgs.push_back({to_type(msg), offset});
+        if (boost::variant2::holds_alternative<protocol::error_response>(msg))
+            err.code = server_error;
+    }
+    const extended_error& result() const { return err; }
+};
+
+// Serialized server messages
+void add_message(std::vector<unsigned char>& to, char type, std::string_view body)
+{
+    const auto size = static_cast<std::uint32_t>(body.size() + 4u);
+    to.push_back(static_cast<unsigned char>(type));
+    for (int shift = 24; shift >= 0; shift -= 8)
+        to.push_back(static_cast<unsigned char>(size >> shift));
+    to.insert(to.end(), body.begin(), body.end());
+}
+
+void add_command_complete(std::vector<unsigned char>& to)
+{
+    add_message(to, 'C', std::string_view("SELECT 1\0", 9u));
+}
+
+void add_ready_for_query(std::vector<unsigned char>& to) { add_message(to, 'Z', "I"); }
+
+void add_error(std::vector<unsigned char>& to)
+{
+    add_message(to, 'E', std::string_view("SERROR\0C42601\0Msyntax error\0\0", 29u));
+}
+
+// Runs the FSM until completion. The FSM should ask for a single write,
+// and then read the given server messages
+struct fixture
+{
+    protocol::connection_state st;
+    std::vector<unsigned char> written;
+    std::size_t num_writes{};
+
+    error_code run(
+        std::span<exec_item> items,
+        std::span<const unsigned char> server_data,
+        error_code write_ec = {},
+        error_code read_ec = {}
+    )
+    {
+        exec_batch_fsm fsm{items};
+        auto res = fsm.resume(st, {}, 0u);
+        while (true)
+        {
+            switch (res.type())
+            {
+                case result_type::write:
+                    ++num_writes;
+                    fsm.for_each_chunk([this](std::span<const unsigned char> chunk) {
+                        written.insert(written.end(), chunk.begin(), chunk.end());
+                    });
+                    res = fsm.resume(st, write_ec, 0u);
+                    break;
+                case result_type::read:
+                {
+                    if (server_data.empty())
+                    {
+                        res = fsm.resume(st, read_ec ? read_ec : error_code(client_errc::needs_more), 0u);
+                        break;
+                    }
+                    auto buff = res.read_buffer();
+                    auto size = (std::min)(buff.size(), server_data.size());
+                    std::copy_n(server_data.begin(), size, buff.begin());
+                    server_data = server_data.subspan(size);
+                    res = fsm.resume(st, {}, size);
+                    break;
+                }
+                case result_type::done: return res.error();
+                default: BOOST_TEST(false); return {};
+            }
+        }
+    }
+};
+
+std::vector<unsigned char> concat_payloads(std::initializer_list<const request*> reqs)
+{
+    std::vector<unsigned char> res;
+    for (const auto* req : reqs)
+        res.insert(res.end(), req->payload().begin(), req->payload().end());
+    return res;
+}
+
+// All requests are written at once, and responses are dispatched in order
+void test_success()
+{
+    request req1, req2;
+    req1.add_simple_query("SELECT 1");
+    req2.add_simple_query("SELECT 2");
+    mock_handler h1, h2;
+    exec_item items[] = {
+        {&req1, &h1},
+        {&req2, &h2},
+    };
+
+    std::vector<unsigned char> server_data;
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+
+    fixture fix;
+    BOOST_TEST_EQ(fix.run(items, server_data), error_code());
+
+    BOOST_TEST_EQ(fix.num_writes, 1u);
+    auto expected_written = concat_payloads({&req1, &req2});
+    BOOST_TEST_ALL_EQ(
+        fix.written.begin(),
+        fix.written.end(),
+        expected_written.begin(),
+        expected_written.end()
+    );
+    const on_msg_args expected_msgs[] = {
+        {response_msg_type::row_description,  0u},
+        {response_msg_type::command_complete, 0u},
+    };
+    BOOST_TEST_ALL_EQ(h1.msgs.begin(), h1.msgs.end(), std::begin(expected_msgs), std::end(expected_msgs));
+    BOOST_TEST_ALL_EQ(h2.msgs.begin(), h2.msgs.end(), std::begin(expected_msgs), std::end(expected_msgs));
+    BOOST_TEST_EQ(items[0].result.code, error_code());
+    BOOST_TEST_EQ(items[1].result.code, error_code());
+}
+
+// A server error in one request doesn't affect the others
+void test_error_isolated()
+{
+    request req1, req2, req3;
+    req1.add_simple_query("SELECT 1");
+    req2.add_simple_query("SELEC 2");
+    req3.add_simple_query("SELECT 3");
+    mock_handler h1, h2, h3;
+    exec_item items[] = {
+        {&req1, &h1},
+        {&req2, &h2},
+        {&req3, &h3},
+    };
+
+    std::vector<unsigned char> server_data;
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+    add_error(server_data);
+    add_ready_for_query(server_data);
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+
+    fixture fix;
+    BOOST_TEST_EQ(fix.run(items, server_data), error_code());
+
+    BOOST_TEST_EQ(items[0].result.code, error_code());
+    BOOST_TEST_EQ(items[1].result.code, server_error);
+    BOOST_TEST_EQ(items[2].result.code, error_code());
+    BOOST_TEST_EQ(h3.msgs.size(), 2u);
+}
+
+// Rows already in the read buffer are delivered in a single batch
+void test_rows_batch()
+{
+    struct batch_handler : mock_handler
+    {
+        std::vector<std::size_t> batch_sizes;
+
+        void on_rows(std::span<const protocol::data_row> rows, std::size_t)
+        {
+            batch_sizes.push_back(rows.size());
+        }
+    };
+
+    request req;
+    req.add_simple_query("SELECT 1");
+    batch_handler h;
+    exec_item items[] = {
+        {&req, &h}
+    };
+
+    // A resultset with no columns and three rows
+    std::vector<unsigned char> server_data;
+    add_message(server_data, 'T', std::string_view("\0\0", 2u));
+    for (int i = 0; i < 3; ++i)
+        add_message(server_data, 'D', std::string_view("\0\0", 2u));
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+
+    fixture fix;
+    BOOST_TEST_EQ(fix.run(items, server_data), error_code());
+    BOOST_TEST_EQ(items[0].result.code, error_code());
+    const std::size_t expected_sizes[] = {3u};
+    BOOST_TEST_ALL_EQ(
+        h.batch_sizes.begin(),
+        h.batch_sizes.end(),
+        std::begin(expected_sizes),
+        std::end(expected_sizes)
+    );
+}
+
+// Requests that fail the initial checks are not sent
+void test_invalid_request()
+{
+    request req1, req2, req3;
+    req1.add_simple_query("SELECT 1");
+    req3.add_simple_query("SELECT 3");
+    mock_handler h1, h2, h3;
+    exec_item items[] = {
+        {&req1, &h1},
+        {&req2, &h2},  // empty request
+        {&req3, &h3},
+    };
+
+    std::vector<unsigned char> server_data;
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+
+    fixture fix;
+    BOOST_TEST_EQ(fix.run(items, server_data), error_code());
+
+    auto expected_written = concat_payloads({&req1, &req3});
+    BOOST_TEST_ALL_EQ(
+        fix.written.begin(),
+        fix.written.end(),
+        expected_written.begin(),
+        expected_written.end()
+    );
+    BOOST_TEST_EQ(items[0].result.code, error_code());
+    BOOST_TEST_EQ(items[1].result.code, error_code(client_errc::empty_request));
+    BOOST_TEST_EQ(items[2].result.code, error_code());
+    BOOST_TEST(h2.msgs.empty());
+}
+
+// If there is nothing to send, we complete immediately
+void test_nothing_to_send()
+{
+    // No items
+    fixture fix;
+    BOOST_TEST_EQ(fix.run({}, {}), error_code());
+    BOOST_TEST_EQ(fix.num_writes, 0u);
+
+    // All items invalid
+    request req;
+    mock_handler h;
+    exec_item items[] = {
+        {&req, &h}
+    };
+    BOOST_TEST_EQ(fix.run(items, {}), error_code());
+    BOOST_TEST_EQ(fix.num_writes, 0u);
+    BOOST_TEST_EQ(items[0].result.code, error_code(client_errc::empty_request));
+}
+
+// Network errors affect all the requests that didn't complete
+void test_write_error()
+{
+    request req1, req2;
+    req1.add_simple_query("SELECT 1");
+    req2.add_simple_query("SELECT 2");
+    mock_handler h1, h2;
+    exec_item items[] = {
+        {&req1, &h1},
+        {&req2, &h2},
+    };
+
+    fixture fix;
+    const error_code ec = boost::system::errc::make_error_code(boost::system::errc::broken_pipe);
+    BOOST_TEST_EQ(fix.run(items, {}, ec), ec);
+    BOOST_TEST_EQ(items[0].result.code, ec);
+    BOOST_TEST_EQ(items[1].result.code, ec);
+}
+
+void test_read_error()
+{
+    request req1, req2;
+    req1.add_simple_query("SELECT 1");
+    req2.add_simple_query("SELECT 2");
+    mock_handler h1, h2;
+    exec_item items[] = {
+        {&req1, &h1},
+        {&req2, &h2},
+    };
+
+    // Only the first response arrives
+    std::vector<unsigned char> server_data;
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+
+    fixture fix;
+    const error_code ec = boost::system::errc::make_error_code(boost::system::errc::connection_reset);
+    BOOST_TEST_EQ(fix.run(items, server_data, {}, ec), ec);
+    BOOST_TEST_EQ(items[0].result.code, error_code());
+    BOOST_TEST_EQ(items[1].result.code, ec);
+}
+
+// Full-duplex: the responses were read while writing. Once the write finishes,
+// they're dispatched without reading. With no server data, any read would fail
+void test_response_during_write()
+{
+    request req1, req2;
+    req1.add_simple_query("SELECT 1");
+    req2.add_simple_query("SELECT 2");
+    mock_handler h1, h2;
+    exec_item items[] = {
+        {&req1, &h1},
+        {&req2, &h2},
+    };
+
+    std::vector<unsigned char> server_data;
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+    add_command_complete(server_data);
+    add_ready_for_query(server_data);
+
+    fixture fix;
+    fix.st.read_buffer.prepare(server_data.size());
+    std::copy(server_data.begin(), server_data.end(), fix.st.read_buffer.prepared_area().begin());
+    fix.st.read_buffer.commit(server_data.size());
+    BOOST_TEST_EQ(fix.run(items, {}), error_code());
+    BOOST_TEST_EQ(items[0].result.code, error_code());
+    BOOST_TEST_EQ(items[1].result.code, error_code());
+}
+
+}  // namespace
+
+int main()
+{
+    test_success();
+    test_error_isolated();
+    test_rows_batch();
+    test_invalid_request();
+    test_nothing_to_send();
+    test_write_error();
+    test_read_error();
+    test_response_during_write();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,185 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "nativepg/extended_error.hpp"
+#include "nativepg/parameter_ref.hpp"
+#include "nativepg/protocol/connection_state.hpp"
+#include "nativepg/protocol/detail/exec_fsm.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+
+using namespace nativepg;
+using boost::system::error_code;
+using protocol::detail::exec_fsm;
+using result_type = exec_fsm::result_type;
+
+namespace {
+
+const error_code read_error = boost::system::errc::make_error_code(boost::system::errc::io_error);
+
+struct mock_handler
+{
+    extended_error err;
+
+    handler_setup_result setup(const request& req, std::size_t offset)
+    {
+        return {offset + req.messages().size()};
+    }
+    void on_message(const any_request_message&, std::size_t) {}
+    const extended_error& result() const { return err; }
+};
+
+// Serialized server messages
+void add_message(std::vector<unsigned char>& to, char type, std::string_view body)
+{
+    const auto size = static_cast<std::uint32_t>(body.size() + 4u);
+    to.push_back(static_cast<unsigned char>(type));
+    for (int shift = 24; shift >= 0; shift -= 8)
+        to.push_back(static_cast<unsigned char>(size >> shift));
+    to.insert(to.end(), body.begin(), body.end());
+}
+
+std::vector<unsigned char> make_simple_query_response()
+{
+    std::vector<unsigned char> res;
+    add_message(res, 'C', std::string_view("SELECT 1\0", 9u));
+    add_message(res, 'Z', "I");
+    return res;
+}
+
+// Data that was read while writing (full-duplex)
+void add_read_data(protocol::connection_state& st, std::span<const unsigned char> data)
+{
+    st.read_buffer.prepare(data.size());
+    std::copy(data.begin(), data.end(), st.read_buffer.prepared_area().begin());
+    st.read_buffer.commit(data.size());
+}
+
+std::vector<unsigned char> concat_chunks(const exec_fsm& fsm)
+{
+    std::vector<unsigned char> res;
+    fsm.for_each_chunk([&res](std::span<const unsigned char> chunk) {
+        res.insert(res.end(), chunk.begin(), chunk.end());
+    });
+    return res;
+}
+
+// The data to write is obtained with for_each_chunk, which includes borrowed values
+void test_write_borrowed()
+{
+    const std::vector<std::byte> blob{std::byte{0xde}, std::byte{0xad}, std::byte{0xbe}, std::byte{0xef}};
+    statement<std::int32_t, borrowed_bytes> stmt{"myname"};
+    request req;
+    req.add_execute(stmt, 42, borrowed_bytes{blob});
+    statement<std::int32_t, std::vector<std::byte>> copy_stmt{"myname"};
+    request copy_req;
+    copy_req.add_execute(copy_stmt, 42, blob);
+
+    protocol::connection_state st;
+    mock_handler handler;
+    exec_fsm fsm{&req, &handler};
+    auto res = fsm.resume(st, {}, 0u);
+    BOOST_TEST(res.type() == result_type::write);
+    BOOST_TEST(res.write_data().empty());
+    auto written = concat_chunks(fsm);
+    BOOST_TEST_ALL_EQ(
+        written.begin(),
+        written.end(),
+        copy_req.payload().begin(),
+        copy_req.payload().end()
+    );
+
+    // Errors reading the response are reported
+    res = fsm.resume(st, {}, written.size());
+    BOOST_TEST(res.type() == result_type::read);
+    res = fsm.resume(st, read_error, 0u);
+    BOOST_TEST(res.type() == result_type::done);
+    BOOST_TEST_EQ(res.error(), read_error);
+}
+
+// Full-duplex: the response was read while writing. Once the write finishes,
+// the FSM completes without reading
+void test_response_during_write()
+{
+    request req;
+    req.add_simple_query("SELECT 1");
+    protocol::connection_state st;
+    mock_handler handler;
+    exec_fsm fsm{&req, &handler};
+    auto res = fsm.resume(st, {}, 0u);
+    BOOST_TEST(res.type() == result_type::write);
+    const auto size = concat_chunks(fsm).size();
+
+    add_read_data(st, make_simple_query_response());
+    res = fsm.resume(st, {}, size);
+    BOOST_TEST(res.type() == result_type::done);
+    BOOST_TEST_EQ(res.error(), error_code());
+    BOOST_TEST(st.read_buffer.committed_area().empty());
+}
+
+// Part of the response was read while writing. The rest is read afterwards
+void test_partial_response_during_write()
+{
+    request req;
+    req.add_simple_query("SELECT 1");
+    protocol::connection_state st;
+    mock_handler handler;
+    exec_fsm fsm{&req, &handler};
+    auto res = fsm.resume(st, {}, 0u);
+    BOOST_TEST(res.type() == result_type::write);
+
+    const auto response = make_simple_query_response();
+    add_read_data(st, std::span<const unsigned char>(response).subspan(0u, 7u));
+    res = fsm.resume(st, {}, concat_chunks(fsm).size());
+    BOOST_TEST(res.type() == result_type::read);
+    const auto rest = std::span<const unsigned char>(response).subspan(7u);
+    std::copy(rest.begin(), rest.end(), res.read_buffer().begin());
+    res = fsm.resume(st, {}, rest.size());
+    BOOST_TEST(res.type() == result_type::done);
+    BOOST_TEST_EQ(res.error(), error_code());
+}
+
+// Full-duplex: reading failed before the write finished, so it was cut short.
+// The read error is reported, even if part of the response was read
+void test_error_during_write()
+{
+    request req;
+    req.add_simple_query("SELECT 1");
+    protocol::connection_state st;
+    mock_handler handler;
+    exec_fsm fsm{&req, &handler};
+    auto res = fsm.resume(st, {}, 0u);
+    BOOST_TEST(res.type() == result_type::write);
+
+    add_read_data(st, make_simple_query_response());
+    res = fsm.resume(st, read_error, 10u);
+    BOOST_TEST(res.type() == result_type::done);
+    BOOST_TEST_EQ(res.error(), read_error);
+    BOOST_TEST_EQ(fsm.get_result(res.error()).code, read_error);
+}
+
+}  // namespace
+
+int main()
+{
+    test_write_borrowed();
+    test_response_during_write();
+    test_partial_response_during_write();
+    test_error_during_write();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,307 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/variant2/variant.hpp>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/protocol/detail/serialization_context.hpp"
+#include "nativepg/protocol/pgoutput.hpp"
+#include "test_utils/printing.hpp"
+
+using namespace nativepg;
+using namespace nativepg::protocol::pgoutput;
+using boost::system::error_code;
+using protocol::detail::serialization_context;
+
+namespace {
+
+void add_text_column(serialization_context& ctx, std::string_view value)
+{
+    ctx.add_byte('t');
+    ctx.add_integral(static_cast<std::int32_t>(value.size()));
+    ctx.add_bytes(value);
+}
+
+// Text, binary, NULL and unchanged TOAST values
+std::vector<unsigned char> make_insert()
+{
+    std::vector<unsigned char> res;
+    serialization_context ctx(res);
+    ctx.add_byte('I');
+    ctx.add_integral(std::int32_t(16384));
+    ctx.add_byte('N');
+    ctx.add_integral(std::int16_t(4));
+    add_text_column(ctx, "42");
+    ctx.add_byte('b');
+    ctx.add_integral(std::int32_t(2));
+    ctx.add_bytes(std::string_view("\x01\x02", 2u));
+    ctx.add_byte('n');
+    ctx.add_byte('u');
+    return res;
+}
+
+void test_begin()
+{
+    std::vector<unsigned char> data;
+    serialization_context ctx(data);
+    ctx.add_byte('B');
+    ctx.add_integral(std::int64_t(0x16b374d848));
+    ctx.add_integral(std::int64_t(1000));
+    ctx.add_integral(std::int32_t(731));
+
+    any_message msg;
+    BOOST_TEST_EQ(parse(data, msg), error_code());
+    const auto& begin = boost::variant2::get<begin_message>(msg);
+    BOOST_TEST_EQ(begin.final_lsn, 0x16b374d848u);
+    BOOST_TEST_EQ(begin.commit_time, 1000);
+    BOOST_TEST_EQ(begin.xid, 731);
+}
+
+void test_commit()
+{
+    std::vector<unsigned char> data;
+    serialization_context ctx(data);
+    ctx.add_byte('C');
+    ctx.add_integral(std::int8_t(0));
+    ctx.add_integral(std::int64_t(100));
+    ctx.add_integral(std::int64_t(120));
+    ctx.add_integral(std::int64_t(1000));
+
+    any_message msg;
+    BOOST_TEST_EQ(parse(data, msg), error_code());
+    const auto& commit = boost::variant2::get<commit_message>(msg);
+    BOOST_TEST_EQ(commit.commit_lsn, 100u);
+    BOOST_TEST_EQ(commit.end_lsn, 120u);
+    BOOST_TEST_EQ(commit.commit_time, 1000);
+}
+
+void test_relation()
+{
+    std::vector<unsigned char> data;
+    serialization_context ctx(data);
+    ctx.add_byte('R');
+    ctx.add_integral(std::int32_t(16384));
+    ctx.add_string("public");
+    ctx.add_string("users");
+    ctx.add_integral(std::int8_t('d'));
+    ctx.add_integral(std::int16_t(2));
+    ctx.add_integral(std::int8_t(1));
+    ctx.add_string("id");
+    ctx.add_integral(std::int32_t(23));
+    ctx.add_integral(std::int32_t(-1));
+    ctx.add_integral(std::int8_t(0));
+    ctx.add_string("name");
+    ctx.add_integral(std::int32_t(25));
+    ctx.add_integral(std::int32_t(-1));
+
+    any_message msg;
+    BOOST_TEST_EQ(parse(data, msg), error_code());
+    const auto& rel = boost::variant2::get<relation_message>(msg);
+    BOOST_TEST_EQ(rel.oid, 16384);
+    BOOST_TEST_EQ(rel.namespace_name, "public");
+    BOOST_TEST_EQ(rel.relation_name, "users");
+    BOOST_TEST_EQ(rel.replica_identity, 'd');
+    BOOST_TEST_EQ(rel.columns.size(), 2u);
+    std::vector<relation_column> cols(rel.columns.begin(), rel.columns.end());
+    BOOST_TEST_EQ(cols.size(), 2u);
+    BOOST_TEST(cols[0].is_key());
+    BOOST_TEST_EQ(cols[0].name, "id");
+    BOOST_TEST_EQ(cols[0].type_oid, 23);
+    BOOST_TEST_EQ(cols[0].type_modifier, -1);
+    BOOST_TEST_NOT(cols[1].is_key());
+    BOOST_TEST_EQ(cols[1].name, "name");
+    BOOST_TEST_EQ(cols[1].type_oid, 25);
+}
+
+void test_insert()
+{
+    auto data = make_insert();
+
+    any_message msg;
+    BOOST_TEST_EQ(parse(data, msg), error_code());
+    const auto& ins = boost::variant2::get<insert_message>(msg);
+    BOOST_TEST_EQ(ins.relation_oid, 16384);
+    std::vector<tuple_column> cols(ins.new_tuple.columns.begin(), ins.new_tuple.columns.end());
+    BOOST_TEST_EQ(cols.size(), 4u);
+    BOOST_TEST(cols[0].kind == tuple_column_kind::text);
+    BOOST_TEST_EQ(cols[0].value.data_str(), "42");
+    BOOST_TEST(cols[1].kind == tuple_column_kind::binary);
+    BOOST_TEST_EQ(cols[1].value.data().size(), 2u);
+    BOOST_TEST_EQ(cols[1].value.data()[1], 0x02);
+    BOOST_TEST(cols[2].kind == tuple_column_kind::null);
+    BOOST_TEST(cols[2].value.is_null());
+    BOOST_TEST(cols[3].kind == tuple_column_kind::unchanged_toast);
+    BOOST_TEST(cols[3].value.is_null());
+
+    // Values point into the message
+    BOOST_TEST(cols[0].value.data().data() > data.data());
+    BOOST_TEST(cols[0].value.data().data() < data.data() + data.size());
+}
+
+void test_insert_truncated()
+{
+    auto data = make_insert();
+    for (std::size_t size = 0u; size < data.size(); ++size)
+    {
+        insert_message msg{};
+        BOOST_TEST_EQ(parse({data.data(), size}, msg), error_code(client_errc::incomplete_message));
+    }
+}
+
+void test_insert_invalid_kind()
+{
+    std::vector<unsigned char> data;
+    serialization_context ctx(data);
+    ctx.add_byte('I');
+    ctx.add_integral(std::int32_t(16384));
+    ctx.add_byte('N');
+    ctx.add_integral(std::int16_t(1));
+    ctx.add_byte('x');
+
+    insert_message msg{};
+    BOOST_TEST_EQ(parse(data, msg), error_code(client_errc::protocol_value_error));
+}
+
+void test_update()
+{
+    // Without an old tuple
+    std::vector<unsigned char> data;
+    serialization_context ctx(data);
+    ctx.add_byte('U');
+    ctx.add_integral(std::int32_t(16384));
+    ctx.add_byte('N');
+    ctx.add_integral(std::int16_t(1));
+    add_text_column(ctx, "new");
+
+    update_message msg{};
+    BOOST_TEST_EQ(parse(data, msg), error_code());
+    BOOST_TEST(msg.old_kind == old_tuple_kind::none);
+    BOOST_TEST(msg.old_tuple.columns.empty());
+    BOOST_TEST_EQ((*msg.new_tuple.columns.begin()).value.data_str(), "new");
+
+    // With a key
+    data.clear();
+    ctx.add_byte('U');
+    ctx.add_integral(std::int32_t(16384));
+    ctx.add_byte('K');
+    ctx.add_integral(std::int16_t(1));
+    add_text_column(ctx, "old");
+    ctx.add_byte('N');
+    ctx.add_integral(std::int16_t(1));
+    add_text_column(ctx, "new");
+
+    BOOST_TEST_EQ(parse(data, msg), error_code());
+    BOOST_TEST(msg.old_kind == old_tuple_kind::key);
+    BOOST_TEST_EQ((*msg.old_tuple.columns.begin()).value.data_str(), "old");
+    BOOST_TEST_EQ((*msg.new_tuple.columns.begin()).value.data_str(), "new");
+}
+
+void test_delete()
+{
+    std::vector<unsigned char> data;
+    serialization_context ctx(data);
+    ctx.add_byte('D');
+    ctx.add_integral(std::int32_t(16384));
+    ctx.add_byte('O');
+    ctx.add_integral(std::int16_t(1));
+    add_text_column(ctx, "old");
+
+    delete_message msg{};
+    BOOST_TEST_EQ(parse(data, msg), error_code());
+    BOOST_TEST_EQ(msg.relation_oid, 16384);
+    BOOST_TEST(msg.old_kind == old_tuple_kind::old);
+    BOOST_TEST_EQ((*msg.old_tuple.columns.begin()).value.data_str(), "old");
+
+    // The old tuple is mandatory
+    data[5] = 'N';
+    BOOST_TEST_EQ(parse(data, msg), error_code(client_errc::protocol_value_error));
+}
+
+void test_truncate()
+{
+    std::vector<unsigned char> data;
+    serialization_context ctx(data);
+    ctx.add_byte('T');
+    ctx.add_integral(std::int32_t(2));
+    ctx.add_integral(std::int8_t(1));
+    ctx.add_integral(std::int32_t(16384));
+    ctx.add_integral(std::int32_t(16390));
+
+    any_message msg;
+    BOOST_TEST_EQ(parse(data, msg), error_code());
+    const auto& trunc = boost::variant2::get<truncate_message>(msg);
+    BOOST_TEST_EQ(trunc.options, 1);
+    BOOST_TEST_EQ(trunc.relation_oids.size(), 2u);
+    BOOST_TEST_EQ(trunc.relation_oids[0], 16384);
+    BOOST_TEST_EQ(trunc.relation_oids[1], 16390);
+
+    // Missing OIDs
+    data.pop_back();
+    BOOST_TEST_EQ(parse(data, msg), error_code(client_errc::incomplete_message));
+}
+
+void test_logical_message()
+{
+    std::vector<unsigned char> data;
+    serialization_context ctx(data);
+    ctx.add_byte('M');
+    ctx.add_integral(std::int8_t(1));
+    ctx.add_integral(std::int64_t(100));
+    ctx.add_string("app");
+    ctx.add_integral(std::int32_t(5));
+    ctx.add_bytes(std::string_view("hello"));
+
+    any_message msg;
+    BOOST_TEST_EQ(parse(data, msg), error_code());
+    const auto& lmsg = boost::variant2::get<logical_message>(msg);
+    BOOST_TEST_EQ(lmsg.flags, 1);
+    BOOST_TEST_EQ(lmsg.lsn, 100u);
+    BOOST_TEST_EQ(lmsg.prefix, "app");
+    BOOST_TEST_EQ(lmsg.content.size(), 5u);
+}
+
+void test_extra_bytes()
+{
+    auto data = make_insert();
+    data.push_back(0);
+    any_message msg;
+    BOOST_TEST_EQ(parse(data, msg), error_code(client_errc::extra_bytes));
+}
+
+void test_unknown_type()
+{
+    const unsigned char data[] = {'S', 0, 0, 0, 1};
+    any_message msg;
+    BOOST_TEST_EQ(parse(data, msg), error_code(client_errc::unexpected_message));
+    BOOST_TEST_EQ(parse({}, msg), error_code(client_errc::unexpected_message));
+}
+
+}  // namespace
+
+int main()
+{
+    test_begin();
+    test_commit();
+    test_relation();
+    test_insert();
+    test_insert_truncated();
+    test_insert_invalid_kind();
+    test_update();
+    test_delete();
+    test_truncate();
+    test_logical_message();
+    test_extra_bytes();
+    test_unknown_type();
+
+    return boost::report_errors();
+}
@@ -13,7 +13,9 @@
 #include <cstddef>
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <ostream>
+#include <span>
 #include <vector>
 
 #include "nativepg/extended_error.hpp"
@@ -398,6 +400,104 @@ void test_execute_error()
     });
 }
 
+// --- Batched row delivery ---
+// Rows are accepted while executing, and the handler's on_message is called
+// once per row if it doesn't support batches
+void test_execute_rows_batch()
+{
+    fixture fix;
+    fix.req.add(protocol::execute{}).add(protocol::sync{});
+    const protocol::data_row rows[2]{};
+
+    // Run the FSM
+    BOOST_TEST(fix.fsm.accepts_rows());
+    BOOST_TEST_EQ(fix.fsm.resume_rows(rows), result_type::read);
+    BOOST_TEST(fix.fsm.accepts_rows());
+    BOOST_TEST_EQ(fix.fsm.resume(protocol::command_complete{}), result_type::read);
+    BOOST_TEST(!fix.fsm.accepts_rows());
+    BOOST_TEST_EQ(fix.fsm.resume(protocol::ready_for_query{}), error_code());
+
+    // Check handler messages
+    fix.check({
+        {response_msg_type::data_row,         0u},
+        {response_msg_type::data_row,         0u},
+        {response_msg_type::command_complete, 0u},
+    });
+}
+
+// In simple queries, rows are only accepted after the row description
+void test_simple_query_rows_batch()
+{
+    fixture fix;
+    fix.req.add_simple_query("SELECT 1");
+    const protocol::data_row rows[3]{};
+
+    // Run the FSM
+    BOOST_TEST(!fix.fsm.accepts_rows());
+    BOOST_TEST_EQ(fix.fsm.resume(protocol::row_description{}), result_type::read);
+    BOOST_TEST(fix.fsm.accepts_rows());
+    BOOST_TEST_EQ(fix.fsm.resume_rows(rows), result_type::read);
+    BOOST_TEST_EQ(fix.fsm.resume(protocol::command_complete{}), result_type::read);
+    BOOST_TEST(!fix.fsm.accepts_rows());
+    BOOST_TEST_EQ(fix.fsm.resume(protocol::ready_for_query{}), error_code());
+
+    // Check handler messages
+    fix.check({
+        {response_msg_type::row_description,  0u},
+        {response_msg_type::data_row,         0u},
+        {response_msg_type::data_row,         0u},
+        {response_msg_type::data_row,         0u},
+        {response_msg_type::command_complete, 0u},
+    });
+}
+
+// Rows are not accepted in other states
+void test_accepts_rows_other_messages()
+{
+    fixture fix;
+    fix.req.add(protocol::describe{protocol::portal_or_statement::portal, ""})
+        .add(protocol::execute{})
+        .add(protocol::sync{});
+
+    BOOST_TEST(!fix.fsm.accepts_rows());
+    BOOST_TEST_EQ(fix.fsm.resume(protocol::no_data{}), result_type::read);
+    BOOST_TEST(fix.fsm.accepts_rows());
+}
+
+// Handlers supporting batches get the rows in a single call
+void test_rows_batch_handler()
+{
+    struct batch_handler : mock_handler
+    {
+        std::vector<std::size_t> batch_sizes;
+
+        void on_rows(std::span<const protocol::data_row> rows, std::size_t)
+        {
+            batch_sizes.push_back(rows.size());
+        }
+    };
+
+    request req;
+    req.add(protocol::execute{}).add(protocol::sync{});
+    batch_handler handler;
+    read_response_fsm fsm{&req, &handler};
+    const protocol::data_row rows[3]{};
+
+    BOOST_TEST_EQ(fsm.resume_rows(rows), result_type::read);
+    BOOST_TEST_EQ(fsm.resume_rows(std::span(rows).subspan(1)), result_type::read);
+    BOOST_TEST_EQ(fsm.resume(protocol::command_complete{}), result_type::read);
+    BOOST_TEST_EQ(fsm.resume(protocol::ready_for_query{}), error_code());
+
+    const std::size_t expected_sizes[] = {3u, 2u};
+    BOOST_TEST_ALL_EQ(
+        handler.batch_sizes.begin(),
+        handler.batch_sizes.end(),
+        std::begin(expected_sizes),
+        std::end(expected_sizes)
+    );
+    BOOST_TEST_EQ(handler.msgs.size(), 1u);  // command_complete
+}
+
 // --- Responses to describe portal ---
 void test_describe_portal()
 {
@@ -614,6 +714,11 @@ int main()
     test_execute_portal_suspended();
     test_execute_error();
 
+    test_execute_rows_batch();
+    test_simple_query_rows_batch();
+    test_accepts_rows_other_messages();
+    test_rows_batch_handler();
+
     test_describe_portal();
     test_describe_portal_no_data();
     test_describe_portal_error();
@@ -0,0 +1,484 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/span.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/protocol/connection_state.hpp"
+#include "nativepg/protocol/detail/replication_fsm.hpp"
+#include "nativepg/protocol/replication.hpp"
+#include "nativepg/replication_params.hpp"
+
+using namespace nativepg;
+using namespace nativepg::protocol;
+using boost::system::error_code;
+using detail::replication_fsm;
+using result_type = replication_fsm::result_type;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+constexpr std::chrono::seconds status_interval{10};
+
+// Serialized server messages
+void add_message(std::vector<unsigned char>& to, char type, std::span<const unsigned char> body)
+{
+    const auto size = static_cast<std::uint32_t>(body.size() + 4u);
+    to.push_back(static_cast<unsigned char>(type));
+    for (int shift = 24; shift >= 0; shift -= 8)
+        to.push_back(static_cast<unsigned char>(size >> shift));
+    to.insert(to.end(), body.begin(), body.end());
+}
+
+void add_message(std::vector<unsigned char>& to, char type, std::string_view body)
+{
+    add_message(to, type, {reinterpret_cast<const unsigned char*>(body.data()), body.size()});
+}
+
+void add_int64(std::vector<unsigned char>& to, std::uint64_t value)
+{
+    for (int shift = 56; shift >= 0; shift -= 8)
+        to.push_back(static_cast<unsigned char>(value >> shift));
+}
+
+std::vector<unsigned char> make_xlog_data(lsn_t wal_start, lsn_t wal_end, std::string_view data)
+{
+    std::vector<unsigned char> res{'w'};
+    add_int64(res, wal_start);
+    add_int64(res, wal_end);
+    add_int64(res, 42u);
+    res.insert(res.end(), data.begin(), data.end());
+    return res;
+}
+
+std::vector<unsigned char> make_keepalive(lsn_t wal_end, bool reply_requested)
+{
+    std::vector<unsigned char> res{'k'};
+    add_int64(res, wal_end);
+    add_int64(res, 42u);
+    res.push_back(reply_requested ? 1u : 0u);
+    return res;
+}
+
+void add_copy_both(std::vector<unsigned char>& to) { add_message(to, 'W', std::string_view("\0\0\0", 3u)); }
+void add_copy_data(std::vector<unsigned char>& to, std::span<const unsigned char> body)
+{
+    add_message(to, 'd', body);
+}
+void add_copy_done(std::vector<unsigned char>& to) { add_message(to, 'c', ""); }
+void add_command_complete(std::vector<unsigned char>& to)
+{
+    add_message(to, 'C', std::string_view("START_REPLICATION\0", 18u));
+}
+void add_ready_for_query(std::vector<unsigned char>& to) { add_message(to, 'Z', "I"); }
+
+// Parses a standby status update written by the FSM
+standby_status_update parse_status(std::span<const unsigned char> data)
+{
+    BOOST_TEST_EQ(data.size(), 1u + 4u + 1u + 8u * 4u + 1u);
+    BOOST_TEST_EQ(data[0], 'd');
+    BOOST_TEST_EQ(data[5], 'r');
+    return {
+        .written_lsn = boost::endian::load_big_u64(data.data() + 6u),
+        .flushed_lsn = boost::endian::load_big_u64(data.data() + 14u),
+        .applied_lsn = boost::endian::load_big_u64(data.data() + 22u),
+        .send_time = boost::endian::load_big_s64(data.data() + 30u),
+        .reply_requested = data[38] != 0u,
+    };
+}
+
+logical_replication_params make_params()
+{
+    return {
+        .slot_name = "myslot",
+        .start_lsn = 0x100u,
+        .plugin_options = {{"proto_version", "1"}, {"publication_names", "mypub"}},
+        .status_interval = status_interval,
+    };
+}
+
+// Drives the FSM step by step
+struct fixture
+{
+    connection_state st;
+    replication_fsm fsm{make_params()};
+    clock_type::time_point now{};
+    replication_fsm::result res{error_code()};
+
+    // Feeds server data to a read
+    void read(std::span<const unsigned char> data)
+    {
+        BOOST_TEST(res.type() == result_type::read);
+        auto buff = res.read_buffer();
+        BOOST_TEST_GE(buff.size(), data.size());
+        std::copy(data.begin(), data.end(), buff.begin());
+        res = fsm.resume(st, {}, data.size(), now);
+    }
+
+    // Completes a write, returning the written bytes
+    std::vector<unsigned char> write()
+    {
+        BOOST_TEST(res.type() == result_type::write);
+        auto data = res.write_data();
+        std::vector<unsigned char> written(data.begin(), data.end());
+        res = fsm.resume(st, {}, data.size(), now);
+        return written;
+    }
+
+    // Starts the FSM and puts it in CopyBoth mode
+    void start()
+    {
+        res = fsm.resume(st, {}, 0u, now);
+        write();
+        std::vector<unsigned char> server;
+        add_copy_both(server);
+        read(server);
+        BOOST_TEST(res.type() == result_type::started);
+        res = fsm.resume(st, {}, 0u, now);
+    }
+};
+
+void test_format_lsn()
+{
+    BOOST_TEST_EQ(format_lsn(0u), "0/0");
+    BOOST_TEST_EQ(format_lsn(0x16B374D848u), "16/B374D848");
+    BOOST_TEST_EQ(format_lsn(0xFFFFFFFFFFFFFFFFu), "FFFFFFFF/FFFFFFFF");
+}
+
+void test_compose_start_replication()
+{
+    BOOST_TEST_EQ(
+        detail::compose_start_replication(make_params()),
+        "START_REPLICATION SLOT \"myslot\" LOGICAL 0/100 "
+        "(\"proto_version\" '1', \"publication_names\" 'mypub')"
+    );
+
+    // No options, quoting
+    logical_replication_params params;
+    params.slot_name = "my\"slot";
+    params.plugin_options.push_back({"opt", "it's"});
+    BOOST_TEST_EQ(
+        detail::compose_start_replication(params),
+        "START_REPLICATION SLOT \"my\"\"slot\" LOGICAL 0/0 (\"opt\" 'it''s')"
+    );
+    params.plugin_options.clear();
+    BOOST_TEST_EQ(
+        detail::compose_start_replication(params),
+        "START_REPLICATION SLOT \"my\"\"slot\" LOGICAL 0/0"
+    );
+}
+
+void test_parse_xlog_data()
+{
+    auto msg = make_xlog_data(0x0102030405060708u, 0x1000u, "abc");
+    xlog_data value{};
+    BOOST_TEST_EQ(parse(msg, value), error_code());
+    BOOST_TEST_EQ(value.wal_start, 0x0102030405060708u);
+    BOOST_TEST_EQ(value.wal_end, 0x1000u);
+    BOOST_TEST_EQ(value.send_time, 42);
+    const std::string_view data(reinterpret_cast<const char*>(value.data.data()), value.data.size());
+    BOOST_TEST_EQ(data, "abc");
+
+    // Empty data is OK
+    msg = make_xlog_data(1u, 2u, "");
+    BOOST_TEST_EQ(parse(msg, value), error_code());
+    BOOST_TEST(value.data.empty());
+
+    // Truncated
+    msg.resize(10u);
+    BOOST_TEST_EQ(parse(msg, value), error_code(client_errc::incomplete_message));
+
+    // Bad type
+    msg = make_keepalive(1u, false);
+    BOOST_TEST_EQ(parse(msg, value), error_code(client_errc::unexpected_message));
+}
+
+void test_parse_keepalive()
+{
+    auto msg = make_keepalive(0xabcdu, true);
+    primary_keepalive value{};
+    BOOST_TEST_EQ(parse(msg, value), error_code());
+    BOOST_TEST_EQ(value.wal_end, 0xabcdu);
+    BOOST_TEST_EQ(value.send_time, 42);
+    BOOST_TEST(value.reply_requested);
+
+    // Extra bytes
+    msg.push_back(0u);
+    BOOST_TEST_EQ(parse(msg, value), error_code(client_errc::extra_bytes));
+}
+
+void test_serialize_status_update()
+{
+    std::vector<unsigned char> buff;
+    standby_status_update msg{
+        .written_lsn = 1u,
+        .flushed_lsn = 2u,
+        .applied_lsn = 3u,
+        .send_time = 4,
+        .reply_requested = true,
+    };
+    BOOST_TEST_EQ(serialize(msg, buff), error_code());
+    BOOST_TEST_EQ(buff[1], 0u);  // length
+    BOOST_TEST_EQ(buff[4], 38u);
+    auto parsed = parse_status(buff);
+    BOOST_TEST_EQ(parsed.written_lsn, 1u);
+    BOOST_TEST_EQ(parsed.flushed_lsn, 2u);
+    BOOST_TEST_EQ(parsed.applied_lsn, 3u);
+    BOOST_TEST_EQ(parsed.send_time, 4);
+    BOOST_TEST(parsed.reply_requested);
+}
+
+// START_REPLICATION is sent, and XLogData messages are delivered in batches
+void test_stream()
+{
+    fixture fix;
+    fix.res = fix.fsm.resume(fix.st, {}, 0u, fix.now);
+
+    // The query is written
+    auto written = fix.write();
+    const std::string_view expected_query = "START_REPLICATION SLOT \"myslot\" LOGICAL 0/100";
+    BOOST_TEST_EQ(written[0], 'Q');
+    auto it = std::search(written.begin(), written.end(), expected_query.begin(), expected_query.end());
+    BOOST_TEST(it != written.end());
+
+    // CopyBoth and some data, in the same read
+    std::vector<unsigned char> server;
+    add_copy_both(server);
+    add_copy_data(server, make_xlog_data(0x100u, 0x200u, "first"));
+    add_copy_data(server, make_xlog_data(0x105u, 0x200u, "second"));
+    fix.read(server);
+    BOOST_TEST(fix.res.type() == result_type::started);
+    fix.res = fix.fsm.resume(fix.st, {}, 0u, fix.now);
+
+    // Both messages are delivered in a single batch
+    BOOST_TEST(fix.res.type() == result_type::data);
+    auto batch = fix.res.xlog_messages();
+    BOOST_TEST_EQ(batch.size(), 2u);
+    BOOST_TEST_EQ(batch[0].wal_start, 0x100u);
+    BOOST_TEST_EQ(batch[0].data.size(), 5u);
+    BOOST_TEST_EQ(batch[1].wal_start, 0x105u);
+    BOOST_TEST_EQ(batch[1].data.size(), 6u);
+    BOOST_TEST_EQ(fix.fsm.received_lsn(), 0x10bu);
+
+    // No status update is sent until required
+    fix.res = fix.fsm.resume(fix.st, {}, 0u, fix.now);
+    BOOST_TEST(fix.res.type() == result_type::read);
+}
+
+// Batches stay valid until the FSM is resumed, even if a partial message
+// requires the read buffer to grow when it is
+void test_data_valid_until_resume()
+{
+    fixture fix;
+    fix.start();
+
+    // A message and the beginning of a much bigger one
+    const std::string big_data(fix.res.read_buffer().size() * 4u, 'a');
+    std::vector<unsigned char> big_msg;
+    add_copy_data(big_msg, make_xlog_data(0x105u, 0x200u, big_data));
+    std::vector<unsigned char> server;
+    add_copy_data(server, make_xlog_data(0x100u, 0x200u, "first"));
+    server.insert(server.end(), big_msg.begin(), big_msg.begin() + 10);
+    fix.read(server);
+    BOOST_TEST(fix.res.type() == result_type::data);
+    auto batch = fix.res.xlog_messages();
+    BOOST_TEST_EQ(batch.size(), 1u);
+    BOOST_TEST_EQ(
+        std::string_view(reinterpret_cast<const char*>(batch[0].data.data()), batch[0].data.size()),
+        "first"
+    );
+
+    // Resuming frees space and grows the buffer. The batch must not be used after this
+    fix.res = fix.fsm.resume(fix.st, {}, 0u, fix.now);
+    BOOST_TEST(fix.res.type() == result_type::read);
+    BOOST_TEST_GE(fix.res.read_buffer().size(), big_msg.size() - 10u);
+    fix.read(std::span<const unsigned char>(big_msg).subspan(10u));
+    BOOST_TEST(fix.res.type() == result_type::data);
+    batch = fix.res.xlog_messages();
+    BOOST_TEST_EQ(batch.size(), 1u);
+    BOOST_TEST_EQ(batch[0].wal_start, 0x105u);
+    BOOST_TEST_EQ(batch[0].data.size(), big_data.size());
+}
+
+// Status updates are sent when the interval elapses, and not per message
+void test_status_interval()
+{
+    fixture fix;
+    fix.start();
+
+    // Several messages in different reads, but before the interval elapses
+    for (lsn_t i = 0u; i < 5u; ++i)
+    {
+        std::vector<unsigned char> server;
+        add_copy_data(server, make_xlog_data(0x100u + i, 0x200u, "a"));
+        fix.now += std::chrono::seconds(1);
+        fix.read(server);
+        BOOST_TEST(fix.res.type() == result_type::data);
+        fix.fsm.confirm(0x101u + i);
+        fix.res = fix.fsm.resume(fix.st, {}, 0u, fix.now);
+        BOOST_TEST(fix.res.type() == result_type::read);
+    }
+
+    // The timer fires: the caller resumes without bytes. A single update is sent
+    fix.now = fix.fsm.next_status_time();
+    fix.res = fix.fsm.resume(fix.st, {}, 0u, fix.now);
+    auto update = parse_status(fix.write());
+    BOOST_TEST_EQ(update.written_lsn, 0x105u);
+    BOOST_TEST_EQ(update.flushed_lsn, 0x105u);
+    BOOST_TEST_EQ(update.applied_lsn, 0x105u);
+    BOOST_TEST_NOT(update.reply_requested);
+    BOOST_TEST(fix.res.type() == result_type::read);
+    BOOST_TEST(fix.fsm.next_status_time() == fix.now + status_interval);
+}
+
+// Keepalives requesting a reply trigger an immediate update
+void test_keepalive_reply()
+{
+    fixture fix;
+    fix.start();
+
+    // No reply requested
+    std::vector<unsigned char> server;
+    add_copy_data(server, make_keepalive(0x300u, false));
+    fix.read(server);
+    BOOST_TEST(fix.res.type() == result_type::read);
+    BOOST_TEST_EQ(fix.fsm.received_lsn(), 0x300u);
+
+    // Reply requested
+    server.clear();
+    add_copy_data(server, make_keepalive(0x400u, true));
+    fix.read(server);
+    auto update = parse_status(fix.write());
+    BOOST_TEST_EQ(update.written_lsn, 0x400u);
+    BOOST_TEST_EQ(update.flushed_lsn, 0u);
+    BOOST_TEST(fix.res.type() == result_type::read);
+}
+
+// Stopping sends a final status update and CopyDone
+void test_stop()
+{
+    fixture fix;
+    fix.start();
+    fix.fsm.confirm(0x150u);
+    fix.fsm.request_stop();
+
+    // Data in flight is still delivered. Then the FSM sends CopyDone
+    std::vector<unsigned char> server;
+    add_copy_data(server, make_xlog_data(0x100u, 0x200u, "a"));
+    fix.read(server);
+    BOOST_TEST(fix.res.type() == result_type::data);
+    fix.res = fix.fsm.resume(fix.st, {}, 0u, fix.now);
+    auto written = fix.write();
+    BOOST_TEST_EQ(written.size(), 39u + 5u);
+    BOOST_TEST_EQ(parse_status(std::span<const unsigned char>(written).first(39u)).flushed_lsn, 0x150u);
+    BOOST_TEST_EQ(written[39], 'c');
+
+    // The server ends the stream
+    server.clear();
+    add_copy_done(server);
+    add_command_complete(server);
+    add_ready_for_query(server);
+    fix.read(server);
+    BOOST_TEST(fix.res.type() == result_type::done);
+    BOOST_TEST_EQ(fix.res.error(), error_code());
+}
+
+// The server ending the stream is answered with CopyDone
+void test_server_copy_done()
+{
+    fixture fix;
+    fix.start();
+
+    std::vector<unsigned char> server;
+    add_copy_done(server);
+    fix.read(server);
+    auto written = fix.write();
+    BOOST_TEST_EQ(written.back(), 4u);  // CopyDone length
+    BOOST_TEST_EQ(written[written.size() - 5u], 'c');
+
+    server.clear();
+    add_command_complete(server);
+    add_ready_for_query(server);
+    fix.read(server);
+    BOOST_TEST(fix.res.type() == result_type::done);
+    BOOST_TEST_EQ(fix.res.error(), error_code());
+}
+
+// Errors before streaming (e.g. the slot doesn't exist)
+void test_start_error()
+{
+    fixture fix;
+    fix.res = fix.fsm.resume(fix.st, {}, 0u, fix.now);
+    fix.write();
+
+    std::vector<unsigned char> server;
+    add_message(server, 'E', std::string_view("SERROR\0C42704\0Mslot does not exist\0\0", 36u));
+    add_ready_for_query(server);
+    fix.read(server);
+    BOOST_TEST(fix.res.type() == result_type::done);
+    BOOST_TEST(fix.res.error() != error_code());
+    BOOST_TEST(fix.st.shared_diag.message().find("slot does not exist") != std::string_view::npos);
+}
+
+// Unknown messages in the stream are errors
+void test_unexpected_message()
+{
+    fixture fix;
+    fix.start();
+
+    std::vector<unsigned char> server;
+    const unsigned char body[] = {'x', 1, 2};
+    add_copy_data(server, body);
+    fix.read(server);
+    BOOST_TEST(fix.res.type() == result_type::done);
+    BOOST_TEST_EQ(fix.res.error(), error_code(client_errc::unexpected_message));
+}
+
+// I/O errors
+void test_read_error()
+{
+    fixture fix;
+    fix.start();
+    const auto ec = boost::system::errc::make_error_code(boost::system::errc::io_error);
+    fix.res = fix.fsm.resume(fix.st, ec, 0u, fix.now);
+    BOOST_TEST(fix.res.type() == result_type::done);
+    BOOST_TEST_EQ(fix.res.error(), ec);
+}
+
+}  // namespace
+
+int main()
+{
+    test_format_lsn();
+    test_compose_start_replication();
+    test_parse_xlog_data();
+    test_parse_keepalive();
+    test_serialize_status_update();
+    test_stream();
+    test_data_valid_until_resume();
+    test_status_interval();
+    test_keepalive_reply();
+    test_stop();
+    test_server_copy_done();
+    test_start_error();
+    test_unexpected_message();
+    test_read_error();
+
+    return boost::report_errors();
+}
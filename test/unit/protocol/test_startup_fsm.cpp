@@ -122,6 +122,35 @@ void test_auth_error()
     BOOST_TEST_EQ(diag.message(), "FATAL: 42P01: database does not exist");
 }
 
+// Replication connections send the replication startup parameter
+void test_replication()
+{
+    connect_params params{
+        .username = "postgres",
+        .password = "",
+        .database = "postgres",
+        .replication = true,
+    };
+    protocol::connection_state st;
+    startup_fsm_impl fsm{params};
+    diagnostics diag;
+
+    auto res = fsm.resume(st, diag);
+    BOOST_TEST_EQ(res.type, startup_fsm_impl::result_type::write);
+    const unsigned char expected_msg[] = {
+        0x00, 0x00, 0x00, 0x3e, 0x00, 0x03, 0x00, 0x00, 'u', 's', 'e', 'r', 0x00, 'p', 'o', 's', 't', 'g',
+        'r',  'e',  's',  0x00, 'd',  'a',  't',  'a',  'b', 'a', 's', 'e', 0x00, 'p', 'o', 's', 't', 'g',
+        'r',  'e',  's',  0x00, 'r',  'e',  'p',  'l',  'i', 'c', 'a', 't', 'i',  'o', 'n', 0x00, 'd', 'a',
+        't',  'a',  'b',  'a',  's',  'e',  0x00, 0x00,
+    };
+    BOOST_TEST_ALL_EQ(
+        st.write_buffer.begin(),
+        st.write_buffer.end(),
+        std::begin(expected_msg),
+        std::end(expected_msg)
+    );
+}
+
 // TODO: this needs much more testing once we have a more stable API
 
 }  // namespace
@@ -130,6 +159,7 @@ int main()
 {
     test_success();
     test_auth_error();
+    test_replication();
 
     return boost::report_errors();
 }
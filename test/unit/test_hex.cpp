@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/detail/hex.hpp"
+#include "test_utils/test_range_eq.hpp"
+
+using boost::system::error_code;
+using nativepg::client_errc;
+using nativepg::detail::hex_decode;
+using nativepg::detail::hex_encode;
+using namespace nativepg::test;
+
+namespace {
+
+struct
+{
+    std::vector<unsigned char> raw;
+    std::string_view encoded;
+} success_cases[] = {
+    {{},                                                 ""                  },
+    {{0x00},                                             "00"                },
+    {{0xff},                                             "ff"                },
+    {{0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef},   "0123456789abcdef"  },
+    {{0x10, 0x9a, 0xf0, 0x0f},                           "109af00f"          },
+};
+
+// Generates size bytes covering all possible values
+std::vector<unsigned char> make_bytes(std::size_t size)
+{
+    std::vector<unsigned char> res(size);
+    for (std::size_t i = 0; i < size; ++i)
+        res[i] = static_cast<unsigned char>(i * 7u + 3u);
+    return res;
+}
+
+// Reference encoding
+std::string reference_encode(const std::vector<unsigned char>& input)
+{
+    constexpr char alphabet[] = "0123456789abcdef";
+    std::string res;
+    for (unsigned char c : input)
+    {
+        res.push_back(alphabet[c >> 4]);
+        res.push_back(alphabet[c & 0x0f]);
+    }
+    return res;
+}
+
+void test_encode()
+{
+    for (const auto& tc : success_cases)
+    {
+        // Setup
+        std::string dest(tc.raw.size() * 2u, '\0');
+
+        // Encode
+        hex_encode(tc.raw, dest.data());
+
+        // Check
+        if (!test_range_eq(dest, tc.encoded))
+            std::cerr << "  In test case: " << tc.encoded << std::endl;
+    }
+}
+
+void test_decode()
+{
+    for (const auto& tc : success_cases)
+    {
+        // Setup
+        std::vector<unsigned char> dest(tc.raw.size());
+
+        // Decode
+        auto ec = hex_decode(tc.encoded, dest.data());
+
+        // Check
+        BOOST_TEST_EQ(ec, error_code());
+        if (!test_range_eq(dest, tc.raw))
+            std::cerr << "  In test case: " << tc.encoded << std::endl;
+    }
+}
+
+// Uppercase characters are accepted, too
+void test_decode_uppercase()
+{
+    // Setup
+    constexpr std::string_view input = "0123456789ABCDEFabcdefAbCdEf";
+    const unsigned char expected[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+                                      0xab, 0xcd, 0xef, 0xab, 0xcd, 0xef};
+    std::vector<unsigned char> dest(input.size() / 2u);
+
+    // Decode
+    auto ec = hex_decode(input, dest.data());
+
+    // Check
+    BOOST_TEST_EQ(ec, error_code());
+    BOOST_TEST(test_range_eq(dest, expected));
+}
+
+// Sizes that exercise the vectorized blocks and the scalar tails
+void test_roundtrip_sizes()
+{
+    for (std::size_t size = 0u; size <= 200u; ++size)
+    {
+        // Setup
+        const auto raw = make_bytes(size);
+        const auto expected = reference_encode(raw);
+        std::string encoded(size * 2u, '\0');
+        std::vector<unsigned char> decoded(size);
+
+        // Encode and decode
+        hex_encode(raw, encoded.data());
+        auto ec = hex_decode(encoded, decoded.data());
+
+        // Check
+        BOOST_TEST_EQ(ec, error_code());
+        if (!test_range_eq(encoded, expected) || !test_range_eq(decoded, raw))
+            std::cerr << "  In size: " << size << std::endl;
+    }
+}
+
+// Invalid characters are detected in every position, both in the vectorized and scalar paths
+void test_decode_invalid_char()
+{
+    constexpr char invalid_chars[] = {'/', ':', '@', 'G', '`', 'g', ' ', '\x80', '\xff', '\0'};
+    for (std::size_t size : {2u, 32u, 64u, 130u})
+    {
+        for (std::size_t pos = 0u; pos < size; ++pos)
+        {
+            for (char c : invalid_chars)
+            {
+                // Setup
+                std::string input(size, 'a');
+                input[pos] = c;
+                std::vector<unsigned char> dest(size / 2u);
+
+                // Decode
+                auto ec = hex_decode(input, dest.data());
+
+                // Check
+                if (!BOOST_TEST_EQ(ec, error_code(client_errc::protocol_value_error)))
+                {
+                    std::cerr << "  In size: " << size << ", pos: " << pos << ", char: " << int(c)
+                              << std::endl;
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+int main()
+{
+    test_encode();
+    test_decode();
+    test_decode_uppercase();
+    test_roundtrip_sizes();
+    test_decode_invalid_char();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,222 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "nativepg/notification_event.hpp"
+
+using namespace nativepg;
+
+namespace {
+
+// Iterators return proxies, so they're C++20 forward iterators but only legacy input iterators
+static_assert(std::forward_iterator<notification_batch::iterator>);
+static_assert(std::ranges::forward_range<const notification_batch>);
+using batch_iterator_traits = std::iterator_traits<notification_batch::iterator>;
+static_assert(std::is_same_v<batch_iterator_traits::iterator_category, std::input_iterator_tag>);
+
+void check_event(
+    const notification_view& actual,
+    notification_event_type type,
+    std::int32_t pid = 0,
+    std::string_view channel = {},
+    std::string_view payload = {}
+)
+{
+    BOOST_TEST(actual.type == type);
+    BOOST_TEST_EQ(actual.backend_pid, pid);
+    BOOST_TEST_EQ(actual.channel, channel);
+    BOOST_TEST_EQ(actual.payload, payload);
+}
+
+void test_push_back()
+{
+    notification_batch batch;
+    BOOST_TEST(batch.empty());
+
+    batch.push_back({notification_event_type::connect});
+    batch.push_back({notification_event_type::notify, 10, "chan1", "payload1"});
+    batch.push_back({notification_event_type::notify, 11, "chan2", ""});
+    batch.push_back({notification_event_type::notify, 12, "chan1", "payload3"});
+    batch.push_back({notification_event_type::disconnect});
+
+    BOOST_TEST_EQ(batch.size(), 5u);
+    check_event(batch[0], notification_event_type::connect);
+    check_event(batch[1], notification_event_type::notify, 10, "chan1", "payload1");
+    check_event(batch[2], notification_event_type::notify, 11, "chan2", "");
+    check_event(batch[3], notification_event_type::notify, 12, "chan1", "payload3");
+    check_event(batch[4], notification_event_type::disconnect);
+    check_event(batch.back(), notification_event_type::disconnect);
+}
+
+// Channel names are stored once
+void test_channel_interning()
+{
+    notification_batch batch;
+    batch.push_back({notification_event_type::notify, 1, "mychannel", "a"});
+    batch.push_back({notification_event_type::notify, 2, "mychannel", "b"});
+
+    BOOST_TEST(batch[0].channel.data() == batch[1].channel.data());
+    check_event(batch[1], notification_event_type::notify, 2, "mychannel", "b");
+}
+
+// Views remain usable after the arena grows
+void test_arena_growth()
+{
+    notification_batch batch;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto chan = "chan" + std::to_string(i % 7);
+        const auto payload = std::to_string(i);
+        batch.push_back({notification_event_type::notify, i, chan, payload});
+    }
+
+    BOOST_TEST_EQ(batch.size(), 1000u);
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto chan = "chan" + std::to_string(i % 7);
+        const auto payload = std::to_string(i);
+        check_event(batch[static_cast<std::size_t>(i)], notification_event_type::notify, i, chan, payload);
+    }
+}
+
+void test_pop_back()
+{
+    notification_batch batch;
+    batch.push_back({notification_event_type::notify, 1, "chan", "a"});
+    batch.push_back({notification_event_type::connect});
+    batch.pop_back();
+
+    BOOST_TEST_EQ(batch.size(), 1u);
+    check_event(batch.back(), notification_event_type::notify, 1, "chan", "a");
+}
+
+// Iteration and conversion to owning events
+void test_iteration()
+{
+    notification_batch batch;
+    batch.push_back({notification_event_type::connect});
+    batch.push_back({notification_event_type::notify, 42, "chan", "payload"});
+
+    std::vector<notification_event> events(batch.begin(), batch.end());
+    BOOST_TEST_EQ(events.size(), 2u);
+    BOOST_TEST(events[0].type == notification_event_type::connect);
+    BOOST_TEST(events[1].type == notification_event_type::notify);
+    BOOST_TEST_EQ(events[1].backend_pid, 42);
+    BOOST_TEST_EQ(events[1].channel, "chan");
+    BOOST_TEST_EQ(events[1].payload, "payload");
+
+    auto it = std::ranges::find_if(batch, [](const notification_view& evt) {
+        return evt.type == notification_event_type::notify;
+    });
+    BOOST_TEST(it != batch.end());
+    BOOST_TEST_EQ((*it).channel, "chan");
+}
+
+// Clearing and swapping keep the memory, so reusing batches doesn't allocate
+void test_clear_swap()
+{
+    notification_batch batch1, batch2;
+    batch1.push_back({notification_event_type::notify, 1, "chan", "first"});
+
+    batch2.swap(batch1);
+    BOOST_TEST(batch1.empty());
+    BOOST_TEST_EQ(batch2.size(), 1u);
+    check_event(batch2[0], notification_event_type::notify, 1, "chan", "first");
+
+    batch2.clear();
+    BOOST_TEST(batch2.empty());
+    batch2.push_back({notification_event_type::notify, 2, "other", "second"});
+    check_event(batch2[0], notification_event_type::notify, 2, "other", "second");
+}
+
+void test_erase()
+{
+    notification_batch batch;
+    batch.push_back({notification_event_type::connect});
+    batch.push_back({notification_event_type::notify, 1, "chan1", "a"});
+    batch.push_back({notification_event_type::notify, 2, "chan2", "b"});
+    batch.push_back({notification_event_type::notify, 3, "chan1", "c"});
+
+    // Middle
+    batch.erase(2u);
+    BOOST_TEST_EQ(batch.size(), 3u);
+    check_event(batch[0], notification_event_type::connect);
+    check_event(batch[1], notification_event_type::notify, 1, "chan1", "a");
+    check_event(batch[2], notification_event_type::notify, 3, "chan1", "c");
+
+    // Front
+    batch.erase(0u);
+    BOOST_TEST_EQ(batch.size(), 2u);
+    check_event(batch[0], notification_event_type::notify, 1, "chan1", "a");
+    check_event(batch[1], notification_event_type::notify, 3, "chan1", "c");
+
+    // New events can be added after erasing
+    batch.push_back({notification_event_type::notify, 4, "chan2", "d"});
+    BOOST_TEST_EQ(batch.size(), 3u);
+    check_event(batch[2], notification_event_type::notify, 4, "chan2", "d");
+}
+
+// Erasing from the front repeatedly (as in a queue) compacts the arena
+void test_erase_queue()
+{
+    notification_batch batch;
+    const std::string payload(100, 'a');
+    for (int i = 0; i < 10; ++i)
+        batch.push_back({notification_event_type::notify, i, "chan", payload + std::to_string(i)});
+
+    for (int i = 10; i < 1000; ++i)
+    {
+        batch.erase(0u);
+        batch.push_back({notification_event_type::notify, i, "chan", payload + std::to_string(i)});
+        BOOST_TEST_EQ(batch.size(), 10u);
+        const auto first_payload = payload + std::to_string(i - 9);
+        check_event(batch[0], notification_event_type::notify, i - 9, "chan", first_payload);
+        check_event(batch.back(), notification_event_type::notify, i, "chan", payload + std::to_string(i));
+    }
+}
+
+void test_num_dropped()
+{
+    notification_batch batch1, batch2;
+    BOOST_TEST_EQ(batch1.num_dropped(), 0u);
+
+    batch1.set_num_dropped(5u);
+    batch1.swap(batch2);
+    BOOST_TEST_EQ(batch1.num_dropped(), 0u);
+    BOOST_TEST_EQ(batch2.num_dropped(), 5u);
+
+    batch2.clear();
+    BOOST_TEST_EQ(batch2.num_dropped(), 0u);
+}
+
+}  // namespace
+
+int main()
+{
+    test_push_back();
+    test_channel_interning();
+    test_arena_growth();
+    test_pop_back();
+    test_iteration();
+    test_clear_swap();
+    test_erase();
+    test_erase_queue();
+    test_num_dropped();
+
+    return boost::report_errors();
+}
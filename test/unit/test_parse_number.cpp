@@ -0,0 +1,227 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "nativepg/detail/parse_number.hpp"
+
+using nativepg::detail::parse_text_floating;
+using nativepg::detail::parse_text_integer;
+using nativepg::detail::swar_is_eight_digits;
+using nativepg::detail::swar_load;
+using nativepg::detail::swar_parse_eight_digits;
+
+namespace {
+
+// The fast paths must always yield the same results as std::from_chars
+template <class T>
+void check_same_as_from_chars(std::string_view input)
+{
+    T expected{}, actual{};
+    auto [ptr, ec] = std::from_chars(input.data(), input.data() + input.size(), expected);
+    const bool expected_ok = ec == std::errc{} && ptr == input.data() + input.size();
+
+    bool actual_ok = false;
+    if constexpr (std::is_floating_point_v<T>)
+        actual_ok = parse_text_floating(input, actual);
+    else
+        actual_ok = parse_text_integer(input, actual);
+
+    if (!BOOST_TEST_EQ(actual_ok, expected_ok))
+        std::cerr << "  In input: " << input << std::endl;
+    if (expected_ok && actual_ok)
+    {
+        bool same = false;
+        if constexpr (std::is_floating_point_v<T>)
+            same = (std::isnan(expected) && std::isnan(actual)) ||
+                   (expected == actual && std::signbit(expected) == std::signbit(actual));
+        else
+            same = expected == actual;
+        if (!BOOST_TEST(same))
+            std::cerr << "  In input: " << input << std::endl;
+    }
+}
+
+void test_swar()
+{
+    BOOST_TEST(swar_is_eight_digits(swar_load("01234567")));
+    BOOST_TEST(swar_is_eight_digits(swar_load("99999999")));
+    BOOST_TEST(!swar_is_eight_digits(swar_load("0123456/")));
+    BOOST_TEST(!swar_is_eight_digits(swar_load(":1234567")));
+    BOOST_TEST(!swar_is_eight_digits(swar_load("0123-567")));
+    BOOST_TEST(!swar_is_eight_digits(swar_load("0123\xb0""567")));
+    BOOST_TEST_EQ(swar_parse_eight_digits(swar_load("01234567")), 1234567u);
+    BOOST_TEST_EQ(swar_parse_eight_digits(swar_load("98765432")), 98765432u);
+    BOOST_TEST_EQ(swar_parse_eight_digits(swar_load("00000000")), 0u);
+}
+
+void test_integer()
+{
+    constexpr std::string_view inputs[] = {
+        "0",
+        "-0",
+        "7",
+        "-7",
+        "12345678",
+        "123456789",
+        "-123456789",
+        "32767",
+        "32768",
+        "-32768",
+        "-32769",
+        "2147483647",
+        "2147483648",
+        "-2147483648",
+        "-2147483649",
+        "4294967295",
+        "4294967296",
+        "9223372036854775807",
+        "9223372036854775808",
+        "-9223372036854775808",
+        "-9223372036854775809",
+        "99999999999999999999",
+        "00000000000000000000001",
+        "-00000000000000000000001",
+        "0000000012",
+        "",
+        "-",
+        "+1",
+        " 1",
+        "1 ",
+        "1a",
+        "12345678a",
+        "1234567a9",
+        "1.0",
+        "--1",
+    };
+    for (auto input : inputs)
+    {
+        check_same_as_from_chars<std::int16_t>(input);
+        check_same_as_from_chars<std::int32_t>(input);
+        check_same_as_from_chars<std::int64_t>(input);
+        check_same_as_from_chars<std::uint32_t>(input);
+    }
+}
+
+void test_integer_random()
+{
+    std::mt19937_64 gen(42);
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto value = static_cast<std::int64_t>(gen()) >> (gen() % 64u);
+        const auto str = std::to_string(value);
+        check_same_as_from_chars<std::int16_t>(str);
+        check_same_as_from_chars<std::int32_t>(str);
+        check_same_as_from_chars<std::int64_t>(str);
+        check_same_as_from_chars<std::uint32_t>(str);
+    }
+}
+
+void test_floating()
+{
+    constexpr std::string_view inputs[] = {
+        "0",
+        "-0",
+        "0.0",
+        "-0.0",
+        "1",
+        "3.14",
+        "-3.14",
+        "0.1",
+        "0.3",
+        "42.5",
+        "123456.789",
+        ".5",
+        "5.",
+        "1e10",
+        "1E10",
+        "1e+22",
+        "1e-22",
+        "1e23",
+        "1e-23",
+        "1.5e300",
+        "1e-320",
+        "9007199254740992",
+        "9007199254740993",
+        "1.2345678901234567e-05",
+        "123456789012345678901234567890",
+        "0.000000000000000000000000000001",
+        "16777216",
+        "16777217",
+        "3.4028235e38",
+        "1e39",
+        "Infinity",
+        "-Infinity",
+        "NaN",
+        "",
+        "-",
+        ".",
+        "e5",
+        "1e",
+        "1e+",
+        "+1",
+        "1.2.3",
+        "1e5x",
+        "0x10",
+    };
+    for (auto input : inputs)
+    {
+        check_same_as_from_chars<float>(input);
+        check_same_as_from_chars<double>(input);
+    }
+}
+
+void test_floating_random()
+{
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int> exp_dist(-30, 30);
+    char buffer[64];
+    for (int i = 0; i < 10000; ++i)
+    {
+        // Short decimal numbers, like the ones stored in typical columns
+        const auto mantissa = static_cast<std::int64_t>(gen() >> (gen() % 64u)) * (gen() % 2u ? 1 : -1);
+        const int num_decimals = static_cast<int>(gen() % 8u);
+        std::string str = std::to_string(mantissa);
+        if (num_decimals > 0 && str.size() > static_cast<std::size_t>(num_decimals) + 1u)
+            str.insert(str.size() - num_decimals, ".");
+        if (gen() % 4u == 0u)
+            str += "e" + std::to_string(exp_dist(gen));
+        check_same_as_from_chars<float>(str);
+        check_same_as_from_chars<double>(str);
+
+        // Shortest representation of arbitrary doubles, as sent by the server
+        double value{};
+        std::uint64_t bits = gen();
+        std::memcpy(&value, &bits, sizeof(value));
+        auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        check_same_as_from_chars<double>(std::string_view(buffer, res.ptr));
+    }
+}
+
+}  // namespace
+
+int main()
+{
+    test_swar();
+    test_integer();
+    test_integer_random();
+    test_floating();
+    test_floating_random();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/describe/class.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/variant2/variant.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/protocol/detail/serialization_context.hpp"
+#include "nativepg/protocol/pgoutput.hpp"
+#include "nativepg/relation_cache.hpp"
+#include "test_utils/printing.hpp"
+
+using namespace nativepg;
+using boost::system::error_code;
+using protocol::detail::serialization_context;
+namespace pgoutput = protocol::pgoutput;
+
+namespace {
+
+struct user
+{
+    std::int32_t id;
+    std::string name;
+    std::optional<std::int64_t> score;
+};
+BOOST_DESCRIBE_STRUCT(user, (), (id, name, score))
+
+struct user_key
+{
+    std::int32_t id;
+};
+BOOST_DESCRIBE_STRUCT(user_key, (), (id))
+
+struct column_def
+{
+    std::string_view name;
+    std::int32_t type_oid;
+    bool key;
+};
+
+std::vector<unsigned char> make_relation(std::int32_t oid, std::initializer_list<column_def> cols)
+{
+    std::vector<unsigned char> res;
+    serialization_context ctx(res);
+    ctx.add_byte('R');
+    ctx.add_integral(oid);
+    ctx.add_string("public");
+    ctx.add_string("users");
+    ctx.add_integral(std::int8_t('d'));
+    ctx.add_integral(static_cast<std::int16_t>(cols.size()));
+    for (const auto& col : cols)
+    {
+        ctx.add_integral(static_cast<std::int8_t>(col.key ? 1 : 0));
+        ctx.add_string(col.name);
+        ctx.add_integral(col.type_oid);
+        ctx.add_integral(std::int32_t(-1));
+    }
+    return res;
+}
+
+// nullopt is a NULL, "\xff" an unchanged TOAST value
+std::vector<unsigned char> make_insert(
+    std::int32_t oid,
+    std::initializer_list<std::optional<std::string_view>> values
+)
+{
+    std::vector<unsigned char> res;
+    serialization_context ctx(res);
+    ctx.add_byte('I');
+    ctx.add_integral(oid);
+    ctx.add_byte('N');
+    ctx.add_integral(static_cast<std::int16_t>(values.size()));
+    for (const auto& value : values)
+    {
+        if (!value.has_value())
+        {
+            ctx.add_byte('n');
+        }
+        else if (*value == "\xff")
+        {
+            ctx.add_byte('u');
+        }
+        else
+        {
+            ctx.add_byte('t');
+            ctx.add_integral(static_cast<std::int32_t>(value->size()));
+            ctx.add_bytes(*value);
+        }
+    }
+    return res;
+}
+
+pgoutput::tuple_data parse_tuple(const std::vector<unsigned char>& data)
+{
+    pgoutput::insert_message msg{};
+    BOOST_TEST_EQ(pgoutput::parse(data, msg), error_code());
+    return msg.new_tuple;
+}
+
+const relation_info& store(relation_cache& cache, const std::vector<unsigned char>& data)
+{
+    pgoutput::any_message msg;
+    BOOST_TEST_EQ(pgoutput::parse(data, msg), error_code());
+    cache.on_message(msg);
+    const auto* res = cache.find(boost::variant2::get<pgoutput::relation_message>(msg).oid);
+    BOOST_TEST(res != nullptr);
+    return *res;
+}
+
+const auto users_relation = make_relation(
+    16384,
+    {{"id", 23, true}, {"score", 20, false}, {"name", 25, false}}
+);
+
+void test_store()
+{
+    relation_cache cache;
+    BOOST_TEST(cache.find(16384) == nullptr);
+
+    const auto& rel = store(cache, users_relation);
+    BOOST_TEST_EQ(cache.size(), 1u);
+    BOOST_TEST_EQ(rel.oid, 16384);
+    BOOST_TEST_EQ(rel.namespace_name, "public");
+    BOOST_TEST_EQ(rel.relation_name, "users");
+    BOOST_TEST_EQ(rel.replica_identity, 'd');
+    BOOST_TEST_EQ(rel.columns.size(), 3u);
+    BOOST_TEST_EQ(rel.columns[0].name, "id");
+    BOOST_TEST_EQ(rel.columns[0].type_oid, 23);
+    BOOST_TEST(rel.columns[0].is_key);
+    BOOST_TEST_EQ(rel.columns[2].name, "name");
+    BOOST_TEST_NOT(rel.columns[2].is_key);
+
+    // Other messages are ignored
+    cache.on_message(pgoutput::begin_message{});
+    BOOST_TEST_EQ(cache.size(), 1u);
+
+    // Redefining a relation replaces it
+    const auto version = rel.version;
+    const auto& rel2 = store(cache, make_relation(16384, {{"id", 23, true}}));
+    BOOST_TEST_EQ(cache.size(), 1u);
+    BOOST_TEST_EQ(&rel, &rel2);
+    BOOST_TEST_EQ(rel2.columns.size(), 1u);
+    BOOST_TEST_NE(rel2.version, version);
+
+    cache.clear();
+    BOOST_TEST_EQ(cache.size(), 0u);
+}
+
+void test_decode()
+{
+    relation_cache cache;
+    const auto& rel = store(cache, users_relation);
+    tuple_decoder<user> decoder;
+
+    // Columns are matched by name
+    user u{};
+    BOOST_TEST_EQ(
+        decoder.decode(rel, parse_tuple(make_insert(16384, {"1", "100", "alice"})), u),
+        error_code()
+    );
+    BOOST_TEST_EQ(u.id, 1);
+    BOOST_TEST_EQ(u.name, "alice");
+    BOOST_TEST(u.score == std::optional<std::int64_t>(100));
+
+    // NULLs
+    BOOST_TEST_EQ(decoder.decode(rel, parse_tuple(make_insert(16384, {"2", {}, "bob"})), u), error_code());
+    BOOST_TEST_EQ(u.id, 2);
+    BOOST_TEST_EQ(u.name, "bob");
+    BOOST_TEST(!u.score.has_value());
+    BOOST_TEST_EQ(
+        decoder.decode(rel, parse_tuple(make_insert(16384, {{}, {}, "bob"})), u),
+        error_code(client_errc::unexpected_null)
+    );
+
+    // Unchanged TOAST values leave the member untouched
+    BOOST_TEST_EQ(decoder.decode(rel, parse_tuple(make_insert(16384, {"3", {}, "\xff"})), u), error_code());
+    BOOST_TEST_EQ(u.id, 3);
+    BOOST_TEST_EQ(u.name, "bob");
+
+    // Tuples not matching the relation are an error
+    BOOST_TEST_EQ(
+        decoder.decode(rel, parse_tuple(make_insert(16384, {"3", {}})), u),
+        error_code(client_errc::protocol_value_error)
+    );
+
+    // Structs may contain a subset of the columns
+    tuple_decoder<user_key> key_decoder;
+    user_key k{};
+    BOOST_TEST_EQ(key_decoder.decode(rel, parse_tuple(make_insert(16384, {"7", {}, {}})), k), error_code());
+    BOOST_TEST_EQ(k.id, 7);
+}
+
+void test_decode_relation_changes()
+{
+    relation_cache cache;
+    const auto& rel = store(cache, users_relation);
+    tuple_decoder<user> decoder;
+    user u{};
+    BOOST_TEST_EQ(
+        decoder.decode(rel, parse_tuple(make_insert(16384, {"1", "100", "alice"})), u),
+        error_code()
+    );
+
+    // The column order changes. The mapping is recomputed
+    store(cache, make_relation(16384, {{"name", 25, false}, {"id", 23, true}, {"score", 20, false}}));
+    BOOST_TEST_EQ(
+        decoder.decode(rel, parse_tuple(make_insert(16384, {"carol", "4", "50"})), u),
+        error_code()
+    );
+    BOOST_TEST_EQ(u.id, 4);
+    BOOST_TEST_EQ(u.name, "carol");
+    BOOST_TEST(u.score == std::optional<std::int64_t>(50));
+
+    // A column is dropped
+    store(cache, make_relation(16384, {{"id", 23, true}, {"name", 25, false}}));
+    BOOST_TEST_EQ(
+        decoder.decode(rel, parse_tuple(make_insert(16384, {"5", "dave"})), u),
+        error_code(client_errc::field_not_found)
+    );
+}
+
+void test_decode_incompatible_type()
+{
+    relation_cache cache;
+    const auto& rel = store(
+        cache,
+        make_relation(16384, {{"id", 25, true}, {"name", 25, false}, {"score", 20, false}})
+    );
+    tuple_decoder<user> decoder;
+    user u{};
+    BOOST_TEST_EQ(
+        decoder.decode(rel, parse_tuple(make_insert(16384, {"1", "alice", "2"})), u),
+        error_code(client_errc::incompatible_field_type)
+    );
+}
+
+}  // namespace
+
+int main()
+{
+    test_store();
+    test_decode();
+    test_decode_relation_changes();
+    test_decode_incompatible_type();
+
+    return boost::report_errors();
+}
@@ -8,12 +8,19 @@
 #include <boost/assert/source_location.hpp>
 #include <boost/core/lightweight_test.hpp>
 #include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <initializer_list>
 #include <ostream>
 #include <source_location>
+#include <span>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <vector>
 
 #include "nativepg/protocol/common.hpp"
 #include "nativepg/protocol/sync.hpp"
@@ -158,6 +165,67 @@ void test_query_text()
     );
 }
 
+// bytea parameters
+void test_query_bytea()
+{
+    const std::vector<std::byte> value{std::byte{0xde}, std::byte{0xad}};
+    request req;
+    req.add_query("SELECT $1", {value});
+
+    // clang-format off
+    check_payload(req, {
+        // Parse
+        0x50, 0x00, 0x00, 0x00, 0x15, 0x00, 0x53, 0x45, 0x4c, 0x45,
+        0x43, 0x54, 0x20, 0x24, 0x31, 0x00, 0x00, 0x01, 0x00, 0x00,
+        0x00, 0x11,
+
+        // Bind
+        0x42, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x01, 0x00,
+        0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0xde, 0xad, 0x00,
+        0x00,
+
+        // Describe
+        0x44, 0x00, 0x00, 0x00, 0x06, 0x50, 0x00,
+
+        // Execute
+        0x45, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+        // Sync
+        0x53, 0x00, 0x00, 0x00, 0x04
+    });
+    // clang-format on
+}
+
+void test_query_bytea_text()
+{
+    const std::vector<std::byte> value{std::byte{0xde}, std::byte{0xad}};
+    request req;
+    req.add_query("SELECT $1", {value}, request::param_format::text);
+
+    // clang-format off
+    check_payload(req, {
+        // Parse
+        0x50, 0x00, 0x00, 0x00, 0x15, 0x00, 0x53, 0x45, 0x4c, 0x45,
+        0x43, 0x54, 0x20, 0x24, 0x31, 0x00, 0x00, 0x01, 0x00, 0x00,
+        0x00, 0x11,
+
+        // Bind
+        0x42, 0x00, 0x00, 0x00, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x01, 0x00, 0x00, 0x00, 0x06, 0x5c, 0x78, 0x64, 0x65, 0x61,
+        0x64, 0x00, 0x00,
+
+        // Describe
+        0x44, 0x00, 0x00, 0x00, 0x06, 0x50, 0x00,
+
+        // Execute
+        0x45, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+        // Sync
+        0x53, 0x00, 0x00, 0x00, 0x04
+    });
+    // clang-format on
+}
+
 // TODO: max num rows, result format codes
 
 // Prepare
@@ -317,6 +385,199 @@ void test_execute_typed_optional_args()
     );
 }
 
+// Typed values, without parameter_ref
+void test_execute_typed_values()
+{
+    statement<std::int32_t, std::string_view> stmt{"myname"};
+    request req;
+    req.add_execute(stmt, 42, "value");
+
+    // Same as test_execute_typed
+    // clang-format off
+    check_payload(req, {
+        // Bind
+        0x42, 0x00, 0x00, 0x00, 0x25, 0x00, 0x6d, 0x79, 0x6e, 0x61,
+        0x6d, 0x65, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x02, 0x00,
+        0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x2a, 0x00, 0x00, 0x00,
+        0x05, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x00, 0x00,
+
+        // Describe
+        0x44, 0x00, 0x00, 0x00, 0x06, 0x50, 0x00,
+
+        // Execute
+        0x45, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+        // Sync
+        0x53, 0x00, 0x00, 0x00, 0x04
+    });
+    // clang-format on
+
+    check_messages(
+        req,
+        {
+            request_message_type::bind,
+            request_message_type::describe,
+            request_message_type::execute,
+            request_message_type::sync,
+        }
+    );
+}
+
+// The typed and the type-erased paths generate the same messages
+void test_execute_typed_values_same_as_bound()
+{
+    const std::vector<std::byte> blob{std::byte{0xde}, std::byte{0xad}};
+    const std::string str(300, 'a');
+    statement<std::int16_t, std::int64_t, std::string, std::vector<std::byte>> stmt{"stmt"};
+    request typed_req(false), bound_req(false);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        typed_req.add_execute(stmt, static_cast<std::int16_t>(i), -1, str, blob);
+        bound_req.add_execute(stmt.bind(static_cast<std::int16_t>(i), -1, str, blob));
+    }
+    typed_req.add_sync();
+    bound_req.add_sync();
+
+    BOOST_TEST(test_range_eq(typed_req.payload(), bound_req.payload()));
+    BOOST_TEST(test_range_eq(typed_req.messages(), bound_req.messages()));
+}
+
+void test_execute_typed_values_no_params()
+{
+    statement<> stmt{"myname"};
+    request typed_req, bound_req;
+    typed_req.add_execute(stmt);
+    bound_req.add_execute(stmt.bind());
+
+    BOOST_TEST(test_range_eq(typed_req.payload(), bound_req.payload()));
+    BOOST_TEST(test_range_eq(typed_req.messages(), bound_req.messages()));
+}
+
+// Statements serialized at compile time
+using static_stmt_t = static_statement<"myname", "SELECT $1, $2", std::int32_t, std::string_view>;
+
+// The Parse message is built at compile time
+static_assert(static_stmt_t::parse_message.size() == 36u);
+static_assert(static_stmt_t::parse_message[0] == 'P');
+
+void test_prepare_static()
+{
+    constexpr static_stmt_t stmt;
+    request req;
+    req.add_prepare(stmt);
+
+    // Same as test_prepare_typed
+    // clang-format off
+    check_payload(req, {
+        // Parse
+        0x50, 0x00, 0x00, 0x00, 0x23, 0x6d, 0x79, 0x6e, 0x61, 0x6d,
+        0x65, 0x00, 0x53, 0x45, 0x4c, 0x45, 0x43, 0x54, 0x20, 0x24,
+        0x31, 0x2c, 0x20, 0x24, 0x32, 0x00, 0x00, 0x02, 0x00, 0x00,
+        0x00, 0x17, 0x00, 0x00, 0x00, 0x19,
+
+        // Sync
+        0x53, 0x00, 0x00, 0x00, 0x04,
+    });
+    // clang-format on
+
+    check_messages(req, {request_message_type::parse, request_message_type::sync});
+}
+
+void test_prepare_static_no_params()
+{
+    constexpr static_statement<"s", "SELECT 1"> stmt;
+    request req(false);
+    req.add_prepare(stmt);
+
+    // clang-format off
+    check_payload(req, {
+        0x50, 0x00, 0x00, 0x00, 0x11, 0x73, 0x00, 0x53, 0x45, 0x4c,
+        0x45, 0x43, 0x54, 0x20, 0x31, 0x00, 0x00, 0x00,
+    });
+    // clang-format on
+
+    check_messages(req, {request_message_type::parse});
+}
+
+void test_execute_static()
+{
+    constexpr static_stmt_t stmt;
+    request req;
+    req.add_execute(stmt.bind(42, "value"));
+
+    // Same as test_execute_typed
+    // clang-format off
+    check_payload(req, {
+        // Bind
+        0x42, 0x00, 0x00, 0x00, 0x25, 0x00, 0x6d, 0x79, 0x6e, 0x61,
+        0x6d, 0x65, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x02, 0x00,
+        0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x2a, 0x00, 0x00, 0x00,
+        0x05, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x00, 0x00,
+
+        // Describe
+        0x44, 0x00, 0x00, 0x00, 0x06, 0x50, 0x00,
+
+        // Execute
+        0x45, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+        // Sync
+        0x53, 0x00, 0x00, 0x00, 0x04
+    });
+    // clang-format on
+
+    check_messages(
+        req,
+        {
+            request_message_type::bind,
+            request_message_type::describe,
+            request_message_type::execute,
+            request_message_type::sync,
+        }
+    );
+}
+
+void test_execute_static_optional_args()
+{
+    constexpr static_stmt_t stmt;
+    request req;
+    req.add_execute(stmt.bind(42, "value"), request::param_format::text, protocol::format_code::binary, 10);
+
+    // clang-format off
+    check_payload(req, {
+        // Bind
+        0x42, 0x00, 0x00, 0x00, 0x23, 0x00, 0x6d, 0x79, 0x6e, 0x61,
+        0x6d, 0x65, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+        0x02, 0x34, 0x32, 0x00, 0x00, 0x00, 0x05, 0x76, 0x61, 0x6c,
+        0x75, 0x65, 0x00, 0x01, 0x00, 0x01,
+
+        // Describe
+        0x44, 0x00, 0x00, 0x00, 0x06, 0x50, 0x00,
+
+        // Execute
+        0x45, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x0a,
+
+        // Sync
+        0x53, 0x00, 0x00, 0x00, 0x04
+    });
+    // clang-format on
+}
+
+// The static and the dynamic paths generate the same messages
+void test_execute_static_same_as_dynamic()
+{
+    constexpr static_statement<"stmt", "SELECT $1, $2, $3", std::int64_t, std::string_view, std::int16_t>
+        static_stmt;
+    statement<std::int64_t, std::string_view, std::int16_t> dyn_stmt{"stmt"};
+    request static_req, dyn_req;
+
+    static_req.add_prepare(static_stmt).add_execute(static_stmt.bind(-1, "abc", 2));
+    dyn_req.add_prepare("SELECT $1, $2, $3", dyn_stmt).add_execute(dyn_stmt.bind(-1, "abc", 2));
+
+    BOOST_TEST(test_range_eq(static_req.payload(), dyn_req.payload()));
+    BOOST_TEST(test_range_eq(static_req.messages(), dyn_req.messages()));
+}
+
 // Describe
 void test_describe_statement()
 {
@@ -513,6 +774,317 @@ void test_execute_batch()
     );
 }
 
+// add_execute_batch
+void test_add_execute_batch()
+{
+    using row_t = std::tuple<std::int32_t, std::string_view>;
+    statement<std::int32_t, std::string_view> stmt{"myname"};
+    const row_t rows[] = {
+        {42, "value"},
+        {1,  "a"    },
+    };
+    request req;
+    req.add_execute_batch(stmt, std::span<const row_t>(rows));
+
+    // clang-format off
+    check_payload(req, {
+        // Bind 1
+        0x42, 0x00, 0x00, 0x00, 0x25, 0x00, 0x6d, 0x79, 0x6e, 0x61,
+        0x6d, 0x65, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x02, 0x00,
+        0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x2a, 0x00, 0x00, 0x00,
+        0x05, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x00, 0x00,
+
+        // Execute 1
+        0x45, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+        // Bind 2
+        0x42, 0x00, 0x00, 0x00, 0x21, 0x00, 0x6d, 0x79, 0x6e, 0x61,
+        0x6d, 0x65, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x02, 0x00,
+        0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+        0x01, 0x61, 0x00, 0x00,
+
+        // Execute 2
+        0x45, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+        // Sync
+        0x53, 0x00, 0x00, 0x00, 0x04
+    });
+    // clang-format on
+
+    check_messages(
+        req,
+        {
+            request_message_type::bind,
+            request_message_type::execute,
+            request_message_type::bind,
+            request_message_type::execute,
+            request_message_type::sync,
+        }
+    );
+}
+
+void test_add_execute_batch_optional_args()
+{
+    // Row elements may have a type different than the statement parameters
+    statement<std::int32_t, std::string_view> stmt{"myname"};
+    const std::vector<std::tuple<std::int16_t, std::string>> rows{
+        {42, "value"}
+    };
+    request req;
+    req.add_execute_batch(stmt, std::span(rows), request::param_format::text, protocol::format_code::binary);
+
+    // clang-format off
+    check_payload(req, {
+        // Bind
+        0x42, 0x00, 0x00, 0x00, 0x23, 0x00, 0x6d, 0x79, 0x6e, 0x61,
+        0x6d, 0x65, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+        0x02, 0x34, 0x32, 0x00, 0x00, 0x00, 0x05, 0x76, 0x61, 0x6c,
+        0x75, 0x65, 0x00, 0x01, 0x00, 0x01,
+
+        // Execute
+        0x45, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+        // Sync
+        0x53, 0x00, 0x00, 0x00, 0x04
+    });
+    // clang-format on
+
+    check_messages(
+        req,
+        {request_message_type::bind, request_message_type::execute, request_message_type::sync}
+    );
+}
+
+// Any contiguous range may be passed, without creating a span
+void test_add_execute_batch_containers()
+{
+    statement<std::int32_t> stmt{"myname"};
+    const std::vector<std::tuple<std::int32_t>> vec{{1}, {2}};
+    const std::array<std::tuple<std::int32_t>, 2u> arr{
+        {{1}, {2}}
+    };
+    request expected;
+    expected.add_execute_batch(stmt, std::span(vec));
+
+    request req1;
+    req1.add_execute_batch(stmt, vec);
+    BOOST_TEST(test_range_eq(req1.payload(), expected.payload()));
+
+    request req2;
+    req2.add_execute_batch(stmt, arr);
+    BOOST_TEST(test_range_eq(req2.payload(), expected.payload()));
+}
+
+void test_add_execute_batch_empty()
+{
+    statement<std::int32_t> stmt{"myname"};
+    request req;
+    req.add_execute_batch(stmt, std::span<const std::tuple<std::int32_t>>());
+
+    check_payload(req, {0x53, 0x00, 0x00, 0x00, 0x04});
+    check_messages(req, {request_message_type::sync});
+}
+
+void test_add_execute_batch_no_autosync()
+{
+    statement<std::int32_t> stmt{"myname"};
+    const std::vector<std::tuple<std::int32_t>> rows{{1}, {2}};
+    request req(false);
+    req.add_execute_batch(stmt, std::span(rows));
+
+    check_messages(
+        req,
+        {
+            request_message_type::bind,
+            request_message_type::execute,
+            request_message_type::bind,
+            request_message_type::execute,
+        }
+    );
+}
+
+// add_transaction
+void test_add_transaction()
+{
+    request req;
+    req.add_transaction([](request& r) {
+        r.add_query("UPDATE t SET a = $1", {42});
+        r.add_query("DELETE FROM t", {});
+    });
+
+    // BEGIN, statements and COMMIT in a pipeline segment, followed by ROLLBACK in another
+    using t = request_message_type;
+    // clang-format off
+    check_messages(
+        req,
+        {
+            t::parse, t::bind, t::describe, t::execute,  // BEGIN
+            t::parse, t::bind, t::describe, t::execute,  // UPDATE
+            t::parse, t::bind, t::describe, t::execute,  // DELETE
+            t::parse, t::bind, t::describe, t::execute,  // COMMIT
+            t::sync,
+            t::parse, t::bind, t::describe, t::execute,  // ROLLBACK
+            t::sync,
+        }
+    );
+    // clang-format on
+    BOOST_TEST(req.autosync());
+}
+
+// Syncs and simple queries are not allowed, and leave the request unchanged
+void test_add_transaction_invalid()
+{
+    request req;
+    req.add_simple_query("SELECT 1");
+    const auto initial_payload = std::vector<unsigned char>(req.payload().begin(), req.payload().end());
+
+    auto add_sync = [](request& r) { r.add_query("SELECT 1", {}).add_sync(); };
+    BOOST_TEST_THROWS(req.add_transaction(add_sync), boost::system::system_error);
+    auto add_simple = [](request& r) { r.add_simple_query("SELECT 1"); };
+    BOOST_TEST_THROWS(req.add_transaction(add_simple), boost::system::system_error);
+
+    BOOST_TEST_ALL_EQ(
+        req.payload().begin(),
+        req.payload().end(),
+        initial_payload.begin(),
+        initial_payload.end()
+    );
+    check_messages(req, {request_message_type::query});
+    BOOST_TEST(req.autosync());
+}
+
+// Borrowed parameter values
+std::vector<unsigned char> concat_chunks(const request& req)
+{
+    std::vector<unsigned char> res;
+    req.for_each_chunk([&res](std::span<const unsigned char> chunk) {
+        BOOST_TEST(!chunk.empty());
+        res.insert(res.end(), chunk.begin(), chunk.end());
+    });
+    return res;
+}
+
+void test_borrowed_bytes()
+{
+    const std::vector<std::byte> blob{std::byte{0xde}, std::byte{0xad}, std::byte{0xbe}, std::byte{0xef}};
+    statement<std::int32_t, borrowed_bytes, std::int16_t> stmt{"myname"};
+    request req;
+    req.add_execute(stmt, 42, borrowed_bytes{blob}, 1);
+
+    // The value is not part of the payload
+    BOOST_TEST(req.has_borrowed_values());
+    BOOST_TEST_EQ(req.payload().size() + blob.size(), concat_chunks(req).size());
+    std::vector<const unsigned char*> chunk_ptrs;
+    req.for_each_chunk([&chunk_ptrs](std::span<const unsigned char> chunk) {
+        chunk_ptrs.push_back(chunk.data());
+    });
+    BOOST_TEST_EQ(chunk_ptrs.size(), 3u);
+    BOOST_TEST(chunk_ptrs.at(1) == reinterpret_cast<const unsigned char*>(blob.data()));
+
+    // The bytes to write are the same as if the value had been copied
+    statement<std::int32_t, std::vector<std::byte>, std::int16_t> copy_stmt{"myname"};
+    request copy_req;
+    copy_req.add_execute(copy_stmt, 42, blob, 1);
+    BOOST_TEST(!copy_req.has_borrowed_values());
+    BOOST_TEST(test_range_eq(concat_chunks(req), copy_req.payload()));
+    BOOST_TEST(test_range_eq(concat_chunks(copy_req), copy_req.payload()));
+}
+
+void test_borrowed_text()
+{
+    const std::string value(1000, 'a');
+    statement<borrowed_text, borrowed_text> stmt{"myname"};
+    request req;
+    req.add_execute(stmt, borrowed_text{value}, borrowed_text{""});
+
+    // Borrowed values are written in order, and empty ones are skipped
+    statement<std::string_view, std::string_view> copy_stmt{"myname"};
+    request copy_req;
+    copy_req.add_execute(copy_stmt, value, "");
+    BOOST_TEST(test_range_eq(concat_chunks(req), copy_req.payload()));
+    BOOST_TEST(req.payload().size() + value.size() == copy_req.payload().size());
+}
+
+// Borrowed bytea sent as text need to be hex-encoded, so they're copied
+void test_borrowed_bytes_text()
+{
+    const std::vector<std::byte> blob{std::byte{0xde}, std::byte{0xad}};
+    using row_t = std::tuple<std::int32_t, borrowed_bytes>;
+    statement<std::int32_t, borrowed_bytes> stmt{"myname"};
+    const row_t rows[] = {
+        {1, borrowed_bytes{blob}}
+    };
+    request req;
+    req.add_execute_batch(stmt, std::span<const row_t>(rows), request::param_format::text);
+
+    BOOST_TEST(!req.has_borrowed_values());
+    BOOST_TEST(test_range_eq(concat_chunks(req), req.payload()));
+}
+
+// Type-erased functions copy borrowed values
+void test_borrowed_type_erased()
+{
+    const std::vector<std::byte> blob{std::byte{0xde}, std::byte{0xad}};
+    request req;
+    req.add_query("SELECT $1", {borrowed_bytes{blob}});
+    BOOST_TEST(!req.has_borrowed_values());
+
+    request copy_req;
+    copy_req.add_query("SELECT $1", {blob});
+    BOOST_TEST(test_range_eq(req.payload(), copy_req.payload()));
+}
+
+// Multiple borrowed values in a batch
+void test_borrowed_batch()
+{
+    const std::string v1 = "first", v2 = "second";
+    using row_t = std::tuple<std::int32_t, borrowed_text>;
+    using copy_row_t = std::tuple<std::int32_t, std::string_view>;
+    statement<std::int32_t, borrowed_text> stmt{"myname"};
+    const row_t rows[] = {
+        {1, borrowed_text{v1}},
+        {2, borrowed_text{v2}},
+    };
+    request req;
+    req.add_execute_batch(stmt, std::span<const row_t>(rows));
+
+    statement<std::int32_t, std::string_view> copy_stmt{"myname"};
+    const copy_row_t copy_rows[] = {
+        {1, v1},
+        {2, v2},
+    };
+    request copy_req;
+    copy_req.add_execute_batch(copy_stmt, std::span<const copy_row_t>(copy_rows));
+    BOOST_TEST(test_range_eq(concat_chunks(req), copy_req.payload()));
+
+    // Clearing removes borrowed values
+    req.clear();
+    BOOST_TEST(!req.has_borrowed_values());
+}
+
+// clear
+void test_clear()
+{
+    request req;
+    req.add_simple_query("SELECT 1");
+    req.add_query("SELECT $1", {42});
+    const auto* data_before = req.payload().data();
+
+    req.clear();
+
+    BOOST_TEST(req.payload().empty());
+    BOOST_TEST(req.messages().empty());
+
+    // The request can be reused. Capacity is retained
+    req.add_simple_query("select 1;");
+    BOOST_TEST(req.payload().data() == data_before);
+    check_payload(
+        req,
+        {0x51, 0x00, 0x00, 0x00, 0x0e, 0x73, 0x65, 0x6c, 0x65, 0x63, 0x74, 0x20, 0x31, 0x3b, 0x00}
+    );
+    check_messages(req, {request_message_type::query});
+}
+
 }  // namespace
 
 int main()
@@ -521,6 +1093,8 @@ int main()
 
     test_query();
     test_query_text();
+    test_query_bytea();
+    test_query_bytea_text();
 
     test_prepare_untyped();
     test_prepare_typed();
@@ -528,6 +1102,15 @@ int main()
     test_execute_untyped();
     test_execute_typed();
     test_execute_typed_optional_args();
+    test_execute_typed_values();
+    test_execute_typed_values_same_as_bound();
+    test_execute_typed_values_no_params();
+
+    test_prepare_static();
+    test_prepare_static_no_params();
+    test_execute_static();
+    test_execute_static_optional_args();
+    test_execute_static_same_as_dynamic();
 
     test_describe_statement();
     test_describe_portal();
@@ -541,5 +1124,22 @@ int main()
     test_prepare_batch();
     test_execute_batch();
 
+    test_add_execute_batch();
+    test_add_execute_batch_optional_args();
+    test_add_execute_batch_containers();
+    test_add_execute_batch_empty();
+    test_add_execute_batch_no_autosync();
+
+    test_add_transaction();
+    test_add_transaction_invalid();
+
+    test_borrowed_bytes();
+    test_borrowed_text();
+    test_borrowed_bytes_text();
+    test_borrowed_type_erased();
+    test_borrowed_batch();
+
+    test_clear();
+
     return boost::report_errors();
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nativepg/request.hpp"
+#include "nativepg/request_template.hpp"
+#include "test_utils/test_range_eq.hpp"
+
+using namespace nativepg;
+using namespace nativepg::test;
+
+namespace {
+
+// Re-rendering a template should be equivalent to creating a request from scratch
+template <class... Params>
+void check_same_as_request(const request_template<Params...>& tmpl, const Params&... values)
+{
+    statement<Params...> stmt{"myname"};
+    request expected;
+    expected.add_execute(stmt.bind(values...));
+
+    BOOST_TEST(test_range_eq(tmpl.get().payload(), expected.payload()));
+    BOOST_TEST(std::ranges::equal(tmpl.get().messages(), expected.messages()));
+}
+
+void test_initial_render()
+{
+    request_template<std::int32_t, std::string_view> tmpl("myname", 42, "value");
+    check_same_as_request<std::int32_t, std::string_view>(tmpl, 42, "value");
+}
+
+// Only fixed-width parameters: patched in place
+void test_fixed_width()
+{
+    request_template<std::int32_t, std::int64_t, std::int16_t> tmpl("myname", 1, 2, 3);
+    const auto* data_before = tmpl.get().payload().data();
+
+    tmpl.set_params(-10, 0x0102030405060708, 300);
+    check_same_as_request<std::int32_t, std::int64_t, std::int16_t>(tmpl, -10, 0x0102030405060708, 300);
+
+    // No reallocation happened
+    BOOST_TEST(tmpl.get().payload().data() == data_before);
+}
+
+// Variable-width parameters change the message length
+void test_variable_width()
+{
+    request_template<std::string_view> tmpl("myname", "abc");
+
+    // Longer
+    tmpl.set_params("a much longer value than before");
+    check_same_as_request<std::string_view>(tmpl, "a much longer value than before");
+
+    // Shorter
+    tmpl.set_params("x");
+    check_same_as_request<std::string_view>(tmpl, "x");
+
+    // Empty
+    tmpl.set_params("");
+    check_same_as_request<std::string_view>(tmpl, "");
+}
+
+// Fixed-width parameters before and after a variable-width one
+void test_mixed()
+{
+    request_template<std::int32_t, std::string_view, std::int64_t, std::string_view> tmpl(
+        "myname",
+        1,
+        "first",
+        2,
+        "second"
+    );
+
+    tmpl.set_params(100, "changed value", 200, "");
+    check_same_as_request<std::int32_t, std::string_view, std::int64_t, std::string_view>(
+        tmpl,
+        100,
+        "changed value",
+        200,
+        ""
+    );
+
+    // Re-rendering several times works
+    tmpl.set_params(-1, "", -2, "last");
+    check_same_as_request<std::int32_t, std::string_view, std::int64_t, std::string_view>(
+        tmpl,
+        -1,
+        "",
+        -2,
+        "last"
+    );
+}
+
+void test_bytea()
+{
+    const std::vector<std::byte> v1{std::byte{1}, std::byte{2}};
+    const std::vector<std::byte> v2{std::byte{3}, std::byte{4}, std::byte{5}};
+    request_template<std::int32_t, std::vector<std::byte>> tmpl("myname", 1, v1);
+
+    tmpl.set_params(2, v2);
+    check_same_as_request<std::int32_t, std::vector<std::byte>>(tmpl, 2, v2);
+}
+
+void test_no_params()
+{
+    request_template<> tmpl("myname");
+    tmpl.set_params();
+    check_same_as_request<>(tmpl);
+}
+
+}  // namespace
+
+int main()
+{
+    test_initial_render();
+    test_fixed_width();
+    test_variable_width();
+    test_mixed();
+    test_bytea();
+    test_no_params();
+
+    return boost::report_errors();
+}
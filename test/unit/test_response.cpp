@@ -9,19 +9,27 @@
 #include <boost/system/error_code.hpp>
 
 #include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
 #include <vector>
 
 #include "nativepg/client_errc.hpp"
+#include "nativepg/command_info.hpp"
 #include "nativepg/extended_error.hpp"
 #include "nativepg/field_view.hpp"
 #include "nativepg/protocol/bind.hpp"
 #include "nativepg/protocol/command_complete.hpp"
 #include "nativepg/protocol/data_row.hpp"
 #include "nativepg/protocol/describe.hpp"
+#include "nativepg/protocol/notice_error.hpp"
 #include "nativepg/protocol/parse.hpp"
 #include "nativepg/request.hpp"
 #include "nativepg/response.hpp"
 #include "nativepg/response_handler.hpp"
+#include "nativepg/sqlstate.hpp"
 #include "test_utils/printing.hpp"
 #include "test_utils/response_msg_type.hpp"
 #include "test_utils/test_range_eq.hpp"
@@ -124,6 +132,237 @@ void test_deduction_guide()
     static_assert(std::is_same_v<decltype(res), response<h1, h1, h1, h2>>);
 }
 
+// check_execute_batch
+request make_batch_request(std::size_t num_rows)
+{
+    statement<std::int32_t> stmt{"myname"};
+    const std::vector<std::tuple<std::int32_t>> rows(num_rows);
+    request req;
+    req.add_execute_batch(stmt, std::span(rows));
+    return req;
+}
+
+protocol::error_response make_error(std::string_view sqlstate)
+{
+    protocol::error_response res;
+    res.sqlstate = sqlstate;
+    return res;
+}
+
+void test_check_execute_batch_setup()
+{
+    check_execute_batch handler;
+
+    // Success
+    BOOST_TEST_EQ(handler.setup(make_batch_request(3u), 0u), handler_setup_result(7u));
+    BOOST_TEST_EQ(handler.setup(make_batch_request(0u), 0u), handler_setup_result(1u));
+
+    // The batch is followed by other messages
+    request req = make_batch_request(1u);
+    req.add_query("SELECT 1", {});
+    BOOST_TEST_EQ(handler.setup(req, 0u), handler_setup_result(3u));
+
+    // Describe messages are not allowed
+    req.clear();
+    req.add_execute("myname", {42});
+    BOOST_TEST_EQ(handler.setup(req, 0u), handler_setup_result(client_errc::incompatible_response_type));
+
+    // Bind without execute
+    req.clear();
+    req.add_bind("myname", {42}).add_sync();
+    BOOST_TEST_EQ(handler.setup(req, 0u), handler_setup_result(client_errc::incompatible_response_type));
+}
+
+void test_check_execute_batch_success()
+{
+    batch_info info;
+    check_execute_batch handler{info};
+    BOOST_TEST_EQ(handler.setup(make_batch_request(3u), 0u), handler_setup_result(7u));
+
+    handler.on_message(protocol::bind_complete{}, 0u);
+    handler.on_message(protocol::command_complete{"INSERT 0 1"}, 1u);
+    handler.on_message(protocol::bind_complete{}, 2u);
+    handler.on_message(protocol::data_row{}, 3u);  // e.g. INSERT ... RETURNING
+    handler.on_message(protocol::data_row{}, 3u);
+    handler.on_message(protocol::command_complete{"INSERT 0 2"}, 3u);
+    handler.on_message(protocol::bind_complete{}, 4u);
+    handler.on_message(protocol::command_complete{"SELECT"}, 5u);  // no affected rows
+
+    BOOST_TEST_EQ(handler.result(), extended_error{});
+    BOOST_TEST_EQ(info.num_executed, 3u);
+    BOOST_TEST_EQ(info.affected_rows, 3u);
+    BOOST_TEST(!info.failed_index.has_value());
+}
+
+void test_check_execute_batch_error()
+{
+    batch_info info;
+    check_execute_batch handler{info};
+    BOOST_TEST_EQ(handler.setup(make_batch_request(4u), 0u), handler_setup_result(9u));
+
+    handler.on_message(protocol::bind_complete{}, 0u);
+    handler.on_message(protocol::command_complete{"UPDATE 5"}, 1u);
+    handler.on_message(protocol::bind_complete{}, 2u);
+    handler.on_message(make_error("23505"), 3u);  // unique violation
+    handler.on_message(message_skipped{}, 4u);
+    handler.on_message(message_skipped{}, 5u);
+    handler.on_message(message_skipped{}, 6u);
+    handler.on_message(message_skipped{}, 7u);
+
+    BOOST_TEST_EQ(handler.result().code, boost::system::error_code(parse_sqlstate("23505")));
+    BOOST_TEST_EQ(info.num_executed, 1u);
+    BOOST_TEST_EQ(info.affected_rows, 5u);
+    BOOST_TEST(info.failed_index == std::optional<std::size_t>(1u));
+
+    // Setting up the handler again resets the state
+    BOOST_TEST_EQ(handler.setup(make_batch_request(1u), 0u), handler_setup_result(3u));
+    BOOST_TEST_EQ(handler.result(), extended_error{});
+    BOOST_TEST(info == batch_info{});
+}
+
+// Errors in bind messages also report the row index
+void test_check_execute_batch_bind_error()
+{
+    batch_info info;
+    check_execute_batch handler{info};
+    BOOST_TEST_EQ(handler.setup(make_batch_request(2u), 0u), handler_setup_result(5u));
+
+    handler.on_message(make_error("22P02"), 0u);  // invalid text representation
+    handler.on_message(message_skipped{}, 1u);
+    handler.on_message(message_skipped{}, 2u);
+    handler.on_message(message_skipped{}, 3u);
+
+    BOOST_TEST_EQ(handler.result().code, boost::system::error_code(parse_sqlstate("22P02")));
+    BOOST_TEST_EQ(info.num_executed, 0u);
+    BOOST_TEST_EQ(info.affected_rows, 0u);
+    BOOST_TEST(info.failed_index == std::optional<std::size_t>(0u));
+}
+
+// check_transaction
+request make_transaction_request()
+{
+    request req;
+    req.add_transaction([](request& r) {
+        r.add_query("UPDATE t SET a = 1", {});
+        r.add_query("SELECT a FROM t", {});
+    });
+    return req;
+}
+
+void test_check_transaction_setup()
+{
+    check_transaction handler;
+
+    // Success
+    BOOST_TEST_EQ(handler.setup(make_transaction_request(), 0u), handler_setup_result(22u));
+
+    // The transaction is followed by other messages
+    request req = make_transaction_request();
+    req.add_query("SELECT 1", {});
+    BOOST_TEST_EQ(handler.setup(req, 0u), handler_setup_result(22u));
+
+    // Not a transaction
+    req.clear();
+    req.add_query("SELECT 1", {});
+    BOOST_TEST_EQ(handler.setup(req, 0u), handler_setup_result(client_errc::incompatible_response_type));
+}
+
+void test_check_transaction_success()
+{
+    transaction_info info;
+    check_transaction handler{info};
+    BOOST_TEST_EQ(handler.setup(make_transaction_request(), 0u), handler_setup_result(22u));
+
+    // BEGIN
+    handler.on_message(protocol::parse_complete{}, 0u);
+    handler.on_message(protocol::bind_complete{}, 1u);
+    handler.on_message(protocol::row_description{}, 2u);
+    handler.on_message(protocol::command_complete{"BEGIN"}, 3u);
+
+    // Statements
+    handler.on_message(protocol::parse_complete{}, 4u);
+    handler.on_message(protocol::bind_complete{}, 5u);
+    handler.on_message(protocol::row_description{}, 6u);
+    handler.on_message(protocol::command_complete{"UPDATE 3"}, 7u);
+    handler.on_message(protocol::parse_complete{}, 8u);
+    handler.on_message(protocol::bind_complete{}, 9u);
+    handler.on_message(protocol::row_description{}, 10u);
+    handler.on_message(protocol::data_row{}, 11u);
+    handler.on_message(protocol::command_complete{"SELECT 1"}, 11u);
+
+    // COMMIT
+    handler.on_message(protocol::parse_complete{}, 12u);
+    handler.on_message(protocol::bind_complete{}, 13u);
+    handler.on_message(protocol::row_description{}, 14u);
+    handler.on_message(protocol::command_complete{"COMMIT"}, 15u);
+
+    // ROLLBACK. The server issues a warning, which is not an error
+    handler.on_message(protocol::parse_complete{}, 17u);
+    handler.on_message(protocol::bind_complete{}, 18u);
+    handler.on_message(protocol::row_description{}, 19u);
+    handler.on_message(protocol::command_complete{"ROLLBACK"}, 20u);
+
+    BOOST_TEST_EQ(handler.result(), extended_error{});
+    BOOST_TEST_EQ(info.num_executed, 2u);
+    BOOST_TEST_EQ(info.affected_rows, 4u);
+    BOOST_TEST(!info.failed_index.has_value());
+    BOOST_TEST(info.committed);
+}
+
+// An error in a statement skips the rest of the statements and COMMIT
+void test_check_transaction_error()
+{
+    transaction_info info;
+    check_transaction handler{info};
+    BOOST_TEST_EQ(handler.setup(make_transaction_request(), 0u), handler_setup_result(22u));
+
+    handler.on_message(protocol::parse_complete{}, 0u);
+    handler.on_message(protocol::bind_complete{}, 1u);
+    handler.on_message(protocol::row_description{}, 2u);
+    handler.on_message(protocol::command_complete{"BEGIN"}, 3u);
+    handler.on_message(protocol::parse_complete{}, 4u);
+    handler.on_message(protocol::bind_complete{}, 5u);
+    handler.on_message(protocol::row_description{}, 6u);
+    handler.on_message(protocol::command_complete{"UPDATE 3"}, 7u);
+    handler.on_message(make_error("40001"), 8u);  // serialization failure
+    for (std::size_t i = 9u; i < 16u; ++i)
+        handler.on_message(message_skipped{}, i);
+    handler.on_message(protocol::parse_complete{}, 17u);
+    handler.on_message(protocol::bind_complete{}, 18u);
+    handler.on_message(protocol::row_description{}, 19u);
+    handler.on_message(protocol::command_complete{"ROLLBACK"}, 20u);
+
+    BOOST_TEST_EQ(handler.result().code, boost::system::error_code(parse_sqlstate("40001")));
+    BOOST_TEST_EQ(info.num_executed, 1u);
+    BOOST_TEST_EQ(info.affected_rows, 3u);
+    BOOST_TEST(info.failed_index == std::optional<std::size_t>(1u));
+    BOOST_TEST(!info.committed);
+
+    // Setting up the handler again resets the state
+    BOOST_TEST_EQ(handler.setup(make_transaction_request(), 0u), handler_setup_result(22u));
+    BOOST_TEST_EQ(handler.result(), extended_error{});
+    BOOST_TEST(info == transaction_info{});
+}
+
+// COMMIT may fail, too (e.g. deferred constraints)
+void test_check_transaction_commit_error()
+{
+    transaction_info info;
+    check_transaction handler{info};
+    BOOST_TEST_EQ(handler.setup(make_transaction_request(), 0u), handler_setup_result(22u));
+
+    handler.on_message(protocol::command_complete{"BEGIN"}, 3u);
+    handler.on_message(protocol::command_complete{"UPDATE 3"}, 7u);
+    handler.on_message(protocol::command_complete{"SELECT 0"}, 11u);
+    handler.on_message(make_error("23503"), 15u);  // foreign key violation
+    handler.on_message(protocol::command_complete{"ROLLBACK"}, 20u);
+
+    BOOST_TEST_EQ(handler.result().code, boost::system::error_code(parse_sqlstate("23503")));
+    BOOST_TEST_EQ(info.num_executed, 2u);
+    BOOST_TEST(!info.failed_index.has_value());
+    BOOST_TEST(!info.committed);
+}
+
 void test_parse_text_time_text_format()
 {
     // Arrange
@@ -190,6 +429,15 @@ int main()
     test_copy();
     test_move();
 
+    test_check_execute_batch_setup();
+    test_check_execute_batch_success();
+    test_check_execute_batch_error();
+    test_check_execute_batch_bind_error();
+    test_check_transaction_setup();
+    test_check_transaction_success();
+    test_check_transaction_error();
+    test_check_transaction_commit_error();
+
     test_parse_text_time_text_format();
     test_parse_text_time_binary_format();
 
@@ -0,0 +1,381 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/variant2/variant.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nativepg/client_errc.hpp"
+#include "nativepg/extended_error.hpp"
+#include "nativepg/notification_event.hpp"
+#include "nativepg/protocol/bind.hpp"
+#include "nativepg/protocol/command_complete.hpp"
+#include "nativepg/protocol/data_row.hpp"
+#include "nativepg/protocol/describe.hpp"
+#include "nativepg/protocol/detail/serialization_context.hpp"
+#include "nativepg/protocol/notice_error.hpp"
+#include "nativepg/protocol/parse.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/response_handler.hpp"
+#include "nativepg/result_cache.hpp"
+#include "test_utils/printing.hpp"
+#include "test_utils/response_msg_type.hpp"
+
+using namespace nativepg;
+using namespace nativepg::test;
+using namespace std::chrono_literals;
+using boost::system::error_code;
+
+namespace {
+
+const auto t0 = result_cache::clock::time_point() + 1h;
+
+struct owning_data_row
+{
+    std::vector<unsigned char> data;
+    protocol::data_row msg;
+
+    owning_data_row(std::initializer_list<std::string_view> values)
+    {
+        protocol::detail::serialization_context ctx(data);
+        ctx.add_integral(static_cast<std::int16_t>(values.size()));
+        for (const auto value : values)
+        {
+            ctx.add_integral(static_cast<std::int32_t>(value.size()));
+            ctx.add_bytes(value);
+        }
+        BOOST_TEST_EQ(protocol::parse(data, msg), error_code());
+    }
+};
+
+struct owning_row_description
+{
+    std::vector<unsigned char> data;
+    protocol::row_description msg;
+
+    explicit owning_row_description(std::string_view name)
+    {
+        protocol::detail::serialization_context ctx(data);
+        ctx.add_integral(static_cast<std::int16_t>(1));
+        ctx.add_string(name);
+        ctx.add_integral(static_cast<std::int32_t>(0));   // table OID
+        ctx.add_integral(static_cast<std::int16_t>(-1));  // column attribute
+        ctx.add_integral(static_cast<std::int32_t>(25));  // type OID (text)
+        ctx.add_integral(static_cast<std::int16_t>(-1));  // type length
+        ctx.add_integral(static_cast<std::int32_t>(-1));  // type modifier
+        ctx.add_integral(static_cast<std::int16_t>(0));   // format code
+        BOOST_TEST_EQ(protocol::parse(data, msg), error_code());
+    }
+};
+
+// Records what it receives, flattening values
+struct mock_handler
+{
+    struct received
+    {
+        response_msg_type type;
+        std::size_t offset;
+        std::string value;  // column name, row values or command tag
+
+        bool operator==(const received&) const = default;
+    };
+
+    std::vector<received> msgs;
+    std::size_t num_row_batches{};
+    extended_error err;
+
+    handler_setup_result setup(const request& req, std::size_t offset)
+    {
+        return offset + req.messages().size();
+    }
+
+    void on_message(const any_request_message& msg, std::size_t offset)
+    {
+        std::string value;
+        if (const auto* row = boost::variant2::get_if<protocol::data_row>(&msg))
+        {
+            for (auto field : row->columns)
+                value += std::string(field.data_str()) + ";";
+        }
+        else if (const auto* descr = boost::variant2::get_if<protocol::row_description>(&msg))
+        {
+            for (auto field : descr->field_descriptions)
+                value += std::string(field.name) + ";";
+        }
+        else if (const auto* cc = boost::variant2::get_if<protocol::command_complete>(&msg))
+        {
+            value = cc->tag;
+        }
+        msgs.push_back({to_type(msg), offset, std::move(value)});
+    }
+
+    void on_rows(std::span<const protocol::data_row> rows, std::size_t offset)
+    {
+        ++num_row_batches;
+        for (const auto& row : rows)
+            on_message(row, offset);
+    }
+
+    const extended_error& result() const { return err; }
+};
+
+request make_request(int id)
+{
+    request req;
+    req.add_query("SELECT name FROM countries WHERE id = $1", {id});
+    return req;
+}
+
+// Simulates a response to make_request with the given names,
+// as delivered by the connection
+template <class Handler>
+void deliver_response(Handler& handler, std::initializer_list<std::string_view> names)
+{
+    owning_row_description descr("name");
+    std::vector<owning_data_row> rows;
+    for (auto name : names)
+        rows.push_back(owning_data_row({name}));
+    std::vector<protocol::data_row> row_views;
+    for (const auto& row : rows)
+        row_views.push_back(row.msg);
+
+    handler.on_message(protocol::parse_complete{}, 0u);
+    handler.on_message(protocol::bind_complete{}, 1u);
+    handler.on_message(descr.msg, 2u);
+    handler.on_rows(row_views, 3u);
+    handler.on_message(protocol::command_complete{"SELECT 2"}, 3u);
+}
+
+// Executes a request through the cache, simulating a server response on a miss
+void exec_and_store(
+    result_cache& cache,
+    const request& req,
+    std::initializer_list<std::string_view> names,
+    const cache_options& opts = {},
+    result_cache::clock::time_point now = t0
+)
+{
+    mock_handler handler;
+    auto recorder = cache.make_recorder(&handler);
+    BOOST_TEST_EQ(recorder.setup(req, 0u), handler_setup_result(req.messages().size()));
+    deliver_response(recorder, names);
+    cache.store(req, recorder, opts, now);
+}
+
+// Whether the cache holds a response for req, consuming it
+bool is_cached(result_cache& cache, const request& req, result_cache::clock::time_point now = t0)
+{
+    mock_handler handler;
+    return cache.replay(req, &handler, now).has_value();
+}
+
+// Hits deliver the same messages as the original response
+void test_hit()
+{
+    result_cache cache;
+    const auto req = make_request(1);
+
+    // Miss
+    mock_handler handler;
+    BOOST_TEST(!cache.replay(req, &handler, t0).has_value());
+    BOOST_TEST(handler.msgs.empty());
+
+    // Record the response. The handler gets the messages, too
+    auto recorder = cache.make_recorder(&handler);
+    recorder.setup(req, 0u);
+    deliver_response(recorder, {"Spain", "France"});
+    BOOST_TEST_EQ(handler.msgs.size(), 6u);
+    cache.store(req, recorder, {}, t0);
+    BOOST_TEST_EQ(cache.size(), 1u);
+
+    // Hit
+    mock_handler hit_handler;
+    auto res = cache.replay(req, &hit_handler, t0 + 1s);
+    BOOST_TEST(res.has_value());
+    BOOST_TEST_EQ(res.value_or(error_code()), error_code());
+
+    mock_handler expected;
+    deliver_response(expected, {"Spain", "France"});
+    BOOST_TEST(hit_handler.msgs == expected.msgs);
+
+    // Rows are delivered in a single batch
+    BOOST_TEST_EQ(hit_handler.num_row_batches, 1u);
+
+    BOOST_TEST_EQ(cache.stats().hits, 1u);
+    BOOST_TEST_EQ(cache.stats().misses, 1u);
+}
+
+// Parameters are part of the key
+void test_key_includes_params()
+{
+    result_cache cache;
+    exec_and_store(cache, make_request(1), {"Spain"});
+    BOOST_TEST(is_cached(cache, make_request(1)));
+    BOOST_TEST(!is_cached(cache, make_request(2)));
+}
+
+void test_ttl()
+{
+    result_cache_params params;
+    params.default_ttl = 10s;
+    result_cache cache(params);
+
+    // Default TTL
+    exec_and_store(cache, make_request(1), {"Spain"});
+    BOOST_TEST(is_cached(cache, make_request(1), t0 + 9s));
+    BOOST_TEST(!is_cached(cache, make_request(1), t0 + 10s));
+
+    // Expired entries are removed on lookup
+    BOOST_TEST_EQ(cache.size(), 0u);
+
+    // Per-entry TTL
+    exec_and_store(cache, make_request(1), {"Spain"}, {.ttl = 20s});
+    BOOST_TEST(is_cached(cache, make_request(1), t0 + 19s));
+    BOOST_TEST(!is_cached(cache, make_request(1), t0 + 20s));
+}
+
+// Responses with errors are not cached
+void test_errors_not_cached()
+{
+    result_cache cache;
+    const auto req = make_request(1);
+
+    // Error message
+    mock_handler handler;
+    auto recorder = cache.make_recorder(&handler);
+    recorder.setup(req, 0u);
+    recorder.on_message(protocol::parse_complete{}, 0u);
+    recorder.on_message(protocol::error_response{}, 1u);
+    recorder.on_message(message_skipped{}, 2u);
+    recorder.on_message(message_skipped{}, 3u);
+    cache.store(req, recorder, {}, t0);
+    BOOST_TEST_EQ(cache.size(), 0u);
+
+    // The handler reported an error (e.g. a type mismatch when parsing rows)
+    mock_handler handler2;
+    handler2.err.code = client_errc::incompatible_field_type;
+    auto recorder2 = cache.make_recorder(&handler2);
+    recorder2.setup(req, 0u);
+    deliver_response(recorder2, {"Spain"});
+    cache.store(req, recorder2, {}, t0);
+    BOOST_TEST_EQ(cache.size(), 0u);
+}
+
+// Least recently used entries are evicted to honor the memory budget
+void test_lru_eviction()
+{
+    // Measure the size of an entry
+    result_cache measure;
+    exec_and_store(measure, make_request(1), {"Spain"});
+    const auto entry_size = measure.memory_usage();
+
+    result_cache_params params;
+    params.max_bytes = entry_size * 2u;
+    result_cache cache(params);
+    exec_and_store(cache, make_request(1), {"Spain"});
+    exec_and_store(cache, make_request(2), {"Italy"});
+
+    // Using 1 makes 2 the least recently used
+    BOOST_TEST(is_cached(cache, make_request(1)));
+    exec_and_store(cache, make_request(3), {"Malta"});
+    BOOST_TEST_EQ(cache.size(), 2u);
+    BOOST_TEST(is_cached(cache, make_request(1)));
+    BOOST_TEST(!is_cached(cache, make_request(2)));
+    BOOST_TEST(is_cached(cache, make_request(3)));
+    BOOST_TEST_EQ(cache.stats().evictions, 1u);
+    BOOST_TEST(cache.memory_usage() <= params.max_bytes);
+
+    // Entries bigger than the budget are not stored
+    exec_and_store(cache, make_request(4), {std::string(entry_size * 2u, 'a')});
+    BOOST_TEST(!is_cached(cache, make_request(4)));
+    BOOST_TEST_EQ(cache.size(), 2u);
+}
+
+void test_invalidate()
+{
+    result_cache cache;
+    constexpr std::string_view countries_tags[] = {"countries"};
+    constexpr std::string_view cities_tags[] = {"cities", "countries"};
+    exec_and_store(cache, make_request(1), {"Spain"}, {.tags = countries_tags});
+    exec_and_store(cache, make_request(2), {"Madrid"}, {.tags = cities_tags});
+    exec_and_store(cache, make_request(3), {"Other"});
+
+    BOOST_TEST_EQ(cache.invalidate("cities"), 1u);
+    BOOST_TEST(!is_cached(cache, make_request(2)));
+    BOOST_TEST_EQ(cache.invalidate("countries"), 1u);
+    BOOST_TEST(!is_cached(cache, make_request(1)));
+    BOOST_TEST(is_cached(cache, make_request(3)));
+    BOOST_TEST_EQ(cache.stats().invalidations, 2u);
+}
+
+// Responses to requests issued before an invalidation may be stale, and are not stored
+void test_invalidate_in_flight()
+{
+    result_cache cache;
+    const auto req = make_request(1);
+    mock_handler handler;
+    auto recorder = cache.make_recorder(&handler);
+    recorder.setup(req, 0u);
+    deliver_response(recorder, {"Spain"});
+
+    cache.invalidate("countries");
+    cache.store(req, recorder, {}, t0);
+    BOOST_TEST_EQ(cache.size(), 0u);
+}
+
+void test_notifications()
+{
+    constexpr std::string_view tags[] = {"countries"};
+    result_cache cache;
+    exec_and_store(cache, make_request(1), {"Spain"}, {.tags = tags});
+    exec_and_store(cache, make_request(2), {"Madrid"});
+
+    // Other channels are ignored
+    cache.on_notification({notification_event_type::notify, 0, "other", "countries"});
+    BOOST_TEST_EQ(cache.size(), 2u);
+
+    // The payload is the tag
+    cache.on_notification({notification_event_type::notify, 0, "nativepg_cache_invalidation", "countries"});
+    BOOST_TEST_EQ(cache.size(), 1u);
+
+    // An empty payload invalidates everything
+    cache.on_notification({notification_event_type::notify, 0, "nativepg_cache_invalidation", ""});
+    BOOST_TEST_EQ(cache.size(), 0u);
+
+    // Reconnections invalidate everything, since notifications may have been lost
+    exec_and_store(cache, make_request(1), {"Spain"});
+    cache.on_notification({notification_event_type::disconnect});
+    BOOST_TEST_EQ(cache.size(), 1u);
+    cache.on_notification({notification_event_type::connect});
+    BOOST_TEST_EQ(cache.size(), 0u);
+}
+
+}  // namespace
+
+int main()
+{
+    test_hit();
+    test_key_includes_params();
+    test_ttl();
+    test_errors_not_cached();
+    test_lru_eviction();
+    test_invalidate();
+    test_invalidate_in_flight();
+    test_notifications();
+
+    return boost::report_errors();
+}
@@ -216,6 +216,74 @@ void test_query()
     BOOST_TEST_ALL_EQ(users.begin(), users.end(), expected_rows.begin(), expected_rows.end());
 }
 
+// Rows can be delivered in batches
+void test_rows_batch()
+{
+    // Test setup
+    std::vector<user> users;
+    auto cb = into(users);
+    static_assert(row_batch_handler<decltype(cb)>);
+    owning_row_description descrs({
+        make_field_descr("id", 23, format_code::text),
+        make_field_descr("name", 25, format_code::text),
+    });
+    owning_data_row row1({"42", "perico"}), row2({"50", "pepe"}), row3({"60", "juan"});
+    request req;
+    req.add_query("SELECT $1", {42});
+
+    // Handler setup
+    BOOST_TEST_EQ(cb.setup(req, 0u), handler_setup_result(5u));
+
+    // Messages
+    const protocol::data_row batch1[] = {row1, row2};
+    const protocol::data_row batch2[] = {row3};
+    cb.on_message(protocol::parse_complete{}, 0u);
+    cb.on_message(protocol::bind_complete{}, 1u);
+    cb.on_message(descrs, 2u);
+    cb.on_rows(batch1, 3u);
+    cb.on_rows(batch2, 3u);
+    cb.on_message(protocol::command_complete{}, 3u);
+
+    // Check result
+    BOOST_TEST_EQ(cb.result(), extended_error{});
+
+    // Rows
+    std::vector<user> expected_rows{
+        {42, "perico"},
+        {50, "pepe"  },
+        {60, "juan"  },
+    };
+    BOOST_TEST_ALL_EQ(users.begin(), users.end(), expected_rows.begin(), expected_rows.end());
+}
+
+// An error parsing a row in a batch skips the rest of the rows
+void test_rows_batch_error()
+{
+    // Test setup
+    std::vector<user> users;
+    auto cb = into(users);
+    owning_row_description descrs({
+        make_field_descr("id", 23, format_code::text),
+        make_field_descr("name", 25, format_code::text),
+    });
+    owning_data_row row1({"42", "perico"}), row2({"bad", "pepe"}), row3({"60", "juan"});
+    request req;
+    req.add_simple_query("SELECT 1");
+
+    // Handler setup
+    BOOST_TEST_EQ(cb.setup(req, 0u), handler_setup_result(1u));
+
+    // Messages
+    const protocol::data_row batch[] = {row1, row2, row3};
+    cb.on_message(descrs, 0u);
+    cb.on_rows(batch, 0u);
+    cb.on_message(protocol::command_complete{}, 0u);
+
+    // Check result
+    BOOST_TEST_NE(cb.result().code, error_code());
+    BOOST_TEST_EQ(users.size(), 1u);
+}
+
 // Having excess fields or out of order fields work
 void test_field_match_by_name()
 {
@@ -628,6 +696,8 @@ int main()
 {
     test_simple_query();
     test_query();
+    test_rows_batch();
+    test_rows_batch_error();
     test_field_match_by_name();
     test_binary();
     test_type_conversions();
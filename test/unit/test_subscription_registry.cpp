@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2025 Ruben Perez Hidalgo (rubenperez038 at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nativepg/notification_event.hpp"
+#include "nativepg/request.hpp"
+#include "nativepg/subscription_registry.hpp"
+#include "test_utils/test_range_eq.hpp"
+
+using namespace nativepg;
+using namespace nativepg::test;
+
+namespace {
+
+notification_view make_notify(std::string_view channel, std::string_view payload = "payload")
+{
+    return {notification_event_type::notify, 42, channel, payload};
+}
+
+// Checks that prepare_sync generates the given queries. Order between channels is unspecified
+void check_sync(subscription_registry& reg, std::initializer_list<std::string_view> expected_queries)
+{
+    request actual;
+    const bool added = reg.prepare_sync(actual);
+    BOOST_TEST_EQ(added, expected_queries.size() != 0u);
+    BOOST_TEST_EQ(actual.messages().size(), expected_queries.size());
+
+    for (auto q : expected_queries)
+    {
+        request expected;
+        expected.add_simple_query(q);
+        const auto& expected_payload = expected.payload();
+        const auto& actual_payload = actual.payload();
+        auto it = std::search(
+            actual_payload.begin(),
+            actual_payload.end(),
+            expected_payload.begin(),
+            expected_payload.end()
+        );
+        BOOST_TEST(it != actual_payload.end());
+    }
+}
+
+void test_subscribe_dispatch()
+{
+    subscription_registry reg;
+    std::vector<std::string> received1, received2, received3;
+    reg.subscribe("chan1", [&](const notification_view& evt) { received1.emplace_back(evt.payload); });
+    reg.subscribe("chan1", [&](const notification_view& evt) { received2.emplace_back(evt.payload); });
+    reg.subscribe("chan2", [&](const notification_view& evt) { received3.emplace_back(evt.payload); });
+    BOOST_TEST_EQ(reg.num_channels(), 2u);
+
+    // A single LISTEN per channel
+    BOOST_TEST(reg.needs_sync());
+    check_sync(reg, {"LISTEN \"chan1\"", "LISTEN \"chan2\""});
+    reg.on_sync_finished(true);
+    BOOST_TEST_NOT(reg.needs_sync());
+
+    // Dispatch
+    BOOST_TEST_EQ(reg.dispatch(make_notify("chan1", "a")), 2u);
+    BOOST_TEST_EQ(reg.dispatch(make_notify("chan2", "b")), 1u);
+    BOOST_TEST_EQ(reg.dispatch(make_notify("other", "c")), 0u);
+    BOOST_TEST_EQ(reg.dispatch({notification_event_type::connect}), 0u);
+    BOOST_TEST(received1 == std::vector<std::string>{"a"});
+    BOOST_TEST(received2 == std::vector<std::string>{"a"});
+    BOOST_TEST(received3 == std::vector<std::string>{"b"});
+}
+
+void test_unsubscribe()
+{
+    subscription_registry reg;
+    int count = 0;
+    auto id1 = reg.subscribe("chan", [&](const notification_view&) { ++count; });
+    auto id2 = reg.subscribe("chan", [&](const notification_view&) { ++count; });
+    check_sync(reg, {"LISTEN \"chan\""});
+    reg.on_sync_finished(true);
+
+    // Removing one subscriber doesn't require UNLISTEN
+    reg.unsubscribe(id1);
+    BOOST_TEST_NOT(reg.needs_sync());
+    BOOST_TEST_EQ(reg.dispatch(make_notify("chan")), 1u);
+
+    // Removing the last one does
+    reg.unsubscribe(id2);
+    BOOST_TEST(reg.needs_sync());
+    check_sync(reg, {"UNLISTEN \"chan\""});
+    reg.on_sync_finished(true);
+    BOOST_TEST_EQ(reg.num_channels(), 0u);
+    BOOST_TEST_EQ(reg.dispatch(make_notify("chan")), 0u);
+    BOOST_TEST_EQ(count, 1);
+
+    // Unknown IDs are ignored
+    reg.unsubscribe(id2);
+    BOOST_TEST_NOT(reg.needs_sync());
+}
+
+// Subscribing and unsubscribing before syncing cancel each other
+void test_subscribe_unsubscribe_before_sync()
+{
+    subscription_registry reg;
+    auto id = reg.subscribe("chan", [](const notification_view&) {});
+    reg.unsubscribe(id);
+    BOOST_TEST_NOT(reg.needs_sync());
+    check_sync(reg, {});
+}
+
+// Reconnections require listening again to all channels
+void test_reconnect()
+{
+    subscription_registry reg;
+    reg.subscribe("chan1", [](const notification_view&) {});
+    reg.subscribe("chan2", [](const notification_view&) {});
+    check_sync(reg, {"LISTEN \"chan1\"", "LISTEN \"chan2\""});
+    reg.on_sync_finished(true);
+
+    reg.on_connect();
+    BOOST_TEST(reg.needs_sync());
+    check_sync(reg, {"LISTEN \"chan1\"", "LISTEN \"chan2\""});
+    reg.on_sync_finished(true);
+    BOOST_TEST_NOT(reg.needs_sync());
+}
+
+// If a sync fails, the server state is unknown, and everything is sent again
+void test_sync_error()
+{
+    subscription_registry reg;
+    reg.subscribe("chan1", [](const notification_view&) {});
+    auto id = reg.subscribe("chan2", [](const notification_view&) {});
+    check_sync(reg, {"LISTEN \"chan1\"", "LISTEN \"chan2\""});
+    reg.on_sync_finished(true);
+
+    reg.unsubscribe(id);
+    check_sync(reg, {"UNLISTEN \"chan2\""});
+    reg.on_sync_finished(false);
+
+    BOOST_TEST(reg.needs_sync());
+    check_sync(reg, {"LISTEN \"chan1\""});
+    reg.on_sync_finished(true);
+    BOOST_TEST_NOT(reg.needs_sync());
+}
+
+// Channel names are quoted
+void test_quoting()
+{
+    subscription_registry reg;
+    reg.subscribe("My \"Channel\"", [](const notification_view&) {});
+    check_sync(reg, {"LISTEN \"My \"\"Channel\"\"\""});
+}
+
+// Handlers may subscribe and unsubscribe while being invoked
+void test_modify_from_handler()
+{
+    subscription_registry reg;
+    int count1 = 0, count2 = 0, count3 = 0;
+    subscription_id id1;
+    id1 = reg.subscribe("chan", [&](const notification_view&) {
+        ++count1;
+        reg.unsubscribe(id1);
+        reg.subscribe("chan", [&](const notification_view&) { ++count2; });
+        reg.subscribe("other", [&](const notification_view&) { ++count3; });
+    });
+    check_sync(reg, {"LISTEN \"chan\""});
+    reg.on_sync_finished(true);
+
+    // Subscribers added while dispatching are not invoked
+    BOOST_TEST_EQ(reg.dispatch(make_notify("chan")), 1u);
+    BOOST_TEST_EQ(count1, 1);
+    BOOST_TEST_EQ(count2, 0);
+    BOOST_TEST(reg.needs_sync());
+    check_sync(reg, {"LISTEN \"other\""});
+
+    // The first handler was removed
+    BOOST_TEST_EQ(reg.dispatch(make_notify("chan")), 1u);
+    BOOST_TEST_EQ(count1, 1);
+    BOOST_TEST_EQ(count2, 1);
+    BOOST_TEST_EQ(count3, 0);
+}
+
+// Unsubscribing from another channel while dispatching doesn't leave stale subscribers behind
+void test_unsubscribe_other_channel_from_handler()
+{
+    subscription_registry reg;
+    auto state = std::make_shared<int>(0);
+    const auto other_id = reg.subscribe("other", [state](const notification_view&) { ++*state; });
+    reg.subscribe("chan", [&](const notification_view&) { reg.unsubscribe(other_id); });
+    check_sync(reg, {"LISTEN \"chan\"", "LISTEN \"other\""});
+    reg.on_sync_finished(true);
+
+    // The handler is destroyed once dispatching finishes
+    BOOST_TEST_EQ(reg.dispatch(make_notify("chan")), 1u);
+    BOOST_TEST_EQ(state.use_count(), 1);
+    BOOST_TEST_EQ(reg.dispatch(make_notify("other")), 0u);
+    BOOST_TEST_EQ(*state, 0);
+    check_sync(reg, {"UNLISTEN \"other\""});
+}
+
+}  // namespace
+
+int main()
+{
+    test_subscribe_dispatch();
+    test_unsubscribe();
+    test_subscribe_unsubscribe_before_sync();
+    test_reconnect();
+    test_sync_error();
+    test_quoting();
+    test_modify_from_handler();
+    test_unsubscribe_other_channel_from_handler();
+
+    return boost::report_errors();
+}
@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <format>
 #include <iomanip>
+#include <iterator>
 #include <limits>
 #include <span>
 #include <sstream>
@@ -178,6 +179,47 @@ void test_parse_text_bytea_success()
     BOOST_TEST_EQ(ss.str(), "0x21061977");
 }
 
+void test_parse_text_bytea_long_success()
+{
+    // Arrange. Long enough to go through the vectorized paths, with upper and lower case digits
+    std::vector<std::byte> ba{std::byte{0xaa}};  // Existing contents are replaced
+    std::string str = "\\x";
+    for (int i = 0; i < 100; ++i)
+        str += (i % 2 == 0) ? "0aBf" : "c9D1";
+    boost::span<const unsigned char> data(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+    field_view fv{data};
+
+    // Act
+    auto err = types::parse_text_bytea(fv, ba);
+
+    // Assert
+    BOOST_TEST_EQ(err, boost::system::errc::success);
+    BOOST_TEST_EQ(ba.size(), 200u);
+    for (std::size_t i = 0; i < ba.size(); i += 4)
+    {
+        BOOST_TEST(ba[i] == std::byte{0x0a});
+        BOOST_TEST(ba[i + 1] == std::byte{0xbf});
+        BOOST_TEST(ba[i + 2] == std::byte{0xc9});
+        BOOST_TEST(ba[i + 3] == std::byte{0xd1});
+    }
+}
+
+void test_parse_text_bytea_empty_success()
+{
+    // Arrange
+    std::vector<std::byte> ba{std::byte{0xaa}};
+    std::string str = "\\x";
+    boost::span<const unsigned char> data(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+    field_view fv{data};
+
+    // Act
+    auto err = types::parse_text_bytea(fv, ba);
+
+    // Assert
+    BOOST_TEST_EQ(err, boost::system::errc::success);
+    BOOST_TEST_EQ(ba.size(), 0u);
+}
+
 void test_parse_binary_bytea_success()
 {
     // Arrange
@@ -242,6 +284,21 @@ void test_parse_text_bytea_invalid_hex_error()
     BOOST_TEST_EQ(err, error_code(client_errc::protocol_value_error));
 }
 
+void test_parse_text_bytea_invalid_hex_long_error()
+{
+    // Arrange
+    std::vector<std::byte> ba;
+    std::string str = "\\x" + std::string(100, 'a') + "0g" + std::string(100, 'b');
+    boost::span<const unsigned char> data(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+    field_view fv{data};
+
+    // Act
+    auto err = types::parse_text_bytea(fv, ba);
+
+    // Assert
+    BOOST_TEST_EQ(err, error_code(client_errc::protocol_value_error));
+}
+
 // "CHAR" (internal single-byte char)
 void test_parse_text_char_success()
 {
@@ -436,6 +493,67 @@ void test_parse_text_int_overflow_error()
     BOOST_TEST_EQ(err, error_code(client_errc::protocol_value_error));
 }
 
+// Batched INT
+template <std::size_t N>
+std::vector<field_view> make_text_fields(const std::string (&strs)[N])
+{
+    std::vector<field_view> res;
+    for (const auto& str : strs)
+        res.emplace_back(std::span(reinterpret_cast<const unsigned char*>(str.data()), str.size()));
+    return res;
+}
+
+template <typename T>
+void test_parse_text_int_batch_success()
+{
+    // Arrange
+    const std::string strs[] = {"0", "-1", "12345", std::to_string(std::numeric_limits<T>::max()), "42"};
+    const auto fields = make_text_fields(strs);
+    std::vector<T> out_vals(fields.size());
+
+    // Act
+    auto err = types::parse_text_int_batch(fields, std::span<T>(out_vals));
+
+    // Assert
+    BOOST_TEST_EQ(err, boost::system::errc::success);
+    const T expected[] = {0, -1, 12345, std::numeric_limits<T>::max(), 42};
+    BOOST_TEST_ALL_EQ(out_vals.begin(), out_vals.end(), std::begin(expected), std::end(expected));
+}
+
+void test_parse_text_int_batch_error()
+{
+    // Arrange
+    const std::string strs[] = {"1", "2", "not_a_number", "4"};
+    const auto fields = make_text_fields(strs);
+    std::vector<std::int32_t> out_vals(fields.size(), -1);
+
+    // Act
+    auto err = types::parse_text_int_batch(fields, std::span<std::int32_t>(out_vals));
+
+    // Assert. Values preceding the offending one have been written
+    BOOST_TEST_EQ(err, error_code(client_errc::protocol_value_error));
+    BOOST_TEST_EQ(out_vals[0], 1);
+    BOOST_TEST_EQ(out_vals[1], 2);
+}
+
+void test_parse_text_int_batch_null_error()
+{
+    // Arrange
+    const std::string str = "10";
+    const field_view fields[] = {
+        field_view(std::span(reinterpret_cast<const unsigned char*>(str.data()), str.size())),
+        field_view(),
+    };
+    std::vector<std::int64_t> out_vals(2);
+
+    // Act
+    auto err = types::parse_text_int_batch(fields, std::span<std::int64_t>(out_vals));
+
+    // Assert
+    BOOST_TEST_EQ(err, error_code(client_errc::unexpected_null));
+    BOOST_TEST_EQ(out_vals[0], 10);
+}
+
 template <typename T>
 void test_parse_binary_int_wrong_size_error()
 {
@@ -561,6 +679,47 @@ void test_parse_text_float_garbage_error()
     BOOST_TEST_EQ(err, error_code(client_errc::protocol_value_error));
 }
 
+// Batched FLOAT
+template <typename T>
+void test_parse_text_float_batch_success()
+{
+    // Arrange
+    const std::string strs[] = {"0", "-2.5", "3.14", "1e-30", "Infinity", "-Infinity"};
+    const auto fields = make_text_fields(strs);
+    std::vector<T> out_vals(fields.size());
+
+    // Act
+    auto err = types::parse_text_float_batch(fields, std::span<T>(out_vals));
+
+    // Assert
+    BOOST_TEST_EQ(err, boost::system::errc::success);
+    const T expected[] = {
+        T(0),
+        T(-2.5),
+        static_cast<T>(3.14L),
+        static_cast<T>(1e-30L),
+        std::numeric_limits<T>::infinity(),
+        -std::numeric_limits<T>::infinity(),
+    };
+    BOOST_TEST_ALL_EQ(out_vals.begin(), out_vals.end(), std::begin(expected), std::end(expected));
+}
+
+template <typename T>
+void test_parse_text_float_batch_error()
+{
+    // Arrange
+    const std::string strs[] = {"1.5", "1.5.5"};
+    const auto fields = make_text_fields(strs);
+    std::vector<T> out_vals(fields.size());
+
+    // Act
+    auto err = types::parse_text_float_batch(fields, std::span<T>(out_vals));
+
+    // Assert
+    BOOST_TEST_EQ(err, error_code(client_errc::protocol_value_error));
+    BOOST_TEST_EQ(out_vals[0], T(1.5));
+}
+
 template <typename T>
 void test_parse_binary_float_wrong_size_error()
 {
@@ -846,10 +1005,13 @@ int main()
 
     // BYTEA
     test_parse_text_bytea_success();
+    test_parse_text_bytea_long_success();
+    test_parse_text_bytea_empty_success();
     test_parse_binary_bytea_success();
     test_parse_text_bytea_missing_prefix_error();
     test_parse_text_bytea_odd_length_error();
     test_parse_text_bytea_invalid_hex_error();
+    test_parse_text_bytea_invalid_hex_long_error();
 
     // CHAR
     test_parse_text_char_success();
@@ -884,6 +1046,11 @@ int main()
     test_parse_text_int_garbage_error<std::int64_t>();
     test_parse_text_int_overflow_error<std::int16_t>();
     test_parse_text_int_overflow_error<std::int32_t>();
+    test_parse_text_int_batch_success<std::int16_t>();
+    test_parse_text_int_batch_success<std::int32_t>();
+    test_parse_text_int_batch_success<std::int64_t>();
+    test_parse_text_int_batch_error();
+    test_parse_text_int_batch_null_error();
     test_parse_binary_int_wrong_size_error<std::int16_t>();
     test_parse_binary_int_wrong_size_error<std::int32_t>();
     test_parse_binary_int_wrong_size_error<std::int64_t>();
@@ -931,6 +1098,10 @@ int main()
     // Invalid FLOAT paths
     test_parse_text_float_garbage_error<float>();
     test_parse_text_float_garbage_error<double>();
+    test_parse_text_float_batch_success<float>();
+    test_parse_text_float_batch_success<double>();
+    test_parse_text_float_batch_error<float>();
+    test_parse_text_float_batch_error<double>();
     test_parse_binary_float_wrong_size_error<float>();
     test_parse_binary_float_wrong_size_error<double>();
 